@@ -18,6 +18,8 @@ class Ball : public MatchEntity {
 		const Player* getGrabber() const;
 		const Player* checkPlayerCollisions();
 	private:
+		friend class MatchSnapshot;
+
 		bool checkCollision(const Player& p);
 		Common::Vector3 mCollisionFreePoint;
 		bool mGrabbed;
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <algorithm>
 
+#include "soccer/Log.h"
+
 #include "match/Clock.h"
 
 Clock::Clock()
@@ -28,7 +30,7 @@ double Clock::limitFPS(int fps)
 	}
 	mFrames++;
 	if(newtime - mStatTime >= 2.0f) {
-		std::cout << "FPS: " << mFrames / (newtime - mStatTime) << "\n";
+		LOG_DEBUG(Performance, "FPS: %3.2f\n", mFrames / (newtime - mStatTime));
 		mStatTime = newtime;
 		mFrames = 0;
 	}
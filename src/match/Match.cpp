@@ -3,11 +3,14 @@
 
 #include "common/Vector3.h"
 
+#include "soccer/Log.h"
+
 #include "match/Match.h"
 #include "match/Team.h"
 #include "match/MatchHelpers.h"
 #include "match/PlayerActions.h"
 #include "match/RefereeActions.h"
+#include "match/MatchSnapshot.h"
 
 #define TACKLE_DISTANCE 1.0f
 #define PLAYER_RADIUS 0.6f
@@ -27,7 +30,9 @@ Match::Match(const Soccer::Match& m, double matchtime, bool extratime, bool pena
 	mPenalties(penalties),
 	mAwayGoals(awaygoals),
 	mHomeAgg(homeagg),
-	mAwayAgg(awayagg)
+	mAwayAgg(awayagg),
+	mTick(0),
+	mStatistics(this)
 {
 	static const unsigned int numPlayers = 11;
 	assert(matchtime);
@@ -102,6 +107,7 @@ const Referee* Match::getReferee() const
 
 void Match::update(double time)
 {
+	mTick++;
 	mBall->update(time);
 
 	for(int i = 0; i < 2; i++) {
@@ -124,7 +130,9 @@ void Match::update(double time)
 				if(p2->tackling() && p->standing() && !p->isAirborne()) {
 					float dist = MatchEntity::distanceBetween(*p, *p2);
 					if(dist < TACKLE_DISTANCE) {
-						std::cout << "Tackled player\n";
+						LOG_DEBUG(Match, "Tackled player\n");
+						addEvent(MatchEventType::Tackle, p.get(), 0, p2.get());
+						mStatistics.playerTackled(*p2);
 						p->setTackled();
 						mReferee.playerTackled(*p, *p2);
 					}
@@ -137,6 +145,7 @@ void Match::update(double time)
 
 	const Player* collided = mBall->checkPlayerCollisions();
 	if(collided && mReferee.canKickBall(*collided)) {
+		mStatistics.ballTouched(*collided);
 		mReferee.ballKicked(*collided);
 	}
 
@@ -148,6 +157,9 @@ void Match::update(double time)
 
 	updateReferee(time);
 	updateTime(time);
+	mStatistics.update(time);
+	if(mReplayRecorder)
+		mReplayRecorder->record(*this, time);
 }
 
 void Match::checkPlayerPlayerCollision(boost::shared_ptr<Player> p, boost::shared_ptr<Player> p2)
@@ -170,8 +182,9 @@ void Match::setMatchHalf(MatchHalf h)
 	if(h == mMatchHalf)
 		return;
 
-	std::cout << "Match half is now " << h << "\n";
+	LOG_INFO(Match, "Match half is now %s\n", matchHalfToString(h));
 	mMatchHalf = h;
+	addEvent(MatchEventType::MatchHalfChange, nullptr, (int)h);
 	mPlayState = PlayState::OutKickoff;
 	for(int i = 0; i < 2; i++)
 		mTeams[i]->matchHalfChanged(mMatchHalf);
@@ -186,8 +199,11 @@ void Match::setMatchHalf(MatchHalf h)
 
 void Match::setPlayState(PlayState h)
 {
-	std::cout << "Play state is now " << h << "\n";
+	LOG_DEBUG(Match, "Play state is now %s\n", playStateToString(h));
+	if(h != mPlayState)
+		mStatistics.playStateChanged(h, mReferee.isFirstTeamInControl());
 	mPlayState = h;
+	addEvent(MatchEventType::PlayStateChange, nullptr, (int)h);
 }
 
 PlayState Match::getPlayState() const
@@ -231,7 +247,7 @@ float Match::getPitchHeight() const
 	return mPitch.getHeight();
 }
 
-std::ostream& operator<<(std::ostream& out, const MatchHalf& m)
+const char* matchHalfToString(MatchHalf m)
 {
 	const char* str = "";
 	switch(m) {
@@ -258,7 +274,12 @@ std::ostream& operator<<(std::ostream& out, const MatchHalf& m)
 		case MatchHalf::Finished:
 			str = "Finished"; break;
 	}
-	out << str;
+	return str;
+}
+
+std::ostream& operator<<(std::ostream& out, const MatchHalf& m)
+{
+	out << matchHalfToString(m);
 	return out;
 }
 
@@ -269,7 +290,7 @@ bool playing(MatchHalf h)
 		h == MatchHalf::PenaltyShootout;
 }
 
-std::ostream& operator<<(std::ostream& out, const PlayState& m)
+const char* playStateToString(PlayState m)
 {
 	const char* str = "";
 	switch(m) {
@@ -292,7 +313,12 @@ std::ostream& operator<<(std::ostream& out, const PlayState& m)
 		case PlayState::OutDroppedball:
 			str = "Dropped ball"; break;
 	}
-	out << str;
+	return str;
+}
+
+std::ostream& operator<<(std::ostream& out, const PlayState& m)
+{
+	out << playStateToString(m);
 	return out;
 }
 
@@ -301,6 +327,28 @@ bool playing(PlayState h)
 	return h == PlayState::InPlay;
 }
 
+const char* matchEventTypeToString(MatchEventType t)
+{
+	const char* str = "";
+	switch(t) {
+		case MatchEventType::Kick:
+			str = "kick"; break;
+		case MatchEventType::Goal:
+			str = "goal"; break;
+		case MatchEventType::Tackle:
+			str = "tackle"; break;
+		case MatchEventType::BallOut:
+			str = "ballout"; break;
+		case MatchEventType::PlayStateChange:
+			str = "playstate"; break;
+		case MatchEventType::MatchHalfChange:
+			str = "half"; break;
+		case MatchEventType::PenaltyShootoutKick:
+			str = "shootout"; break;
+	}
+	return str;
+}
+
 int Match::kickBall(Player* p, const Vector3& v)
 {
 	if(MatchHelpers::canKickBall(*p) && mReferee.canKickBall(*p)) {
@@ -326,8 +374,9 @@ int Match::kickBall(Player* p, const Vector3& v)
 		}
 
 		Vector3 ballvel(v);
-		std::cout << "Ball kicked by " << p->getName() <<
-			" (power: " << ballvel.length() << ") - failpoints: " << failpoints << "\n";
+		LOG_DEBUG(Match, "Ball kicked by %s (power: %3.2f) - failpoints: %d\n",
+				p->getName().c_str(), ballvel.length(), failpoints);
+		addEvent(MatchEventType::Kick, p, failpoints);
 
 		if(getPlayState() == PlayState::OutThrowin) {
 			Vector3 pos = mBall->getPosition();
@@ -346,6 +395,8 @@ int Match::kickBall(Player* p, const Vector3& v)
 		else
 			mBall->addVelocity(Vector3(ballvel / (failpoints + 3.0f)));
 		mBall->kicked(p);
+		mStatistics.ballTouched(*p);
+		mStatistics.ballKicked(*p, mBall->getVelocity());
 		mReferee.ballKicked(*p);
 		for(auto t : mTeams)
 			t->ballKicked(p);
@@ -373,7 +424,9 @@ void Match::addGoal(bool forFirst)
 {
 	mScore[forFirst ? 0 : 1]++;
 	/* TODO: set penalty flag correctly */
-	mGoalInfos[forFirst ? 0 : 1].push_back(GoalInfo(*this, false, mGoalScorer->getTeam()->isFirst() != forFirst));
+	bool owngoal = mGoalScorer->getTeam()->isFirst() != forFirst;
+	mGoalInfos[forFirst ? 0 : 1].push_back(GoalInfo(*this, false, owngoal));
+	addEvent(MatchEventType::Goal, mGoalScorer, owngoal, nullptr, forFirst ? 0 : 1);
 }
 
 int Match::getScore(bool first) const
@@ -385,11 +438,12 @@ bool Match::grabBall(Player* p)
 {
 	if(MatchHelpers::canGrabBall(*p)) {
 		mBall->grab(p);
+		mStatistics.ballTouched(*p);
 		mReferee.ballGrabbed(*p);
 		return true;
 	}
 	else {
-		std::cout << "Can't grab the ball.\n";
+		LOG_DEBUG(Match, "Can't grab the ball.\n");
 		return false;
 	}
 }
@@ -470,6 +524,8 @@ const PenaltyShootout& Match::getPenaltyShootout() const
 
 void Match::addPenaltyShootoutShot(bool goal)
 {
+	addEvent(MatchEventType::PenaltyShootoutKick, mGoalScorer, goal, nullptr,
+			mPenaltyShootout.firstTeamKicksNext() ? 0 : 1);
 	mPenaltyShootout.addShot(goal);
 }
 
@@ -483,6 +539,64 @@ int Match::getAggregateScore(bool first) const
 	return first ? mHomeAgg + mScore[0] : mAwayAgg + mScore[1];
 }
 
+unsigned int Match::getTick() const
+{
+	return mTick;
+}
+
+Soccer::MatchStatistics Match::getStatistics() const
+{
+	return mStatistics.getStatistics();
+}
+
+void Match::setEventQueue(boost::shared_ptr<MatchEventQueue> q)
+{
+	mEventQueue = q;
+}
+
+void Match::setReplayRecorder(boost::shared_ptr<ReplayRecorder> r)
+{
+	mReplayRecorder = r;
+}
+
+// The copy is AI controlled and has no event queue or replay recorder.
+boost::shared_ptr<Match> Match::clone() const
+{
+	boost::shared_ptr<Match> m(new Match(*this, 90.0 / mTimeAccelerationConstant,
+				mExtraTime, mPenalties, mAwayGoals, mHomeAgg, mAwayAgg));
+	MatchSnapshot(*this).restore(*m);
+	return m;
+}
+
+void Match::addEvent(MatchEventType type, const Player* p, int value,
+		const Player* other, int team)
+{
+	if(!mEventQueue)
+		return;
+
+	MatchEvent e;
+	e.Type = type;
+	e.Team = team;
+	e.Value = value;
+	e.PlayerId = -1;
+	e.OtherPlayerId = other ? other->getId() : -1;
+	e.Tick = mTick;
+	e.Time = mTime;
+	e.PlayerX = e.PlayerY = 0.0f;
+	if(p) {
+		if(team == -1)
+			e.Team = p->getTeam()->isFirst() ? 0 : 1;
+		e.PlayerId = p->getId();
+		e.PlayerX = p->getPosition().x;
+		e.PlayerY = p->getPosition().y;
+	}
+	const Vector3& bp = mBall->getPosition();
+	e.BallX = bp.x;
+	e.BallY = bp.y;
+	e.BallZ = bp.z;
+	mEventQueue->push(e);
+}
+
 
 GoalInfo::GoalInfo(const Match& m, bool pen, bool own)
 {
@@ -578,8 +692,8 @@ void PenaltyShootout::addShot(bool goal)
 		mRoundNumber++;
 
 	// update finished flag
-	std::cout << "Penalty shootout status: round " << mRoundNumber << ", "
-		<< mGoals[0] << "-" << mGoals[1] << " - first next: " << mFirstNext << "\n";
+	LOG_INFO(Match, "Penalty shootout status: round %u, %u-%u - first next: %d\n",
+			mRoundNumber, mGoals[0], mGoals[1], mFirstNext);
 	if(mGoals[0] != mGoals[1]) {
 		if(mRoundNumber >= TotalRounds) {
 			if(mFirstNext) {
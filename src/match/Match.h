@@ -14,6 +14,9 @@
 #include "match/Player.h"
 #include "match/Ball.h"
 #include "match/Referee.h"
+#include "match/MatchEvent.h"
+#include "match/MatchStatistics.h"
+#include "match/Replay.h"
 
 enum class MatchHalf {
 	NotStarted,
@@ -29,6 +32,7 @@ enum class MatchHalf {
 	Finished
 };
 
+const char* matchHalfToString(MatchHalf m);
 std::ostream& operator<<(std::ostream& out, const MatchHalf& m);
 bool playing(MatchHalf h);
 
@@ -44,6 +48,7 @@ enum class PlayState {
 	OutDroppedball
 };
 
+const char* playStateToString(PlayState m);
 std::ostream& operator<<(std::ostream& out, const PlayState& m);
 bool playing(PlayState h);
 
@@ -111,8 +116,17 @@ class Match : public Soccer::Match {
 		void addPenaltyShootoutShot(bool goal);
 		bool getAwayGoals() const;
 		int getAggregateScore(bool first) const;
+		unsigned int getTick() const;
+		Soccer::MatchStatistics getStatistics() const;
+		void setEventQueue(boost::shared_ptr<MatchEventQueue> q);
+		void addEvent(MatchEventType type, const Player* p, int value = 0,
+				const Player* other = nullptr, int team = -1);
+		void setReplayRecorder(boost::shared_ptr<ReplayRecorder> r);
+		boost::shared_ptr<Match> clone() const;
 
 	private:
+		friend class MatchSnapshot;
+
 		void applyPlayerAction(PlayerAction* a,
 				const boost::shared_ptr<Player> p, double time);
 		void updateReferee(double time);
@@ -137,6 +151,10 @@ class Match : public Soccer::Match {
 		bool mAwayGoals;
 		int mHomeAgg;
 		int mAwayAgg;
+		unsigned int mTick;
+		boost::shared_ptr<MatchEventQueue> mEventQueue;
+		MatchStatisticsCollector mStatistics;
+		boost::shared_ptr<ReplayRecorder> mReplayRecorder;
 };
 
 #endif
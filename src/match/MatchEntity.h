@@ -15,6 +15,9 @@ class MatchEntity : public Common::Vehicle {
 
 	protected:
 		Match* mMatch;
+
+	private:
+		friend class MatchSnapshot;
 };
 
 #endif
@@ -0,0 +1,45 @@
+#ifndef MATCHEVENT_H
+#define MATCHEVENT_H
+
+#include "match/RingBuffer.h"
+
+enum class MatchEventType : unsigned char {
+	Kick,
+	Goal,
+	Tackle,
+	BallOut,
+	PlayStateChange,
+	MatchHalfChange,
+	PenaltyShootoutKick
+};
+
+const char* matchEventTypeToString(MatchEventType t);
+
+// Value depends on the event type:
+// Kick: fail points of the kick
+// Goal: 1 if own goal
+// Tackle: unused, OtherPlayerId is the tackling player
+// BallOut: new PlayState, Team is the team given the restart and
+//          PlayerId the last player in control of the ball
+// PlayStateChange: new PlayState
+// MatchHalfChange: new MatchHalf
+// PenaltyShootoutKick: 1 if scored
+struct MatchEvent {
+	MatchEventType Type;
+	signed char Team;	// team index, -1 if not related to a team
+	short Value;
+	int PlayerId;		// -1 if no player
+	int OtherPlayerId;	// -1 if no player
+	unsigned int Tick;
+	float Time;		// match time in minutes
+	float PlayerX;
+	float PlayerY;
+	float BallX;
+	float BallY;
+	float BallZ;
+};
+
+typedef RingBuffer<MatchEvent, 4096> MatchEventQueue;
+
+#endif
+
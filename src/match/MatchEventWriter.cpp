@@ -0,0 +1,48 @@
+#include <unistd.h>
+
+#include "match/MatchEventWriter.h"
+
+MatchEventWriter::MatchEventWriter(boost::shared_ptr<MatchEventQueue> q, FILE* f)
+	: mQueue(q),
+	mFile(f),
+	mQuit(false)
+{
+	fprintf(mFile, "# tick time type team value player other playerx playery ballx bally ballz\n");
+	mThread = std::thread(&MatchEventWriter::run, this);
+}
+
+MatchEventWriter::~MatchEventWriter()
+{
+	stop();
+}
+
+void MatchEventWriter::stop()
+{
+	if(!mThread.joinable())
+		return;
+	mQuit = true;
+	mThread.join();
+	if(mQueue->dropped())
+		fprintf(mFile, "# %lu events dropped\n", mQueue->dropped());
+	fflush(mFile);
+}
+
+void MatchEventWriter::run()
+{
+	while(1) {
+		bool quit = mQuit;
+		size_t n = mQueue->consume([this](const MatchEvent& e) { write(e); });
+		if(quit)
+			break;
+		if(n == 0)
+			usleep(10000);
+	}
+}
+
+void MatchEventWriter::write(const MatchEvent& e)
+{
+	fprintf(mFile, "%u %3.3f %s %d %d %d %d %3.2f %3.2f %3.2f %3.2f %3.2f\n",
+			e.Tick, e.Time, matchEventTypeToString(e.Type), e.Team, e.Value,
+			e.PlayerId, e.OtherPlayerId, e.PlayerX, e.PlayerY,
+			e.BallX, e.BallY, e.BallZ);
+}
@@ -0,0 +1,31 @@
+#ifndef MATCHEVENTWRITER_H
+#define MATCHEVENTWRITER_H
+
+#include <stdio.h>
+
+#include <atomic>
+#include <thread>
+
+#include <boost/shared_ptr.hpp>
+
+#include "match/MatchEvent.h"
+
+// Drains a match event queue on a separate thread and writes the events
+// as text lines, one event per line.
+class MatchEventWriter {
+	public:
+		MatchEventWriter(boost::shared_ptr<MatchEventQueue> q, FILE* f);
+		~MatchEventWriter();
+		void stop();
+
+	private:
+		void run();
+		void write(const MatchEvent& e);
+
+		boost::shared_ptr<MatchEventQueue> mQueue;
+		FILE* mFile;
+		std::atomic<bool> mQuit;
+		std::thread mThread;
+};
+
+#endif
@@ -12,6 +12,7 @@ class MatchGUI {
 		virtual bool play() = 0;
 	protected:
 		inline bool progressMatch(double frameTime);
+		inline bool finishMatch();
 		boost::shared_ptr<Match> mMatch;
 
 	private:
@@ -48,5 +49,21 @@ bool MatchGUI::progressMatch(double frameTime)
 	return true;
 }
 
+// stores the result in the match data. Returns false if the match
+// was aborted before it was over.
+bool MatchGUI::finishMatch()
+{
+	if(!mMatch->matchOver())
+		return false;
+
+	Soccer::MatchResult mres(mMatch->getScore(1), mMatch->getScore(0),
+			mMatch->getPenaltyShootout().getScore(true),
+			mMatch->getPenaltyShootout().getScore(false));
+	mres.Statistics = boost::shared_ptr<Soccer::MatchStatistics>(
+			new Soccer::MatchStatistics(mMatch->getStatistics()));
+	mMatch->setResult(mres);
+	return true;
+}
+
 #endif
 
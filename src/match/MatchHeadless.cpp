@@ -0,0 +1,22 @@
+#include "match/MatchHeadless.h"
+
+MatchHeadless::MatchHeadless(boost::shared_ptr<Match> match, int ticksPerSec, unsigned int seed)
+	: MatchGUI(match),
+	mFixedFrameTime(1.0f / ticksPerSec),
+	mRandom(seed)
+{
+}
+
+bool MatchHeadless::play()
+{
+	std::uniform_real_distribution<double> jitter(-0.005f * mFixedFrameTime,
+			0.005f * mFixedFrameTime);
+	while(1) {
+		double frameTime = mFixedFrameTime + jitter(mRandom);
+		mMatch->update(frameTime);
+		if(!progressMatch(frameTime))
+			break;
+	}
+	return finishMatch();
+}
+
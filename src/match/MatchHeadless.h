@@ -0,0 +1,26 @@
+#ifndef MATCHHEADLESS_H
+#define MATCHHEADLESS_H
+
+#include <random>
+
+#include <boost/shared_ptr.hpp>
+
+#include "match/Match.h"
+#include "match/MatchGUI.h"
+
+// Plays a match without any display or input at a fixed frame rate.
+// The frame time jitter (as with freekick3-match -f FPS -s seed) is drawn
+// from a generator owned by this object rather than rand(), so that
+// several matches can be played in parallel threads reproducibly.
+class MatchHeadless : public MatchGUI {
+	public:
+		MatchHeadless(boost::shared_ptr<Match> match, int ticksPerSec, unsigned int seed);
+		bool play();
+
+	private:
+		double mFixedFrameTime;
+		std::mt19937 mRandom;
+};
+
+#endif
+
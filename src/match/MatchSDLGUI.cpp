@@ -30,6 +30,18 @@ static const float playerShadowHeight = 0.95f;
 static const float playerHeight = 1.0f;
 static const float textHeight = 5.0f;
 
+static Vector3 replayPosition(const ReplayEntity& e)
+{
+	return Vector3(e.X * 0.01f, e.Y * 0.01f, e.Z * 0.01f);
+}
+
+static Vector3 replayVelocity(const ReplayEntity& e)
+{
+	float angle = e.Orientation * PI / 128.0f;
+	float speed = e.Speed * 0.1f;
+	return Vector3(cos(angle) * speed, sin(angle) * speed, 0.0f);
+}
+
 MatchSDLGUI::MatchSDLGUI(boost::shared_ptr<Match> match, bool observer, int teamnum, int playernum,
 		int ticksPerSec, bool debug, bool randomise, bool disablegui)
 	: MatchGUI(match),
@@ -52,7 +64,8 @@ MatchSDLGUI::MatchSDLGUI(boost::shared_ptr<Match> match, bool observer, int team
 	mHeading(false),
 	mRandomise(randomise),
 	mDisableGUI(disablegui),
-	mCamFollowsPlayer(true)
+	mCamFollowsPlayer(true),
+	mReplayTime(0.0f)
 {
 	if(ticksPerSec) {
 		mFixedFrameTime = 1.0f / ticksPerSec;
@@ -101,8 +114,18 @@ void MatchSDLGUI::loadFont()
 	}
 }
 
+void MatchSDLGUI::setReplay(boost::shared_ptr<ReplayReader> r)
+{
+	mReplay = r;
+	mReplayTime = 0.0f;
+	mObserver = true;
+}
+
 bool MatchSDLGUI::play()
 {
+	if(mReplay)
+		return playReplay();
+
 	double prevTime = Clock::getTime();
 	while(1) {
 		double newTime = Clock::getTime();
@@ -139,16 +162,44 @@ bool MatchSDLGUI::play()
 				break;
 		}
 	}
-	if(mMatch->matchOver()) {
-		Soccer::MatchResult mres(mMatch->getScore(1), mMatch->getScore(0),
-				mMatch->getPenaltyShootout().getScore(true),
-				mMatch->getPenaltyShootout().getScore(false));
-		mMatch->setResult(mres);
-		return true;
+	return finishMatch();
+}
+
+bool MatchSDLGUI::playReplay()
+{
+	double prevTime = Clock::getTime();
+	while(1) {
+		double newTime = Clock::getTime();
+		double frameTime = newTime - prevTime;
+		prevTime = newTime;
+
+		if(!mPaused) {
+			mReplayTime += frameTime;
+			if(!mReplay->advance(mReplayTime)) {
+				mReplayTime = mReplay->getTime();
+				mPaused = true;
+			}
+		}
+
+		if(handleInput(frameTime))
+			break;
+		startFrame();
+		drawEnvironment();
+		drawBall();
+		drawPlayers();
+		drawTexts();
+		finishFrame();
+		mClock.limitFPS(60);
 	}
 	return false;
 }
 
+void MatchSDLGUI::seekReplay(float t)
+{
+	mReplayTime = clamp(0.0f, t, mReplay->getLength());
+	mReplay->seek(mReplayTime);
+}
+
 void MatchSDLGUI::drawEnvironment()
 {
 	float pwidth = mMatch->getPitchWidth();
@@ -188,34 +239,54 @@ void MatchSDLGUI::drawEnvironment()
 
 void MatchSDLGUI::drawTexts()
 {
-	bool penaltyshootout = mMatch->getPenaltyShootout().getScore(true) ||
-		mMatch->getPenaltyShootout().getScore(false) ||
-		mMatch->getMatchHalf() == MatchHalf::PenaltyShootout;
+	int score[2] = { mMatch->getScore(true), mMatch->getScore(false) };
+	int penalties[2] = { mMatch->getPenaltyShootout().getScore(true),
+		mMatch->getPenaltyShootout().getScore(false) };
+	MatchHalf half = mMatch->getMatchHalf();
+	double time = mMatch->getTime();
+	const Player* playerincontrol = mMatch->getReferee()->getPlayerInControl();
+
+	if(mReplay) {
+		const ReplayFrame& f = mReplay->getFrame();
+		for(int i = 0; i < 2; i++) {
+			score[i] = f.Score[i];
+			penalties[i] = f.Penalties[i];
+		}
+		half = MatchHalf(f.MatchHalf);
+		time = f.MatchTime / 60000.0;
+		playerincontrol = nullptr;
+		if(f.PlayerInControl) {
+			playerincontrol = mMatch->getPlayer((f.PlayerInControl - 1) / MaxReplayPlayers,
+					(f.PlayerInControl - 1) % MaxReplayPlayers);
+		}
+	}
+
+	bool penaltyshootout = penalties[0] || penalties[1] ||
+		half == MatchHalf::PenaltyShootout;
 
 	std::stringstream result;
-	result << mMatch->getTeam(0)->getName() << " " << mMatch->getScore(true) <<
-		" - " << mMatch->getScore(false) << " " << mMatch->getTeam(1)->getName();
+	result << mMatch->getTeam(0)->getName() << " " << score[0] <<
+		" - " << score[1] << " " << mMatch->getTeam(1)->getName();
 	if(penaltyshootout) {
-		result << " (" << mMatch->getPenaltyShootout().getScore(true) <<
-			" - " << mMatch->getPenaltyShootout().getScore(false) << ")";
+		result << " (" << penalties[0] << " - " << penalties[1] << ")";
 	} else {
 		if(mMatch->getAwayGoals()) {
-			result << " (" << mMatch->getAggregateScore(true) <<
-				" - " << mMatch->getAggregateScore(false) << ")";
+			result << " (" << mMatch->getAggregateScore(true) - mMatch->getScore(true) + score[0] <<
+				" - " << mMatch->getAggregateScore(false) - mMatch->getScore(false) + score[1] << ")";
 		}
 	}
 
 	drawText(90, screenHeight - 30, FontConfig(result.str().c_str(), Color(255, 255, 255), 1.5f), true, false);
 
-	if(mMatch->getMatchHalf() != MatchHalf::Finished && mMatch->getMatchHalf() != MatchHalf::PenaltyShootout) {
+	if(half != MatchHalf::Finished && half != MatchHalf::PenaltyShootout) {
 		char timebuf[128];
-		int min = int(mMatch->getTime());
+		int min = int(time);
 
-		if(mMatch->getMatchHalf() >= MatchHalf::HalfTimePauseBegin) {
+		if(half >= MatchHalf::HalfTimePauseBegin) {
 			min += 45;
-			if(mMatch->getMatchHalf() >= MatchHalf::FullTimePauseBegin) {
+			if(half >= MatchHalf::FullTimePauseBegin) {
 				min += 45;
-				if(mMatch->getMatchHalf() >= MatchHalf::ExtraTimeSecondHalf) {
+				if(half >= MatchHalf::ExtraTimeSecondHalf) {
 					min += 15;
 				}
 			}
@@ -224,8 +295,17 @@ void MatchSDLGUI::drawTexts()
 		drawText(10, screenHeight - 30, FontConfig(timebuf, Color(255, 255, 255), 1.5f), true, false);
 	}
 
+	if(mReplay) {
+		char replaybuf[128];
+		int pos = mReplay->getTime();
+		int len = mReplay->getLength();
+		snprintf(replaybuf, 127, "Replay %d:%02d / %d:%02d", pos / 60, pos % 60,
+				len / 60, len % 60);
+		replaybuf[127] = '\0';
+		drawText(screenWidth - 200, screenHeight - 30, FontConfig(replaybuf, Color(255, 255, 255), 1.0f), true, false);
+	}
+
 	{
-		const Player* playerincontrol = mMatch->getReferee()->getPlayerInControl();
 		if(playerincontrol) {
 			std::string plname = Soccer::Player::getShorterName(*playerincontrol);
 			char plbuf[128];
@@ -241,6 +321,9 @@ void MatchSDLGUI::drawTexts()
 		drawText(screenWidth / 2, screenHeight / 2, FontConfig("Paused", Color(255, 255, 255), 2.0f),
 				true, true);
 	}
+	else if(mReplay) {
+		// goal scorers are not part of the replay
+	}
 	else if((mMatch->getPlayState() == PlayState::OutKickoff &&
 				playing(mMatch->getMatchHalf()) &&
 					(mMatch->getScore(true) + mMatch->getScore(false) != 0)) ||
@@ -281,7 +364,9 @@ void MatchSDLGUI::drawTexts()
 	}
 }
 
-const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p)
+const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p,
+		const Vector3& pos, const Vector3& vel,
+		bool tackling, bool standing, const Vector3& ballpos)
 {
 	/* Mapping:
 	 * 0  => Stand, direction north
@@ -316,11 +401,11 @@ const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p)
 	 * The second diving frames are not used (yet).
 	 */
 	int index = 0;
-	Vector3 vec = p->getVelocity();
-	if(p->isGoalkeeper() && p->getPosition().z > 0.1f &&
+	Vector3 vec = vel;
+	if(p->isGoalkeeper() && pos.z > 0.1f &&
 			(fabs(vec.x) > 0.1f || fabs(vec.y) > 0.1f)) {
 		// diving
-		auto vecToBall = MatchEntity::vectorFromTo(*p, *mMatch->getBall());
+		Vector3 vecToBall = ballpos - pos;
 		if(vecToBall.y > 0.0f) {
 			// facing north
 			if(vec.x > 0.0f) {
@@ -338,7 +423,7 @@ const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p)
 		}
 	} else {
 		if(vec.null()) {
-			vec = MatchEntity::vectorFromTo(*p, *mMatch->getBall());
+			vec = ballpos - pos;
 		}
 		if(vec.x > fabs(vec.y)) {
 			index = 1; // west
@@ -349,16 +434,16 @@ const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p)
 		else if(vec.y < 0) {
 			index = 2; // south
 		}
-		if(p->tackling()) {
+		if(tackling) {
 			index += 8;
 		}
-		else if(!p->standing()) {
+		else if(!standing) {
 			// Just pick one of the images. We don't want the fallen player
 			// to turn to look at the ball.
 			index = 5;
 		}
 
-		if(index < 4 && p->getVelocity().length() > 0.2f) {
+		if(index < 4 && vel.length() > 0.2f) {
 			index = 12 + index * 2;
 			auto it = mAnimationStep.find(p);
 			if(it == mAnimationStep.end()) {
@@ -387,6 +472,8 @@ const boost::shared_ptr<Texture> MatchSDLGUI::playerTexture(const Player* p)
 
 void MatchSDLGUI::drawPlayers()
 {
+	Vector3 ballpos = mReplay ? replayPosition(mReplay->getFrame().Ball) :
+		mMatch->getBall()->getPosition();
 	for(int i = 0; i < 2; i++) {
 		const Player* pl;
 		int j = 0;
@@ -394,8 +481,20 @@ void MatchSDLGUI::drawPlayers()
 			pl = mMatch->getPlayer(i, j);
 			if(!pl)
 				break;
+			Vector3 v(pl->getPosition());
+			Vector3 vel(pl->getVelocity());
+			bool tackling = pl->tackling();
+			bool standing = pl->standing();
+			if(mReplay) {
+				if(j >= (int)mReplay->getNumPlayers(i))
+					break;
+				const ReplayEntity& e = mReplay->getFrame().Players[i][j];
+				v = replayPosition(e);
+				vel = replayVelocity(e);
+				tackling = e.State & ReplayEntity::Tackling;
+				standing = !(e.State & ReplayEntity::Fallen);
+			}
 			j++;
-			const Vector3& v(pl->getPosition());
 
 			drawSprite(*mPlayerShadowTexture,
 					Rectangle((-mCamera.x + v.x - 0.8f + v.z * 0.3f) * mScaleLevel + screenWidth * 0.5f,
@@ -403,13 +502,13 @@ void MatchSDLGUI::drawPlayers()
 						mScaleLevel * 2.0f, mScaleLevel * 2.0f),
 					Rectangle(1, 1, -1, -1), playerShadowHeight);
 
-			drawSprite(*playerTexture(pl),
+			drawSprite(*playerTexture(pl, v, vel, tackling, standing, ballpos),
 					Rectangle((-mCamera.x + v.x - 0.8f) * mScaleLevel + screenWidth * 0.5f,
 						(-mCamera.y + v.y + v.z * 0.6f) * mScaleLevel + screenHeight * 0.5f,
 						mScaleLevel * 2.0f, mScaleLevel * 2.0f),
 					Rectangle(1, 1, -1, -1), playerHeight);
 
-			if(mDebugDisplay > 0) {
+			if(mDebugDisplay > 0 && !mReplay) {
 				drawText(v.x, v.y,
 						FontConfig(pl->getAIController()->getDescription().c_str(),
 							Color(0, 0, 0), 0.05f), false, true);
@@ -430,7 +529,12 @@ void MatchSDLGUI::drawPlayers()
 void MatchSDLGUI::drawBall()
 {
 	Vector3 v(mMatch->getBall()->getPosition());
-	if(mMatch->getBall()->grabbed())
+	bool grabbed = mMatch->getBall()->grabbed();
+	if(mReplay) {
+		v = replayPosition(mReplay->getFrame().Ball);
+		grabbed = mReplay->getFrame().Ball.State & ReplayEntity::Grabbed;
+	}
+	if(grabbed)
 		v.z += 1.0f;
 
 	drawSprite(*mBallShadowTexture, Rectangle((-mCamera.x + v.x - 0.2f + v.z * 0.3f) * mScaleLevel + screenWidth * 0.5f,
@@ -447,7 +551,12 @@ void MatchSDLGUI::startFrame()
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	if(!mFreeCamera) {
-		if(mControlledPlayerIndex != -1 && mCamFollowsPlayer) {
+		if(mReplay) {
+			Vector3 b = replayPosition(mReplay->getFrame().Ball);
+			mCamera.x = b.x;
+			mCamera.y = b.y;
+		}
+		else if(mControlledPlayerIndex != -1 && mCamFollowsPlayer) {
 			mCamera.x = mPlayer->getPosition().x;
 			mCamera.y = mPlayer->getPosition().y;
 		}
@@ -771,6 +880,19 @@ bool MatchSDLGUI::handleInput(float frameTime)
 						mPaused = !mPaused;
 						break;
 
+					case SDLK_COMMA:
+					case SDLK_PERIOD:
+						if(mReplay) {
+							seekReplay(mReplayTime +
+									(event.key.keysym.sym == SDLK_PERIOD ? 10.0f : -10.0f));
+						}
+						break;
+
+					case SDLK_HOME:
+						if(mReplay)
+							seekReplay(0.0f);
+						break;
+
 					case SDLK_v:
 						if(SDL_GetModState() & KMOD_CTRL) {
 							mDebugDisplay++;
@@ -789,6 +911,12 @@ bool MatchSDLGUI::handleInput(float frameTime)
 						break;
 
 					default:
+						if(mReplay && event.key.keysym.sym >= SDLK_0 &&
+								event.key.keysym.sym <= SDLK_9) {
+							// jump to 0%, 10%, ... 90% of the replay
+							seekReplay(mReplay->getLength() *
+									(event.key.keysym.sym - SDLK_0) * 0.1f);
+						}
 						break;
 				}
 				break;
@@ -17,6 +17,7 @@
 #include "match/Clock.h"
 #include "match/PlayerController.h"
 #include "match/PlayerActions.h"
+#include "match/Replay.h"
 
 struct LineCoord {
 	LineCoord(float x_, float y_)
@@ -33,7 +34,10 @@ class MatchSDLGUI : public MatchGUI, public PlayerController {
 		~MatchSDLGUI();
 		bool play();
 		boost::shared_ptr<PlayerAction> act(double time);
+		void setReplay(boost::shared_ptr<ReplayReader> r);
 	private:
+		bool playReplay();
+		void seekReplay(float t);
 		void drawEnvironment();
 		void drawTexts();
 		void drawPlayers();
@@ -55,7 +59,9 @@ class MatchSDLGUI : public MatchGUI, public PlayerController {
 		void setupPitchLines();
 		void drawPitchLines();
 		void drawGoals();
-		const boost::shared_ptr<Common::Texture> playerTexture(const Player* p);
+		const boost::shared_ptr<Common::Texture> playerTexture(const Player* p,
+				const Common::Vector3& pos, const Common::Vector3& vel,
+				bool tackling, bool standing, const Common::Vector3& ballpos);
 		std::pair<const Soccer::Kit, const Soccer::Kit> getKits() const;
 		static Common::Color mapPitchColor(const Common::Color& c1, const Common::Color& c2,
 				const Common::Color& c);
@@ -98,6 +104,8 @@ class MatchSDLGUI : public MatchGUI, public PlayerController {
 		bool mCamFollowsPlayer;
 
 		std::map<const Player*, unsigned int> mAnimationStep;
+		boost::shared_ptr<ReplayReader> mReplay;
+		float mReplayTime;
 };
 
 #endif
@@ -0,0 +1,184 @@
+#include <stdexcept>
+
+#include "match/MatchSnapshot.h"
+#include "match/ai/PlayerAIController.h"
+#include "match/ai/AIPlayStates.h"
+
+MatchSnapshot::EntityState::EntityState(const MatchEntity& e)
+	: Position(e.mPosition),
+	Velocity(e.mVelocity),
+	Acceleration(e.mAcceleration)
+{
+}
+
+void MatchSnapshot::EntityState::restore(MatchEntity& e) const
+{
+	e.mPosition = Position;
+	e.mVelocity = Velocity;
+	e.mAcceleration = Acceleration;
+}
+
+MatchSnapshot::PlayerState::PlayerState(const Player& p)
+	: Entity(p),
+	HomePosition(p.mHomePosition),
+	Tactics(p.mTactics),
+	BallKickedTimer(p.mBallKickedTimer),
+	TacklingTimer(p.mTacklingTimer),
+	TackledTimer(p.mTackledTimer),
+	KickInTimer(p.mAIController->mKickInTimer),
+	AI(p.mAIController->mPlayState->mCurrentState->clone(nullptr, nullptr))
+{
+}
+
+void MatchSnapshot::PlayerState::restore(Player& p) const
+{
+	Entity.restore(p);
+	p.mHomePosition = HomePosition;
+	p.mTactics = Tactics;
+	p.mBallKickedTimer = BallKickedTimer;
+	p.mTacklingTimer = TacklingTimer;
+	p.mTackledTimer = TackledTimer;
+	p.mAIController->mKickInTimer = KickInTimer;
+	AIPlayController* pc = p.mAIController->mPlayState.get();
+	pc->mCurrentState = AI->clone(&p, pc);
+}
+
+MatchSnapshot::TeamState::TeamState(const Team& t)
+	: PlayerNearestToBall(-1),
+	PlayerReceivingPass(-1),
+	SupportingPositionsTimer(t.mSupportingPositionsTimer),
+	SupportingPositions(t.mSupportingPositions)
+{
+	for(unsigned int i = 0; i < t.mPlayers.size(); i++) {
+		const Player* p = t.mPlayers[i].get();
+		Players.push_back(PlayerState(*p));
+		if(p == t.mPlayerNearestToBall)
+			PlayerNearestToBall = i;
+		if(p == t.mPlayerReceivingPass)
+			PlayerReceivingPass = i;
+	}
+}
+
+void MatchSnapshot::TeamState::restore(Team& t) const
+{
+	if(t.mPlayers.size() != Players.size())
+		throw std::runtime_error("MatchSnapshot: number of players doesn't match");
+	for(unsigned int i = 0; i < Players.size(); i++)
+		Players[i].restore(*t.mPlayers[i]);
+	t.mPlayerNearestToBall = PlayerNearestToBall == -1 ? nullptr :
+		t.mPlayers[PlayerNearestToBall].get();
+	t.mPlayerReceivingPass = PlayerReceivingPass == -1 ? nullptr :
+		t.mPlayers[PlayerReceivingPass].get();
+	t.mSupportingPositionsTimer = SupportingPositionsTimer;
+	t.mSupportingPositions = SupportingPositions;
+}
+
+int MatchSnapshot::playerIndex(const Match& m, const Player* p)
+{
+	if(!p)
+		return -1;
+	for(int i = 0; i < 2; i++) {
+		const auto& pls = m.mTeams[i]->mPlayers;
+		for(unsigned int j = 0; j < pls.size(); j++) {
+			if(pls[j].get() == p)
+				return (i << 8) | j;
+		}
+	}
+	throw std::runtime_error("MatchSnapshot: player not in match");
+}
+
+Player* MatchSnapshot::getPlayer(Match& m, int idx)
+{
+	if(idx == -1)
+		return nullptr;
+	return m.mTeams[idx >> 8]->mPlayers.at(idx & 0xff).get();
+}
+
+MatchSnapshot::MatchSnapshot(const Match& m)
+	: mResult(m.getResult()),
+	mTime(m.mTime),
+	mTimeAccelerationConstant(m.mTimeAccelerationConstant),
+	mMatchHalf(m.mMatchHalf),
+	mPlayState(m.mPlayState),
+	mGoalInfos(m.mGoalInfos),
+	mGoalScorer(playerIndex(m, m.mGoalScorer)),
+	mPenaltyShootout(m.mPenaltyShootout),
+	mTick(m.mTick),
+	mBall(*m.mBall),
+	mBallCollisionFreePoint(m.mBall->mCollisionFreePoint),
+	mBallGrabbed(m.mBall->mGrabbed),
+	mBallGrabber(playerIndex(m, m.mBall->mGrabber)),
+	mFirstTeamInControl(m.mReferee.mFirstTeamInControl),
+	mRestartPosition(m.mReferee.mRestartPosition),
+	mOutOfPlayClock(m.mReferee.mOutOfPlayClock),
+	mWaitForResumeClock(m.mReferee.mWaitForResumeClock),
+	mWaitForPenaltyShot(m.mReferee.mWaitForPenaltyShot),
+	mPlayerInControl(playerIndex(m, m.mReferee.mPlayerInControl)),
+	mFouledTeam(m.mReferee.mFouledTeam),
+	mFoulPosition(m.mReferee.mFoulPosition),
+	mRestartedPlayer(playerIndex(m, m.mReferee.mRestartedPlayer)),
+	mStatistics(m.mStatistics.mStatistics),
+	mStatisticsPlayTime(m.mStatistics.mPlayTime),
+	mPasser(playerIndex(m, m.mStatistics.mPasser))
+{
+	for(int i = 0; i < 2; i++) {
+		mScore[i] = m.mScore[i];
+		mTeams.push_back(TeamState(*m.mTeams[i]));
+		mPossessionTime[i] = m.mStatistics.mPossessionTime[i];
+		for(int j = 0; j < 3; j++)
+			mThirdTime[i][j] = m.mStatistics.mThirdTime[i][j];
+		mDistance[i] = m.mStatistics.mDistance[i];
+	}
+}
+
+void MatchSnapshot::restore(Match& m) const
+{
+	m.setResult(mResult);
+	m.mTime = mTime;
+	// not recomputed from the match time, which could round differently
+	m.mTimeAccelerationConstant = mTimeAccelerationConstant;
+	m.mMatchHalf = mMatchHalf;
+	m.mPlayState = mPlayState;
+	m.mGoalInfos = mGoalInfos;
+	m.mGoalScorer = getPlayer(m, mGoalScorer);
+	m.mPenaltyShootout = mPenaltyShootout;
+	m.mTick = mTick;
+
+	for(int i = 0; i < 2; i++) {
+		m.mScore[i] = mScore[i];
+		mTeams[i].restore(*m.mTeams[i]);
+	}
+
+	mBall.restore(*m.mBall);
+	m.mBall->mCollisionFreePoint = mBallCollisionFreePoint;
+	m.mBall->mGrabbed = mBallGrabbed;
+	m.mBall->mGrabber = getPlayer(m, mBallGrabber);
+
+	Referee& r = m.mReferee;
+	r.mFirstTeamInControl = mFirstTeamInControl;
+	r.mRestartPosition = mRestartPosition;
+	r.mOutOfPlayClock = mOutOfPlayClock;
+	r.mWaitForResumeClock = mWaitForResumeClock;
+	r.mWaitForPenaltyShot = mWaitForPenaltyShot;
+	r.mPlayerInControl = getPlayer(m, mPlayerInControl);
+	r.mFouledTeam = mFouledTeam;
+	r.mFoulPosition = mFoulPosition;
+	r.mRestartedPlayer = getPlayer(m, mRestartedPlayer);
+
+	MatchStatisticsCollector& s = m.mStatistics;
+	s.mStatistics = mStatistics;
+	s.mPlayTime = mStatisticsPlayTime;
+	s.mPasser = getPlayer(m, mPasser);
+	for(int i = 0; i < 2; i++) {
+		s.mPossessionTime[i] = mPossessionTime[i];
+		for(int j = 0; j < 3; j++)
+			s.mThirdTime[i][j] = mThirdTime[i][j];
+		s.mDistance[i] = mDistance[i];
+	}
+}
+
+unsigned int MatchSnapshot::getTick() const
+{
+	return mTick;
+}
+
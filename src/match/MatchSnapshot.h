@@ -0,0 +1,104 @@
+#ifndef MATCHSNAPSHOT_H
+#define MATCHSNAPSHOT_H
+
+#include <vector>
+#include <array>
+
+#include <boost/shared_ptr.hpp>
+
+#include "common/Vector3.h"
+
+#include "soccer/Match.h"
+#include "soccer/PlayerTactics.h"
+
+#include "match/Clock.h"
+#include "match/Distance.h"
+#include "match/Match.h"
+
+class AIState;
+
+// Copy of the complete simulation state of a match at one point in time.
+// Pointers between the match objects are stored as player indices so that
+// the snapshot can be restored into any match set up with the same teams.
+// The global rand() state is not part of the snapshot.
+class MatchSnapshot {
+	public:
+		MatchSnapshot(const Match& m);
+		void restore(Match& m) const;
+		unsigned int getTick() const;
+
+	private:
+		// Player pointers shared between teams are stored as
+		// (team << 8) | index, -1 for null.
+		static int playerIndex(const Match& m, const Player* p);
+		static Player* getPlayer(Match& m, int idx);
+
+		struct EntityState {
+			EntityState(const MatchEntity& e);
+			void restore(MatchEntity& e) const;
+			Common::Vector3 Position;
+			Common::Vector3 Velocity;
+			Common::Vector3 Acceleration;
+		};
+
+		struct PlayerState {
+			PlayerState(const Player& p);
+			void restore(Player& p) const;
+			EntityState Entity;
+			RelVector3 HomePosition;
+			Soccer::PlayerTactics Tactics;
+			Countdown BallKickedTimer;
+			Countdown TacklingTimer;
+			Countdown TackledTimer;
+			Countdown KickInTimer;
+			boost::shared_ptr<AIState> AI;
+		};
+
+		struct TeamState {
+			TeamState(const Team& t);
+			void restore(Team& t) const;
+			std::vector<PlayerState> Players;
+			int PlayerNearestToBall;
+			int PlayerReceivingPass;
+			Countdown SupportingPositionsTimer;
+			std::vector<std::vector<Team::OffensivePosition>> SupportingPositions;
+		};
+
+		Soccer::MatchResult mResult;
+		double mTime;
+		double mTimeAccelerationConstant;
+		MatchHalf mMatchHalf;
+		PlayState mPlayState;
+		int mScore[2];
+		std::array<std::vector<GoalInfo>, 2> mGoalInfos;
+		int mGoalScorer;
+		PenaltyShootout mPenaltyShootout;
+		unsigned int mTick;
+
+		std::vector<TeamState> mTeams;
+
+		EntityState mBall;
+		Common::Vector3 mBallCollisionFreePoint;
+		bool mBallGrabbed;
+		int mBallGrabber;
+
+		bool mFirstTeamInControl;
+		Common::Vector3 mRestartPosition;
+		Countdown mOutOfPlayClock;
+		Countdown mWaitForResumeClock;
+		Countdown mWaitForPenaltyShot;
+		int mPlayerInControl;
+		int mFouledTeam;
+		Common::Vector3 mFoulPosition;
+		int mRestartedPlayer;
+
+		Soccer::MatchStatistics mStatistics;
+		double mStatisticsPlayTime;
+		double mPossessionTime[2];
+		double mThirdTime[2][3];
+		std::vector<float> mDistance[2];
+		int mPasser;
+};
+
+#endif
+
@@ -0,0 +1,135 @@
+#include <math.h>
+
+#include "match/MatchStatistics.h"
+#include "match/Match.h"
+#include "match/MatchHelpers.h"
+#include "match/Team.h"
+
+using Common::Vector3;
+
+MatchStatisticsCollector::MatchStatisticsCollector(const Match* m)
+	: mMatch(m),
+	mPlayTime(0.0),
+	mPasser(nullptr)
+{
+	for(int i = 0; i < 2; i++) {
+		mPossessionTime[i] = 0.0;
+		for(int j = 0; j < 3; j++)
+			mThirdTime[i][j] = 0.0;
+	}
+}
+
+void MatchStatisticsCollector::update(double time)
+{
+	if(!playing(mMatch->getMatchHalf()) || mMatch->getMatchHalf() == MatchHalf::PenaltyShootout)
+		return;
+
+	for(int i = 0; i < 2; i++) {
+		const auto& pls = mMatch->getTeam(i)->getPlayers();
+		if(mDistance[i].size() != pls.size())
+			mDistance[i].resize(pls.size(), 0.0f);
+		for(unsigned int j = 0; j < pls.size(); j++) {
+			const Vector3& v = pls[j]->getVelocity();
+			mDistance[i][j] += sqrt(v.x * v.x + v.y * v.y) * time;
+		}
+	}
+
+	if(!playing(mMatch->getPlayState()))
+		return;
+
+	mPlayTime += time;
+	mPossessionTime[mMatch->getReferee()->isFirstTeamInControl() ? 0 : 1] += time;
+
+	float third = mMatch->getPitchHeight() / 6.0f;
+	float bally = mMatch->getBall()->getPosition().y;
+	for(int i = 0; i < 2; i++) {
+		float y = MatchHelpers::attacksUp(*mMatch->getTeam(i)) ? bally : -bally;
+		mThirdTime[i][y < -third ? 0 : y > third ? 2 : 1] += time;
+	}
+}
+
+void MatchStatisticsCollector::ballTouched(const Player& p)
+{
+	if(!mPasser || mPasser == &p)
+		return;
+
+	int passteam = teamIndex(*mPasser);
+	mStatistics.Teams[passteam].PassesAttempted++;
+	if(passteam == teamIndex(p))
+		mStatistics.Teams[passteam].PassesCompleted++;
+	mPasser = nullptr;
+}
+
+void MatchStatisticsCollector::ballKicked(const Player& p, const Vector3& vel)
+{
+	if(mMatch->getMatchHalf() == MatchHalf::PenaltyShootout)
+		return;
+
+	// a kick heading towards the goal from within shooting distance
+	// is a shot, anything else is a pass or dribble.
+	const Vector3 ballpos = mMatch->getBall()->getPosition();
+	const Vector3 goal = MatchHelpers::oppositeGoalPosition(p);
+	float dy = goal.y - ballpos.y;
+	if(vel.y != 0.0f && (dy < 0.0f) == (vel.y < 0.0f) && fabs(dy) < 35.0f) {
+		float x = ballpos.x + vel.x * (dy / vel.y);
+		if(fabs(x) < GOAL_WIDTH_2) {
+			mStatistics.Teams[teamIndex(p)].ShotsOnTarget++;
+			mPasser = nullptr;
+			return;
+		}
+		else if(fabs(x) < GOAL_WIDTH_2 + 8.0f) {
+			mStatistics.Teams[teamIndex(p)].ShotsOffTarget++;
+			mPasser = nullptr;
+			return;
+		}
+	}
+	mPasser = &p;
+}
+
+void MatchStatisticsCollector::playerTackled(const Player& tackler)
+{
+	mStatistics.Teams[teamIndex(tackler)].Tackles++;
+}
+
+void MatchStatisticsCollector::playStateChanged(PlayState s, bool firstInControl)
+{
+	Soccer::TeamStatistics& ts = mStatistics.Teams[firstInControl ? 0 : 1];
+	switch(s) {
+		case PlayState::OutCornerkick:
+			ts.Corners++; break;
+		case PlayState::OutGoalkick:
+			ts.GoalKicks++; break;
+		case PlayState::OutThrowin:
+			ts.ThrowIns++; break;
+		default:
+			break;
+	}
+
+	if(s != PlayState::InPlay && mPasser) {
+		// pass ended out of play
+		mStatistics.Teams[teamIndex(*mPasser)].PassesAttempted++;
+		mPasser = nullptr;
+	}
+}
+
+Soccer::MatchStatistics MatchStatisticsCollector::getStatistics() const
+{
+	Soccer::MatchStatistics s(mStatistics);
+	for(int i = 0; i < 2; i++) {
+		Soccer::TeamStatistics& ts = s.Teams[i];
+		if(mPlayTime > 0.0) {
+			ts.Possession = mPossessionTime[i] / mPlayTime;
+			for(int j = 0; j < 3; j++)
+				ts.TimeInThird[j] = mThirdTime[i][j] / mPlayTime;
+		}
+		const auto& pls = mMatch->getTeam(i)->getPlayers();
+		for(unsigned int j = 0; j < pls.size() && j < mDistance[i].size(); j++)
+			ts.PlayerDistance[pls[j]->getId()] = mDistance[i][j];
+	}
+	return s;
+}
+
+int MatchStatisticsCollector::teamIndex(const Player& p)
+{
+	return p.getTeam()->isFirst() ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#ifndef MATCHSTATISTICS_H
+#define MATCHSTATISTICS_H
+
+#include <vector>
+
+#include "common/Vector3.h"
+
+#include "soccer/Match.h"
+
+class Match;
+class Player;
+
+enum class PlayState;
+
+// Collects match statistics incrementally while the match is played.
+class MatchStatisticsCollector {
+	public:
+		MatchStatisticsCollector(const Match* m);
+		void update(double time);
+		void ballTouched(const Player& p);
+		void ballKicked(const Player& p, const Common::Vector3& vel);
+		void playerTackled(const Player& tackler);
+		void playStateChanged(PlayState s, bool firstInControl);
+		Soccer::MatchStatistics getStatistics() const;
+
+	private:
+		friend class MatchSnapshot;
+
+		static int teamIndex(const Player& p);
+
+		const Match* mMatch;
+		Soccer::MatchStatistics mStatistics;
+		double mPlayTime;
+		double mPossessionTime[2];
+		double mThirdTime[2][3];
+		std::vector<float> mDistance[2];
+		const Player* mPasser;
+};
+
+#endif
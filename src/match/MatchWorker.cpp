@@ -0,0 +1,274 @@
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+
+#include <algorithm>
+#include <sstream>
+#include <chrono>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Log.h"
+
+#include "match/Match.h"
+#include "match/MatchHeadless.h"
+#include "match/MatchWorker.h"
+
+MatchWorker::MatchWorker(int infd, int outfd)
+	: mIn(infd),
+	mOut(outfd),
+	mBufferPos(0)
+{
+}
+
+bool MatchWorker::fill()
+{
+	char buf[65536];
+	while(1) {
+		ssize_t ret = read(mIn, buf, sizeof(buf));
+		if(ret == -1 && errno == EINTR)
+			continue;
+		if(ret <= 0)
+			return false;
+		mBuffer.erase(0, mBufferPos);
+		mBufferPos = 0;
+		mBuffer.append(buf, ret);
+		return true;
+	}
+}
+
+bool MatchWorker::readLine(std::string& line)
+{
+	while(1) {
+		size_t nl = mBuffer.find('\n', mBufferPos);
+		if(nl != std::string::npos) {
+			line = mBuffer.substr(mBufferPos, nl - mBufferPos);
+			mBufferPos = nl + 1;
+			return true;
+		}
+		if(!fill())
+			return false;
+	}
+}
+
+bool MatchWorker::readBytes(std::string& buf, size_t n)
+{
+	while(mBuffer.size() - mBufferPos < n) {
+		if(!fill())
+			return false;
+	}
+	buf = mBuffer.substr(mBufferPos, n);
+	mBufferPos += n;
+	return true;
+}
+
+void MatchWorker::writeAll(const std::string& s)
+{
+	size_t written = 0;
+	while(written < s.size()) {
+		ssize_t ret = write(mOut, s.data() + written, s.size() - written);
+		if(ret == -1) {
+			if(errno == EINTR)
+				continue;
+			throw std::runtime_error(std::string("Worker write failed: ") + strerror(errno));
+		}
+		written += ret;
+	}
+}
+
+bool MatchWorker::serve()
+{
+	std::string line;
+	while(readLine(line)) {
+		std::istringstream ss(line);
+		std::string cmd;
+		ss >> cmd;
+		if(cmd.empty())
+			continue;
+		if(cmd == "quit")
+			return true;
+		if(cmd != "match") {
+			writeAll("error unknown command " + cmd + "\n");
+			continue;
+		}
+
+		size_t len = 0;
+		ss >> len;
+		std::vector<std::string> options;
+		std::string opt;
+		while(ss >> opt)
+			options.push_back(opt);
+
+		std::string data;
+		if(!readBytes(data, len))
+			return false;
+
+		std::string response;
+		try {
+			auto start = std::chrono::steady_clock::now();
+			unsigned int ticks = 0;
+			std::string res = playMatch(data, options, ticks);
+			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+					std::chrono::steady_clock::now() - start).count();
+			response = "result " + std::to_string(res.size()) + " " + std::to_string(ticks) +
+				" " + std::to_string(ms) + "\n" + res;
+		}
+		catch(std::exception& e) {
+			std::string msg(e.what());
+			std::replace(msg.begin(), msg.end(), '\n', ' ');
+			response = "error " + msg + "\n";
+		}
+		writeAll(response);
+	}
+	return false;
+}
+
+std::string MatchWorker::playMatch(const std::string& data, const std::vector<std::string>& options,
+		unsigned int& ticks)
+{
+	double seconds = 180.0;
+	int ticksPerSec = 60;
+	int seed = 1;
+
+	for(unsigned int i = 0; i < options.size(); i++) {
+		if(i + 1 >= options.size())
+			throw std::runtime_error("Missing argument for " + options[i]);
+		if(options[i] == "-m")
+			seconds = atof(options[++i].c_str());
+		else if(options[i] == "-f")
+			ticksPerSec = atoi(options[++i].c_str());
+		else if(options[i] == "-s")
+			seed = atoi(options[++i].c_str());
+		else
+			throw std::runtime_error("Unknown option " + options[i]);
+	}
+	if(seconds < 0.0 || ticksPerSec <= 0)
+		throw std::runtime_error("Invalid option value");
+
+	bool onlypenalties = false;
+	if(seconds == 0.0) {
+		seconds = 1.0;
+		onlypenalties = true;
+	}
+
+	boost::shared_ptr<Soccer::Match> matchdata = Soccer::DataExchange::parseMatchData(data);
+	const Soccer::MatchRules& r = matchdata->getRules();
+	boost::shared_ptr<Match> match(new Match(*matchdata, seconds, r.ExtraTimeOnTie,
+				r.PenaltiesOnTie, r.AwayGoals, r.HomeAggregate, r.AwayAggregate));
+	if(onlypenalties)
+		match->setMatchHalf(MatchHalf::PenaltyShootout);
+
+	// the result only depends on the match data and the options, like
+	// with freekick3-batch
+	MatchHeadless m(match, ticksPerSec, seed);
+	if(!m.play())
+		throw std::runtime_error("Match was not finished");
+	ticks = match->getTick();
+
+	LOG_INFO(Match, "Worker: %s %d - %d %s\n", match->getTeam(0)->getName().c_str(),
+			match->getResult().HomeGoals, match->getResult().AwayGoals,
+			match->getTeam(1)->getName().c_str());
+	return Soccer::DataExchange::createMatchResultString(match->getResult());
+}
+
+void MatchWorker::listen(const char* path)
+{
+	int s = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(s == -1) {
+		perror("socket");
+		throw std::runtime_error("Could not create worker socket");
+	}
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	unlink(path);
+	if(bind(s, (struct sockaddr*)&addr, sizeof(addr)) == -1 || ::listen(s, 16) == -1) {
+		perror("bind");
+		close(s);
+		throw std::runtime_error(std::string("Could not listen on ") + path);
+	}
+
+	serveConnections(s, false);
+	close(s);
+	unlink(path);
+}
+
+void MatchWorker::listenTcp(const char* addr)
+{
+	std::string host;
+	std::string port(addr);
+	size_t colon = port.rfind(':');
+	if(colon != std::string::npos) {
+		host = port.substr(0, colon);
+		port = port.substr(colon + 1);
+	}
+
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	struct addrinfo* res;
+	int err = getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &res);
+	if(err)
+		throw std::runtime_error(std::string("Could not resolve ") + addr + ": " + gai_strerror(err));
+
+	int s = -1;
+	for(struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+		s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if(s == -1)
+			continue;
+		int one = 1;
+		setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if(bind(s, ai->ai_addr, ai->ai_addrlen) == 0 && ::listen(s, 16) == 0)
+			break;
+		close(s);
+		s = -1;
+	}
+	freeaddrinfo(res);
+	if(s == -1) {
+		perror("bind");
+		throw std::runtime_error(std::string("Could not listen on ") + addr);
+	}
+
+	LOG_INFO(Match, "Worker listening on %s\n", addr);
+	serveConnections(s, true);
+	close(s);
+}
+
+void MatchWorker::serveConnections(int s, bool tcp)
+{
+	bool quit = false;
+	while(!quit) {
+		int c = accept(s, NULL, NULL);
+		if(c == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("accept");
+			break;
+		}
+		if(tcp) {
+			int one = 1;
+			setsockopt(c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		}
+		try {
+			MatchWorker w(c, c);
+			quit = w.serve();
+		}
+		catch(std::exception& e) {
+			LOG_WARNING(Match, "Worker connection closed: %s\n", e.what());
+		}
+		close(c);
+	}
+}
+
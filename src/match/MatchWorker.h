@@ -0,0 +1,48 @@
+#ifndef MATCHWORKER_H
+#define MATCHWORKER_H
+
+#include <string>
+#include <vector>
+
+// Plays any number of matches requested over a file descriptor pair
+// without the GUI, so that batch drivers can keep a pool of worker
+// processes running instead of starting one process per match.
+//
+// Request:  "match <bytes> [-m sec] [-f FPS] [-s seed]\n" followed by
+//           <bytes> of match data, XML or binary
+// Response: "result <bytes> <ticks> <ms>\n" followed by the result
+//           record (see DataExchange::createMatchResultString), or
+//           "error <message>\n"
+// "quit\n" stops the worker.
+class MatchWorker {
+	public:
+		MatchWorker(int infd, int outfd);
+
+		// serves requests until the input is closed. Returns true if
+		// the peer asked the worker to quit.
+		bool serve();
+
+		// accepts connections on a Unix domain socket and serves them
+		// one at a time until a peer asks the worker to quit.
+		static void listen(const char* path);
+
+		// as above but on a TCP socket. addr is [host:]port.
+		static void listenTcp(const char* addr);
+
+	private:
+		static void serveConnections(int s, bool tcp);
+		bool readLine(std::string& line);
+		bool readBytes(std::string& buf, size_t n);
+		bool fill();
+		void writeAll(const std::string& s);
+		std::string playMatch(const std::string& data, const std::vector<std::string>& options,
+				unsigned int& ticks);
+
+		int mIn;
+		int mOut;
+		std::string mBuffer;
+		size_t mBufferPos;
+};
+
+#endif
+
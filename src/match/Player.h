@@ -53,6 +53,7 @@ class Player : public MatchEntity, public Soccer::Player {
 		bool isGoalkeeper() const;
 		float getTacticsWidthPosition() const;
 	private:
+		friend class MatchSnapshot;
 
 		Team* mTeam;
 		PlayerController* mController;
@@ -4,6 +4,8 @@
 
 #include "common/Math.h"
 
+#include "soccer/Log.h"
+
 #include "match/PlayerActions.h"
 #include "match/Match.h"
 #include "match/MatchHelpers.h"
@@ -65,7 +67,7 @@ void KickBallPA::applyPlayerAction(Match& match, Player& p, double time)
 		mDiff.normalize();
 
 	Vector3 v(mDiff);
-	printf("Kicking ball with %d%% power\n", (int)(v.length() * 100));
+	LOG_DEBUG(Match, "Kicking ball with %d%% power\n", (int)(v.length() * 100));
 	if(!MatchHelpers::ballInHeadingHeight(p)) {
 		v *= p.getMaximumShotPower();
 	}
@@ -4,14 +4,14 @@
 
 #include "common/Math.h"
 
+#include "soccer/Log.h"
+
 #include "match/MatchHelpers.h"
 #include "match/Referee.h"
 #include "match/RefereeActions.h"
 
 using Common::Vector3;
 
-// #define DEBUG_CONTROLLING_TEAM
-
 enum class BallOutStatus {
 	Throwin,
 	Goal,
@@ -46,9 +46,7 @@ boost::shared_ptr<RefereeAction> Referee::act(double time)
 			if(allPlayersOnOwnSideAndReady()) {
 				mFirstTeamInControl = mMatch->getMatchHalf() == MatchHalf::NotStarted ||
 					mMatch->getMatchHalf() == MatchHalf::FullTimePauseEnd;
-#ifdef DEBUG_CONTROLLING_TEAM
-				std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - match half\n";
-#endif
+				LOG_TRACE(Referee, "%d: First team in control: %d - match half\n", __LINE__, mFirstTeamInControl);
 				if(mFirstTeamInControl) {
 					if(mMatch->getMatchHalf() == MatchHalf::NotStarted)
 						return boost::shared_ptr<RefereeAction>(new ChangeMatchHalfRA(MatchHalf::FirstHalf));
@@ -206,7 +204,7 @@ void Referee::ballKicked(const Player& p)
 				mMatch->setPlayState(PlayState::InPlay);
 				mWaitForResumeClock.rewind();
 				mRestartedPlayer = &p;
-				std::cout << "Restart by " << p.getName() << "\n";
+				LOG_DEBUG(Referee, "Restart by %s\n", p.getName().c_str());
 			}
 		}
 		else {
@@ -214,11 +212,10 @@ void Referee::ballKicked(const Player& p)
 				mRestartPosition = p.getMatch()->getBall()->getPosition();
 				mRestartPosition.z = 0.0f;
 				mFirstTeamInControl = !p.getTeam()->isFirst();
-#ifdef DEBUG_CONTROLLING_TEAM
-				std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - indirect free kick\n";
-#endif
+				LOG_TRACE(Referee, "%d: First team in control: %d - indirect free kick\n", __LINE__, mFirstTeamInControl);
 				mPlayerInControl = nullptr;
-				std::cout << "Double touch by " << p.getName() << " - restart position: " << mRestartPosition << " by " << mFirstTeamInControl << "\n";
+				LOG_DEBUG(Referee, "Double touch by %s - restart position: %3.2f %3.2f by %d\n",
+						p.getName().c_str(), mRestartPosition.x, mRestartPosition.y, mFirstTeamInControl);
 				mOutOfPlayClock.rewind();
 				mMatch->setPlayState(PlayState::OutIndirectFreekick);
 			}
@@ -262,7 +259,7 @@ void Referee::addPenaltyShootoutResult()
 		switch(bst) {
 			case BallOutStatus::Goal:
 				mMatch->addPenaltyShootoutShot(true);
-				std::cout << "Penalty shoot out goal!\n";
+				LOG_INFO(Referee, "Penalty shoot out goal!\n");
 				break;
 
 			case BallOutStatus::Throwin:
@@ -270,7 +267,7 @@ void Referee::addPenaltyShootoutResult()
 			case BallOutStatus::GoalKick:
 			case BallOutStatus::OnPitch:
 				mMatch->addPenaltyShootoutShot(false);
-				std::cout << "Penalty shoot out miss!\n";
+				LOG_INFO(Referee, "Penalty shoot out miss!\n");
 				break;
 		}
 	}
@@ -280,6 +277,7 @@ boost::shared_ptr<RefereeAction> Referee::setOutOfPlay()
 {
 	BallOutStatus bst = getBallOutStatus();
 	RelVector3 bp(mMatch->convertAbsoluteToRelativeVector(mMatch->getBall()->getPosition()));
+	const Player* lastTouched = mPlayerInControl;
 
 	switch(bst) {
 		case BallOutStatus::Throwin:
@@ -289,9 +287,9 @@ boost::shared_ptr<RefereeAction> Referee::setOutOfPlay()
 				mRestartPosition.x = -mRestartPosition.x;
 			mRestartPosition.z = 0.0f;
 			mFirstTeamInControl = !mFirstTeamInControl;
-#ifdef DEBUG_CONTROLLING_TEAM
-			std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - throwin\n";
-#endif
+			LOG_TRACE(Referee, "%d: First team in control: %d - throwin\n", __LINE__, mFirstTeamInControl);
+			mMatch->addEvent(MatchEventType::BallOut, lastTouched, (int)PlayState::OutThrowin,
+					nullptr, mFirstTeamInControl ? 0 : 1);
 			mPlayerInControl = nullptr;
 			return boost::shared_ptr<RefereeAction>(new ChangePlayStateRA(PlayState::OutThrowin));
 
@@ -308,9 +306,9 @@ boost::shared_ptr<RefereeAction> Referee::setOutOfPlay()
 			}
 			mMatch->addGoal(firstscores);
 			mFirstTeamInControl = !firstscores;
-#ifdef DEBUG_CONTROLLING_TEAM
-			std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - goal\n";
-#endif
+			LOG_TRACE(Referee, "%d: First team in control: %d - goal\n", __LINE__, mFirstTeamInControl);
+			mMatch->addEvent(MatchEventType::BallOut, lastTouched, (int)PlayState::OutKickoff,
+					nullptr, mFirstTeamInControl ? 0 : 1);
 			mPlayerInControl = nullptr;
 			return boost::shared_ptr<RefereeAction>(new ChangePlayStateRA(PlayState::OutKickoff));
 
@@ -323,9 +321,9 @@ boost::shared_ptr<RefereeAction> Referee::setOutOfPlay()
 			mRestartPosition.y = Common::signum(bp.v.y) * mMatch->getPitchHeight() * 0.5f;
 			mRestartPosition.z = 0.0f;
 			mFirstTeamInControl = !mFirstTeamInControl;
-#ifdef DEBUG_CONTROLLING_TEAM
-			std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - corner kick\n";
-#endif
+			LOG_TRACE(Referee, "%d: First team in control: %d - corner kick\n", __LINE__, mFirstTeamInControl);
+			mMatch->addEvent(MatchEventType::BallOut, lastTouched, (int)PlayState::OutCornerkick,
+					nullptr, mFirstTeamInControl ? 0 : 1);
 			mPlayerInControl = nullptr;
 			return boost::shared_ptr<RefereeAction>(new ChangePlayStateRA(PlayState::OutCornerkick));
 
@@ -340,9 +338,9 @@ boost::shared_ptr<RefereeAction> Referee::setOutOfPlay()
 			}
 			mRestartPosition.z = 0.0f;
 			mFirstTeamInControl = !mFirstTeamInControl;
-#ifdef DEBUG_CONTROLLING_TEAM
-			std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - goal kick\n";
-#endif
+			LOG_TRACE(Referee, "%d: First team in control: %d - goal kick\n", __LINE__, mFirstTeamInControl);
+			mMatch->addEvent(MatchEventType::BallOut, lastTouched, (int)PlayState::OutGoalkick,
+					nullptr, mFirstTeamInControl ? 0 : 1);
 			mPlayerInControl = nullptr;
 			return boost::shared_ptr<RefereeAction>(new ChangePlayStateRA(PlayState::OutGoalkick));
 
@@ -357,9 +355,7 @@ boost::shared_ptr<RefereeAction> Referee::setFoulRestart()
 {
 	assert(mFouledTeam != 0);
 	mFirstTeamInControl = mFouledTeam == 2;
-#ifdef DEBUG_CONTROLLING_TEAM
-	std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - foul\n";
-#endif
+	LOG_TRACE(Referee, "%d: First team in control: %d - foul\n", __LINE__, mFirstTeamInControl);
 	mFouledTeam = 0;
 
 	mRestartPosition = mFoulPosition;
@@ -394,14 +390,10 @@ void Referee::matchHalfChanged(MatchHalf m)
 	mPlayerInControl = nullptr;
 	if(m == MatchHalf::HalfTimePauseEnd || m == MatchHalf::ExtraTimeSecondHalf) {
 		mFirstTeamInControl = false;
-#ifdef DEBUG_CONTROLLING_TEAM
-		std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - match half\n";
-#endif
+		LOG_TRACE(Referee, "%d: First team in control: %d - match half\n", __LINE__, mFirstTeamInControl);
 	} else if(m == MatchHalf::FullTimePauseEnd) {
 		mFirstTeamInControl = true;
-#ifdef DEBUG_CONTROLLING_TEAM
-		std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - extra time\n";
-#endif
+		LOG_TRACE(Referee, "%d: First team in control: %d - extra time\n", __LINE__, mFirstTeamInControl);
 	} else if(m == MatchHalf::PenaltyShootout) {
 		mRestartPosition.x = 0.0f;
 		mRestartPosition.y = 1.0f * (mMatch->getPitchHeight() * 0.5f - 11.00f);
@@ -418,9 +410,7 @@ const Player* Referee::getPlayerInControl() const
 void Referee::ballTouched(const Player& p)
 {
 	mFirstTeamInControl = p.getTeam()->isFirst();
-#ifdef DEBUG_CONTROLLING_TEAM
-	std::cout << __LINE__ << ": First team in control: " << mFirstTeamInControl << " - ball touched\n";
-#endif
+	LOG_TRACE(Referee, "%d: First team in control: %d - ball touched\n", __LINE__, mFirstTeamInControl);
 	mPlayerInControl = &p;
 }
 
@@ -29,6 +29,8 @@ class Referee {
 		void playerTackled(const Player& tackled, const Player& tacklee);
 
 	private:
+		friend class MatchSnapshot;
+
 		bool allPlayersOnOwnSideAndReady() const;
 		void ballTouched(const Player& p);
 		bool firstTeamAttacksUp() const;
@@ -0,0 +1,528 @@
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/copy.hpp>
+
+#include "common/Math.h"
+
+#include "soccer/Log.h"
+
+#include "match/Replay.h"
+#include "match/Match.h"
+
+using namespace Common;
+
+namespace {
+
+const char HeaderMagic[4] = { 'F', 'K', 'R', 'P' };
+const char FooterMagic[4] = { 'F', 'K', 'R', 'I' };
+const uint16_t ReplayVersion = 1;
+const size_t FooterSize = 20;
+
+enum FrameFields {
+	FieldMatchTime = 1 << 0,
+	FieldMatchHalf = 1 << 1,
+	FieldPlayState = 1 << 2,
+	FieldScore     = 1 << 3,
+	FieldPenalties = 1 << 4,
+	FieldInControl = 1 << 5
+};
+
+enum EntityFields {
+	FieldX           = 1 << 0,
+	FieldY           = 1 << 1,
+	FieldZ           = 1 << 2,
+	FieldOrientation = 1 << 3,
+	FieldSpeed       = 1 << 4,
+	FieldState       = 1 << 5
+};
+
+void putVarint(std::string& s, uint32_t v)
+{
+	while(v >= 0x80) {
+		s += char(v | 0x80);
+		v >>= 7;
+	}
+	s += char(v);
+}
+
+void putSigned(std::string& s, int32_t v)
+{
+	putVarint(s, (uint32_t(v) << 1) ^ uint32_t(v >> 31));
+}
+
+uint32_t getVarint(const std::string& s, size_t& pos)
+{
+	uint32_t v = 0;
+	for(int shift = 0; shift < 35; shift += 7) {
+		if(pos >= s.size())
+			throw std::runtime_error("Replay: truncated frame");
+		uint8_t b = s[pos++];
+		v |= uint32_t(b & 0x7f) << shift;
+		if(!(b & 0x80))
+			return v;
+	}
+	throw std::runtime_error("Replay: invalid varint");
+}
+
+int32_t getSigned(const std::string& s, size_t& pos)
+{
+	uint32_t v = getVarint(s, pos);
+	return int32_t(v >> 1) ^ -int32_t(v & 1);
+}
+
+uint8_t getByte(const std::string& s, size_t& pos)
+{
+	if(pos >= s.size())
+		throw std::runtime_error("Replay: truncated frame");
+	return s[pos++];
+}
+
+void encodeEntity(std::string& s, const ReplayEntity& e, const ReplayEntity& p)
+{
+	uint8_t mask = (e.X != p.X ? FieldX : 0) |
+		(e.Y != p.Y ? FieldY : 0) |
+		(e.Z != p.Z ? FieldZ : 0) |
+		(e.Orientation != p.Orientation ? FieldOrientation : 0) |
+		(e.Speed != p.Speed ? FieldSpeed : 0) |
+		(e.State != p.State ? FieldState : 0);
+	s += char(mask);
+	if(mask & FieldX)
+		putSigned(s, e.X - p.X);
+	if(mask & FieldY)
+		putSigned(s, e.Y - p.Y);
+	if(mask & FieldZ)
+		putSigned(s, e.Z - p.Z);
+	if(mask & FieldOrientation)
+		putSigned(s, int8_t(e.Orientation - p.Orientation));
+	if(mask & FieldSpeed)
+		putSigned(s, e.Speed - p.Speed);
+	if(mask & FieldState)
+		s += char(e.State);
+}
+
+void decodeEntity(const std::string& s, size_t& pos, ReplayEntity& e)
+{
+	uint8_t mask = getByte(s, pos);
+	if(mask & FieldX)
+		e.X += getSigned(s, pos);
+	if(mask & FieldY)
+		e.Y += getSigned(s, pos);
+	if(mask & FieldZ)
+		e.Z += getSigned(s, pos);
+	if(mask & FieldOrientation)
+		e.Orientation += getSigned(s, pos);
+	if(mask & FieldSpeed)
+		e.Speed += getSigned(s, pos);
+	if(mask & FieldState)
+		e.State = getByte(s, pos);
+}
+
+// A keyframe is encoded against a zeroed frame.
+void encodeFrame(std::string& s, const ReplayFrame& f, const ReplayFrame& p,
+		const unsigned int* numPlayers)
+{
+	putVarint(s, f.Tick - p.Tick);
+	putVarint(s, f.ReplayTime - p.ReplayTime);
+	uint8_t mask = (f.MatchTime != p.MatchTime ? FieldMatchTime : 0) |
+		(f.MatchHalf != p.MatchHalf ? FieldMatchHalf : 0) |
+		(f.PlayState != p.PlayState ? FieldPlayState : 0) |
+		(memcmp(f.Score, p.Score, sizeof(f.Score)) ? FieldScore : 0) |
+		(memcmp(f.Penalties, p.Penalties, sizeof(f.Penalties)) ? FieldPenalties : 0) |
+		(f.PlayerInControl != p.PlayerInControl ? FieldInControl : 0);
+	s += char(mask);
+	if(mask & FieldMatchTime)
+		putSigned(s, int32_t(f.MatchTime - p.MatchTime));
+	if(mask & FieldMatchHalf)
+		s += char(f.MatchHalf);
+	if(mask & FieldPlayState)
+		s += char(f.PlayState);
+	if(mask & FieldScore) {
+		s += char(f.Score[0]);
+		s += char(f.Score[1]);
+	}
+	if(mask & FieldPenalties) {
+		s += char(f.Penalties[0]);
+		s += char(f.Penalties[1]);
+	}
+	if(mask & FieldInControl)
+		s += char(f.PlayerInControl);
+
+	encodeEntity(s, f.Ball, p.Ball);
+	for(unsigned int i = 0; i < 2; i++)
+		for(unsigned int j = 0; j < numPlayers[i]; j++)
+			encodeEntity(s, f.Players[i][j], p.Players[i][j]);
+}
+
+void decodeFrame(const std::string& s, size_t& pos, ReplayFrame& f,
+		const unsigned int* numPlayers)
+{
+	f.Tick += getVarint(s, pos);
+	f.ReplayTime += getVarint(s, pos);
+	uint8_t mask = getByte(s, pos);
+	if(mask & FieldMatchTime)
+		f.MatchTime += getSigned(s, pos);
+	if(mask & FieldMatchHalf)
+		f.MatchHalf = getByte(s, pos);
+	if(mask & FieldPlayState)
+		f.PlayState = getByte(s, pos);
+	if(mask & FieldScore) {
+		f.Score[0] = getByte(s, pos);
+		f.Score[1] = getByte(s, pos);
+	}
+	if(mask & FieldPenalties) {
+		f.Penalties[0] = getByte(s, pos);
+		f.Penalties[1] = getByte(s, pos);
+	}
+	if(mask & FieldInControl)
+		f.PlayerInControl = getByte(s, pos);
+
+	decodeEntity(s, pos, f.Ball);
+	for(unsigned int i = 0; i < 2; i++)
+		for(unsigned int j = 0; j < numPlayers[i]; j++)
+			decodeEntity(s, pos, f.Players[i][j]);
+}
+
+int16_t quantizePosition(float v)
+{
+	return clamp(-32767.0f, roundf(v * 100.0f), 32767.0f);
+}
+
+void fillEntity(ReplayEntity& e, const Vector3& pos, const Vector3& vel)
+{
+	e.X = quantizePosition(pos.x);
+	e.Y = quantizePosition(pos.y);
+	e.Z = quantizePosition(pos.z);
+	float speed = sqrt(vel.x * vel.x + vel.y * vel.y);
+	e.Orientation = speed ? int(roundf(atan2(vel.y, vel.x) * 128.0f / PI)) & 0xff : 0;
+	e.Speed = std::min(255.0f, ceilf(speed * 10.0f));
+}
+
+template<typename T>
+void writeValue(std::ostream& out, T v)
+{
+	for(unsigned int i = 0; i < sizeof(T); i++) {
+		out.put(char(v & 0xff));
+		v >>= 8;
+	}
+}
+
+template<typename T>
+T readValue(std::istream& in)
+{
+	T v = 0;
+	for(unsigned int i = 0; i < sizeof(T); i++) {
+		int c = in.get();
+		if(c == EOF)
+			throw std::runtime_error("Replay: unexpected end of file");
+		v |= T(c & 0xff) << (i * 8);
+	}
+	return v;
+}
+
+}
+
+ReplayRecorder::ReplayRecorder(const char* filename, unsigned int keyframeInterval)
+	: mFile(filename, std::ios::out | std::ios::binary | std::ios::trunc),
+	mKeyframeInterval(std::max(1u, keyframeInterval)),
+	mHeaderWritten(false),
+	mNumFrames(0),
+	mReplayTime(0.0),
+	mQuit(false)
+{
+	if(!mFile.good())
+		throw std::runtime_error(std::string("Could not open replay file ") + filename);
+	mNumPlayers[0] = mNumPlayers[1] = 0;
+	memset(&mPrevious, 0, sizeof(mPrevious));
+	mThread = std::thread(&ReplayRecorder::run, this);
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+	finish();
+}
+
+void ReplayRecorder::setNumPlayers(unsigned int team, unsigned int num)
+{
+	if(mHeaderWritten)
+		throw std::runtime_error("Replay: player count changed during recording");
+	mNumPlayers[team] = std::min(num, MaxReplayPlayers);
+}
+
+void ReplayRecorder::record(const Match& m, double frameTime)
+{
+	ReplayFrame f;
+	memset(&f, 0, sizeof(f));
+	mReplayTime += frameTime;
+
+	f.Tick = m.getTick();
+	f.ReplayTime = mReplayTime * 1000.0;
+	f.MatchTime = m.getTime() * 60000.0;
+	f.MatchHalf = (uint8_t)m.getMatchHalf();
+	f.PlayState = (uint8_t)m.getPlayState();
+	f.Score[0] = m.getScore(true);
+	f.Score[1] = m.getScore(false);
+	f.Penalties[0] = m.getPenaltyShootout().getScore(true);
+	f.Penalties[1] = m.getPenaltyShootout().getScore(false);
+
+	const Ball* b = m.getBall();
+	fillEntity(f.Ball, b->getPosition(), b->getVelocity());
+	if(b->grabbed())
+		f.Ball.State |= ReplayEntity::Grabbed;
+
+	const Player* inControl = m.getReferee()->getPlayerInControl();
+	for(unsigned int i = 0; i < 2; i++) {
+		for(unsigned int j = 0; j < MaxReplayPlayers; j++) {
+			const Player* p = m.getPlayer(i, j);
+			if(!p)
+				break;
+			if(!mHeaderWritten)
+				mNumPlayers[i] = j + 1;
+			else if(j >= mNumPlayers[i])
+				break;
+			ReplayEntity& e = f.Players[i][j];
+			fillEntity(e, p->getPosition(), p->getVelocity());
+			if(!p->standing())
+				e.State |= ReplayEntity::Fallen;
+			if(p->tackling())
+				e.State |= ReplayEntity::Tackling;
+			if(p == inControl)
+				f.PlayerInControl = i * MaxReplayPlayers + j + 1;
+		}
+	}
+
+	addFrame(f);
+}
+
+void ReplayRecorder::addFrame(const ReplayFrame& f)
+{
+	if(!mHeaderWritten) {
+		writeHeader();
+		mHeaderWritten = true;
+	}
+
+	if(mNumFrames % mKeyframeInterval == 0) {
+		flushBlock();
+		mBlockEntry.Frame = mNumFrames;
+		mBlockEntry.ReplayTime = f.ReplayTime;
+		memset(&mPrevious, 0, sizeof(mPrevious));
+	}
+	encodeFrame(mBlock, f, mPrevious, mNumPlayers);
+	mPrevious = f;
+	mNumFrames++;
+}
+
+void ReplayRecorder::writeHeader()
+{
+	mFile.write(HeaderMagic, sizeof(HeaderMagic));
+	writeValue<uint16_t>(mFile, ReplayVersion);
+	writeValue<uint8_t>(mFile, mNumPlayers[0]);
+	writeValue<uint8_t>(mFile, mNumPlayers[1]);
+	writeValue<uint32_t>(mFile, mKeyframeInterval);
+}
+
+void ReplayRecorder::flushBlock()
+{
+	if(mBlock.empty())
+		return;
+	PendingBlock b;
+	b.Data.swap(mBlock);
+	b.Entry = mBlockEntry;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mPending.push_back(std::move(b));
+	}
+	mBlockAvailable.notify_one();
+	mBlock.reserve(mKeyframeInterval * 128);
+}
+
+void ReplayRecorder::run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(1) {
+		while(mPending.empty() && !mQuit)
+			mBlockAvailable.wait(lock);
+		if(mPending.empty() && mQuit)
+			break;
+
+		PendingBlock b = std::move(mPending.front());
+		mPending.pop_front();
+		lock.unlock();
+
+		std::string compressed;
+		{
+			boost::iostreams::filtering_ostream out;
+			out.push(boost::iostreams::bzip2_compressor());
+			out.push(boost::iostreams::back_inserter(compressed));
+			out.write(b.Data.data(), b.Data.size());
+		}
+		b.Entry.Offset = mFile.tellp();
+		b.Entry.Size = compressed.size();
+		mFile.write(compressed.data(), compressed.size());
+		mIndex.push_back(b.Entry);
+
+		lock.lock();
+	}
+}
+
+void ReplayRecorder::finish()
+{
+	if(!mThread.joinable())
+		return;
+	flushBlock();
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mBlockAvailable.notify_one();
+	mThread.join();
+
+	if(!mHeaderWritten)
+		writeHeader();
+	uint64_t indexOffset = mFile.tellp();
+	for(const auto& e : mIndex) {
+		writeValue<uint32_t>(mFile, e.Frame);
+		writeValue<uint32_t>(mFile, e.ReplayTime);
+		writeValue<uint64_t>(mFile, e.Offset);
+		writeValue<uint32_t>(mFile, e.Size);
+	}
+	writeValue<uint32_t>(mFile, mNumFrames);
+	writeValue<uint32_t>(mFile, mIndex.size());
+	writeValue<uint64_t>(mFile, indexOffset);
+	mFile.write(FooterMagic, sizeof(FooterMagic));
+	mFile.close();
+
+	LOG_INFO(Match, "Replay: %u frames in %lu blocks, %lu bytes\n", mNumFrames,
+			mIndex.size(), (unsigned long)indexOffset);
+}
+
+ReplayReader::ReplayReader(const char* filename)
+	: mFile(filename, std::ios::in | std::ios::binary),
+	mNumFrames(0),
+	mBlockPos(0),
+	mCurrentBlock(0),
+	mHasNext(false)
+{
+	if(!mFile.good())
+		throw std::runtime_error(std::string("Could not open replay file ") + filename);
+
+	char magic[4];
+	mFile.read(magic, sizeof(magic));
+	if(!mFile.good() || memcmp(magic, HeaderMagic, sizeof(magic)))
+		throw std::runtime_error("Replay: not a replay file");
+	if(readValue<uint16_t>(mFile) != ReplayVersion)
+		throw std::runtime_error("Replay: unsupported version");
+	mNumPlayers[0] = std::min<unsigned int>(readValue<uint8_t>(mFile), MaxReplayPlayers);
+	mNumPlayers[1] = std::min<unsigned int>(readValue<uint8_t>(mFile), MaxReplayPlayers);
+
+	mFile.seekg(-(std::streamoff)FooterSize, std::ios::end);
+	mNumFrames = readValue<uint32_t>(mFile);
+	uint32_t numBlocks = readValue<uint32_t>(mFile);
+	uint64_t indexOffset = readValue<uint64_t>(mFile);
+	mFile.read(magic, sizeof(magic));
+	if(!mFile.good() || memcmp(magic, FooterMagic, sizeof(magic)))
+		throw std::runtime_error("Replay: missing index - the recording was not finished");
+
+	mFile.seekg(indexOffset);
+	for(uint32_t i = 0; i < numBlocks; i++) {
+		ReplayIndexEntry e;
+		e.Frame = readValue<uint32_t>(mFile);
+		e.ReplayTime = readValue<uint32_t>(mFile);
+		e.Offset = readValue<uint64_t>(mFile);
+		e.Size = readValue<uint32_t>(mFile);
+		mIndex.push_back(e);
+	}
+	if(mIndex.empty())
+		throw std::runtime_error("Replay: no frames");
+
+	seek(0.0f);
+}
+
+unsigned int ReplayReader::getNumPlayers(unsigned int team) const
+{
+	return mNumPlayers[team];
+}
+
+unsigned int ReplayReader::getNumFrames() const
+{
+	return mNumFrames;
+}
+
+float ReplayReader::getLength() const
+{
+	return mIndex.back().ReplayTime / 1000.0f;
+}
+
+const ReplayFrame& ReplayReader::getFrame() const
+{
+	return mFrame;
+}
+
+float ReplayReader::getTime() const
+{
+	return mFrame.ReplayTime / 1000.0f;
+}
+
+void ReplayReader::loadBlock(unsigned int i)
+{
+	const ReplayIndexEntry& e = mIndex[i];
+	std::string compressed(e.Size, '\0');
+	mFile.clear();
+	mFile.seekg(e.Offset);
+	mFile.read(&compressed[0], e.Size);
+	if(!mFile.good())
+		throw std::runtime_error("Replay: could not read block");
+
+	mBlock.clear();
+	boost::iostreams::filtering_istream in;
+	in.push(boost::iostreams::bzip2_decompressor());
+	in.push(boost::iostreams::array_source(compressed.data(), compressed.size()));
+	boost::iostreams::copy(in, boost::iostreams::back_inserter(mBlock));
+
+	mCurrentBlock = i;
+	mBlockPos = 0;
+	memset(&mNext, 0, sizeof(mNext));
+}
+
+bool ReplayReader::readNext()
+{
+	if(mBlockPos >= mBlock.size()) {
+		if(mCurrentBlock + 1 >= mIndex.size())
+			return false;
+		loadBlock(mCurrentBlock + 1);
+	}
+	decodeFrame(mBlock, mBlockPos, mNext, mNumPlayers);
+	return true;
+}
+
+void ReplayReader::seek(float t)
+{
+	uint32_t ms = std::max(0.0f, t * 1000.0f);
+	auto it = std::upper_bound(mIndex.begin(), mIndex.end(), ms,
+			[](uint32_t v, const ReplayIndexEntry& e) { return v < e.ReplayTime; });
+	if(it != mIndex.begin())
+		--it;
+	loadBlock(it - mIndex.begin());
+	readNext();
+	mFrame = mNext;
+	mHasNext = readNext();
+	advance(t);
+}
+
+bool ReplayReader::advance(float t)
+{
+	uint32_t ms = std::max(0.0f, t * 1000.0f);
+	while(mHasNext && mNext.ReplayTime <= ms) {
+		mFrame = mNext;
+		mHasNext = readNext();
+	}
+	return mHasNext;
+}
+
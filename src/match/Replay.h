@@ -0,0 +1,135 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+class Match;
+
+static const unsigned int MaxReplayPlayers = 16;
+
+// Positions are stored in centimetres, the orientation in 1/256 of a full
+// turn and the speed in 0.1 m/s.
+struct ReplayEntity {
+	enum StateFlags {
+		Fallen   = 1 << 0,
+		Tackling = 1 << 1,
+		Grabbed  = 1 << 2
+	};
+
+	int16_t X;
+	int16_t Y;
+	int16_t Z;
+	uint8_t Orientation;
+	uint8_t Speed;
+	uint8_t State;
+};
+
+struct ReplayFrame {
+	uint32_t Tick;
+	uint32_t ReplayTime;	// milliseconds since the start of the recording
+	uint32_t MatchTime;	// match time within the half in milliseconds
+	uint8_t MatchHalf;
+	uint8_t PlayState;
+	uint8_t Score[2];
+	uint8_t Penalties[2];
+	uint8_t PlayerInControl;	// team * MaxReplayPlayers + index + 1, 0 if none
+	ReplayEntity Ball;
+	ReplayEntity Players[2][MaxReplayPlayers];
+};
+
+struct ReplayIndexEntry {
+	uint32_t Frame;
+	uint32_t ReplayTime;
+	uint64_t Offset;
+	uint32_t Size;
+};
+
+// File layout:
+// header: "FKRP", version, player counts, keyframe interval
+// blocks: bzip2 compressed, each one starts with a keyframe followed
+//         by frames delta encoded against their predecessor
+// index:  one ReplayIndexEntry per block
+// footer: number of frames, number of blocks, index offset, "FKRI"
+//
+// Frames are collected on the match thread, blocks are compressed and
+// written on a separate thread.
+class ReplayRecorder {
+	public:
+		ReplayRecorder(const char* filename, unsigned int keyframeInterval = 512);
+		~ReplayRecorder();
+		void record(const Match& m, double frameTime);
+		void addFrame(const ReplayFrame& f);
+		void finish();
+		void setNumPlayers(unsigned int team, unsigned int num);
+
+	private:
+		void writeHeader();
+		void flushBlock();
+		void run();
+
+		struct PendingBlock {
+			std::string Data;
+			ReplayIndexEntry Entry;
+		};
+
+		std::ofstream mFile;
+		unsigned int mKeyframeInterval;
+		unsigned int mNumPlayers[2];
+		bool mHeaderWritten;
+		uint32_t mNumFrames;
+		double mReplayTime;
+		ReplayFrame mPrevious;
+		std::string mBlock;
+		ReplayIndexEntry mBlockEntry;
+		std::vector<ReplayIndexEntry> mIndex;
+
+		std::mutex mMutex;
+		std::condition_variable mBlockAvailable;
+		std::deque<PendingBlock> mPending;
+		bool mQuit;
+		std::thread mThread;
+};
+
+class ReplayReader {
+	public:
+		ReplayReader(const char* filename);
+		unsigned int getNumPlayers(unsigned int team) const;
+		unsigned int getNumFrames() const;
+		float getLength() const;	// in seconds
+		const ReplayFrame& getFrame() const;
+		float getTime() const;
+
+		// jumps to the last frame at or before t seconds. Only the block
+		// containing the frame is decoded.
+		void seek(float t);
+
+		// moves forward to the last frame at or before t seconds.
+		// Returns false if the end of the replay has been reached.
+		bool advance(float t);
+
+	private:
+		void loadBlock(unsigned int i);
+		bool readNext();
+
+		std::ifstream mFile;
+		unsigned int mNumPlayers[2];
+		uint32_t mNumFrames;
+		std::vector<ReplayIndexEntry> mIndex;
+		std::string mBlock;
+		size_t mBlockPos;
+		unsigned int mCurrentBlock;
+		ReplayFrame mFrame;
+		ReplayFrame mNext;
+		bool mHasNext;
+};
+
+#endif
+
@@ -0,0 +1,101 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <stddef.h>
+
+#include <array>
+#include <atomic>
+
+// Lock-free fixed size queue for exactly one producer and one consumer.
+// The producer never blocks: if the consumer can't keep up, new elements
+// are dropped and counted.
+template<typename T, size_t N>
+class RingBuffer {
+	static_assert(N && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+	public:
+		RingBuffer();
+		bool push(const T& t);
+		bool pop(T& t);
+		template<typename F> size_t consume(F f);
+		size_t size() const;
+		bool empty() const;
+		unsigned long dropped() const;
+
+	private:
+		std::array<T, N> mData;
+		char mPad0[64];
+		std::atomic<size_t> mHead; // written by producer
+		char mPad1[64];
+		std::atomic<size_t> mTail; // written by consumer
+		char mPad2[64];
+		std::atomic<unsigned long> mDropped;
+};
+
+template<typename T, size_t N>
+RingBuffer<T, N>::RingBuffer()
+	: mHead(0),
+	mTail(0),
+	mDropped(0)
+{
+}
+
+template<typename T, size_t N>
+bool RingBuffer<T, N>::push(const T& t)
+{
+	size_t head = mHead.load(std::memory_order_relaxed);
+	if(head - mTail.load(std::memory_order_acquire) >= N) {
+		mDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	mData[head & (N - 1)] = t;
+	mHead.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, size_t N>
+bool RingBuffer<T, N>::pop(T& t)
+{
+	size_t tail = mTail.load(std::memory_order_relaxed);
+	if(tail == mHead.load(std::memory_order_acquire))
+		return false;
+	t = mData[tail & (N - 1)];
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+// Calls f(const T&) for every queued element in place and then releases
+// them all at once. Returns the number of elements consumed.
+template<typename T, size_t N>
+template<typename F>
+size_t RingBuffer<T, N>::consume(F f)
+{
+	size_t tail = mTail.load(std::memory_order_relaxed);
+	size_t head = mHead.load(std::memory_order_acquire);
+	for(size_t i = tail; i != head; i++)
+		f(mData[i & (N - 1)]);
+	mTail.store(head, std::memory_order_release);
+	return head - tail;
+}
+
+template<typename T, size_t N>
+size_t RingBuffer<T, N>::size() const
+{
+	size_t tail = mTail.load(std::memory_order_acquire);
+	return mHead.load(std::memory_order_acquire) - tail;
+}
+
+template<typename T, size_t N>
+bool RingBuffer<T, N>::empty() const
+{
+	return size() == 0;
+}
+
+template<typename T, size_t N>
+unsigned long RingBuffer<T, N>::dropped() const
+{
+	return mDropped.load(std::memory_order_relaxed);
+}
+
+#endif
+
@@ -33,8 +33,8 @@ Team::Team(Match* match, const Soccer::StatefulTeam& t, bool first)
 
 void Team::addPlayer(const Soccer::Player& pl)
 {
-	const auto it = mTactics.mTactics.find(pl.getId());
-	assert(it != mTactics.mTactics.end());
+	const auto it = mTactics->mTactics.find(pl.getId());
+	assert(it != mTactics->mTactics.end());
 	boost::shared_ptr<Player> p(new Player(mMatch, this, pl, mPlayers.size() + 1, it->second));
 	mPlayers.push_back(p);
 }
@@ -49,6 +49,9 @@ class Team : public Soccer::StatefulTeam {
 		float calculatePassScoreAt(const std::vector<boost::shared_ptr<Player>>& offensivePlayers,
 				const Common::Vector3& pos) const;
 		void getSupportPositionCoordinates(const Common::Vector3& pos, unsigned int& i, unsigned int& j) const;
+
+		friend class MatchSnapshot;
+
 		Match* mMatch;
 		bool mFirst;
 		std::vector<boost::shared_ptr<Player>> mPlayers;
@@ -4,6 +4,8 @@
 
 #include "common/Math.h"
 
+#include "soccer/Log.h"
+
 #include "match/ai/AIActions.h"
 #include "match/ai/AIHelpers.h"
 #include "match/MatchHelpers.h"
@@ -27,13 +29,23 @@ AIActionChooser::AIActionChooser(const std::vector<boost::shared_ptr<AIAction>>&
 		}
 	}
 	// printf(" => %s\n", mBestAction->getName());
-	if(debug || bestscore <= 0.0f) {
-		printf("%sbest score is %3.3f for %s\n",
-				debug ? "" : "Warning: ", bestscore, mBestAction->getName());
-		for(auto a : actions) {
-			double thisscore = a->getScore();
-			printf("Action: %10s: %3.3f\n", a->getName(), thisscore);
-		}
+	if(bestscore <= 0.0f) {
+		LOG_WARNING(AI, "Warning: best score is %3.3f for %s\n",
+				bestscore, mBestAction->getName());
+		dumpActions(actions, Soccer::LogLevel::Warning);
+	}
+	else if(debug && LOG_ENABLED(AI, Trace)) {
+		LOG_TRACE(AI, "best score is %3.3f for %s\n", bestscore, mBestAction->getName());
+		dumpActions(actions, Soccer::LogLevel::Trace);
+	}
+}
+
+void AIActionChooser::dumpActions(const std::vector<boost::shared_ptr<AIAction>>& actions,
+		Soccer::LogLevel level)
+{
+	for(auto a : actions) {
+		Soccer::Log::write(Soccer::LogCategory::AI, level, "Action: %10s: %3.3f\n",
+				a->getName(), a->getScore());
 	}
 }
 
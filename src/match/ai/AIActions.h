@@ -5,6 +5,8 @@
 #include <boost/shared_ptr.hpp>
 #include <vector>
 
+#include "soccer/Log.h"
+
 #include "match/Player.h"
 #include "match/PlayerActions.h"
 
@@ -16,6 +18,8 @@ class AIActionChooser {
 				bool debug);
 		boost::shared_ptr<AIAction> getBestAction();
 	private:
+		static void dumpActions(const std::vector<boost::shared_ptr<AIAction>>& actions,
+				Soccer::LogLevel level);
 		boost::shared_ptr<AIAction> mBestAction;
 };
 
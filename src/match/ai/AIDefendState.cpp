@@ -12,6 +12,14 @@ AIDefendState::AIDefendState(Player* p, AIPlayController* m)
 {
 }
 
+boost::shared_ptr<AIState> AIDefendState::clone(Player* p, AIPlayController* m) const
+{
+	AIDefendState* s = new AIDefendState(*this);
+	s->mPlayer = p;
+	s->mPlayController = m;
+	return boost::shared_ptr<AIState>(s);
+}
+
 boost::shared_ptr<PlayerAction> AIDefendState::actOffBall(double time)
 {
 	switch(mPlayer->getPlayerPosition()) {
@@ -15,6 +15,14 @@ AIGoalkeeperState::AIGoalkeeperState(Player* p, AIPlayController* m)
 	setPivotPoint();
 }
 
+boost::shared_ptr<AIState> AIGoalkeeperState::clone(Player* p, AIPlayController* m) const
+{
+	AIGoalkeeperState* s = new AIGoalkeeperState(*this);
+	s->mPlayer = p;
+	s->mPlayController = m;
+	return boost::shared_ptr<AIState>(s);
+}
+
 boost::shared_ptr<PlayerAction> AIGoalkeeperState::actOnBall(double time)
 {
 	if(mPlayer->getMatch()->getBall()->grabbed() && mPlayer->getMatch()->getBall()->getGrabber() == mPlayer) {
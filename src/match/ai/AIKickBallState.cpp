@@ -9,6 +9,14 @@ AIKickBallState::AIKickBallState(Player* p, AIPlayController* m)
 {
 }
 
+boost::shared_ptr<AIState> AIKickBallState::clone(Player* p, AIPlayController* m) const
+{
+	AIKickBallState* s = new AIKickBallState(*this);
+	s->mPlayer = p;
+	s->mPlayController = m;
+	return boost::shared_ptr<AIState>(s);
+}
+
 boost::shared_ptr<PlayerAction> AIKickBallState::actOnBall(double time)
 {
 	std::vector<boost::shared_ptr<AIAction>> actions;
@@ -42,7 +50,7 @@ boost::shared_ptr<PlayerAction> AIKickBallState::actOnBall(double time)
 
 	boost::shared_ptr<AIAction> best = actionchooser.getBestAction();
 	mDescription = std::string("Kicking ") + std::to_string(best->getScore()) + " - " + best->getName();
-	std::cout << "Kicking - " << mDescription << "\n";
+	LOG_DEBUG(AI, "Kicking - %s\n", mDescription.c_str());
 	return best->getAction();
 }
 
@@ -10,6 +10,14 @@ AIMidfielderState::AIMidfielderState(Player* p, AIPlayController* m)
 {
 }
 
+boost::shared_ptr<AIState> AIMidfielderState::clone(Player* p, AIPlayController* m) const
+{
+	AIMidfielderState* s = new AIMidfielderState(*this);
+	s->mPlayer = p;
+	s->mPlayController = m;
+	return boost::shared_ptr<AIState>(s);
+}
+
 boost::shared_ptr<PlayerAction> AIMidfielderState::actOffBall(double time)
 {
 	bool oppAtt = AIHelpers::opponentAttacking(*mPlayer);
@@ -10,6 +10,14 @@ AIOffensiveState::AIOffensiveState(Player* p, AIPlayController* m)
 {
 }
 
+boost::shared_ptr<AIState> AIOffensiveState::clone(Player* p, AIPlayController* m) const
+{
+	AIOffensiveState* s = new AIOffensiveState(*this);
+	s->mPlayer = p;
+	s->mPlayController = m;
+	return boost::shared_ptr<AIState>(s);
+}
+
 boost::shared_ptr<PlayerAction> AIOffensiveState::actOffBall(double time)
 {
 	bool oppAtt = AIHelpers::opponentAttacking(*mPlayer);
@@ -21,6 +21,8 @@ class AIPlayController : public PlayerController {
 		boost::shared_ptr<PlayerAction> actOnRestart(double time);
 		void matchHalfChanged(MatchHalf m);
 	private:
+		friend class MatchSnapshot;
+
 		boost::shared_ptr<AIState> mCurrentState;
 };
 
@@ -33,6 +35,8 @@ class AIState {
 		virtual boost::shared_ptr<PlayerAction> actOffBall(double time) = 0;
 		const std::string& getDescription() const;
 		virtual void matchHalfChanged(MatchHalf m) { }
+		// copies the state for the given player and controller
+		virtual boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const = 0;
 		bool checkBlockedMatchTimer(double time);
 		void blockedMatch();
 
@@ -50,6 +54,7 @@ class AIState {
 class AIGoalkeeperState : public AIState {
 	public:
 		AIGoalkeeperState(Player* p, AIPlayController* m);
+		boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const override;
 		boost::shared_ptr<PlayerAction> actOnBall(double time) override;
 		boost::shared_ptr<PlayerAction> actNearBall(double time) override;
 		boost::shared_ptr<PlayerAction> actOffBall(double time) override;
@@ -67,12 +72,14 @@ class AIGoalkeeperState : public AIState {
 class AIDefendState : public AIState {
 	public:
 		AIDefendState(Player* p, AIPlayController* m);
+		boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const override;
 		boost::shared_ptr<PlayerAction> actOffBall(double time) override;
 };
 
 class AIKickBallState : public AIState {
 	public:
 		AIKickBallState(Player* p, AIPlayController* m);
+		boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const override;
 		boost::shared_ptr<PlayerAction> actOnBall(double time) override;
 		boost::shared_ptr<PlayerAction> actNearBall(double time) override;
 		boost::shared_ptr<PlayerAction> actOffBall(double time) override;
@@ -81,12 +88,14 @@ class AIKickBallState : public AIState {
 class AIOffensiveState : public AIState {
 	public:
 		AIOffensiveState(Player* p, AIPlayController* m);
+		boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const override;
 		boost::shared_ptr<PlayerAction> actOffBall(double time) override;
 };
 
 class AIMidfielderState : public AIState {
 	public:
 		AIMidfielderState(Player* p, AIPlayController* m);
+		boost::shared_ptr<AIState> clone(Player* p, AIPlayController* m) const override;
 		boost::shared_ptr<PlayerAction> actOffBall(double time) override;
 };
 
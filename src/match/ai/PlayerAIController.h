@@ -15,6 +15,8 @@ class PlayerAIController : public PlayerController {
 	protected:
 		boost::shared_ptr<PlayerAction> createMoveActionTo(const Common::Vector3& pos) const;
 	private:
+		friend class MatchSnapshot;
+
 		boost::shared_ptr<PlayerAction> actOffPlay(double time);
 		boost::shared_ptr<PlayerAction> doRestart(double time);
 		boost::shared_ptr<PlayerAction> gotoKickPositionOrKick(double time, const Common::Vector3& pos);
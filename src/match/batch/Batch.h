@@ -0,0 +1,19 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "soccer/Match.h"
+
+struct BatchJob {
+	unsigned int File;
+	int Seed;
+};
+
+struct BatchResult {
+	bool Played;
+	Soccer::MatchResult Result;
+	double Duration;
+	unsigned int Ticks;
+};
+
+#endif
+
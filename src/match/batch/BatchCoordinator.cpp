@@ -0,0 +1,220 @@
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Log.h"
+
+#include "match/batch/BatchCoordinator.h"
+
+BatchCoordinator::BatchCoordinator(const std::vector<std::string>& workers,
+		int ticksPerSec, double seconds)
+	: mTicksPerSec(ticksPerSec),
+	mSeconds(seconds)
+{
+	for(auto& addr : workers) {
+		int fd = connectTo(addr);
+		if(fd == -1) {
+			LOG_WARNING(Simulation, "Could not connect to worker %s\n", addr.c_str());
+			continue;
+		}
+		Worker w;
+		w.Address = addr;
+		w.Fd = fd;
+		mWorkers.push_back(w);
+	}
+	if(mWorkers.empty())
+		throw std::runtime_error("Could not connect to any worker");
+	LOG_INFO(Simulation, "Connected to %zu workers\n", mWorkers.size());
+}
+
+BatchCoordinator::~BatchCoordinator()
+{
+	for(auto& w : mWorkers)
+		close(w.Fd);
+}
+
+int BatchCoordinator::connectTo(const std::string& addr)
+{
+	size_t colon = addr.rfind(':');
+	if(colon == std::string::npos)
+		return -1;
+	std::string host = addr.substr(0, colon);
+	std::string port = addr.substr(colon + 1);
+
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	struct addrinfo* res;
+	if(getaddrinfo(host.c_str(), port.c_str(), &hints, &res))
+		return -1;
+
+	int fd = -1;
+	for(struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+		if(fd == -1)
+			continue;
+		if(connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+			break;
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+
+	if(fd != -1) {
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	}
+	return fd;
+}
+
+bool BatchCoordinator::sendJob(Worker& w, const BatchJob& job, const std::string& data)
+{
+	std::string req = "match " + std::to_string(data.size()) +
+		" -m " + std::to_string(mSeconds) +
+		" -f " + std::to_string(mTicksPerSec) +
+		" -s " + std::to_string(job.Seed) + "\n" + data;
+	size_t written = 0;
+	while(written < req.size()) {
+		ssize_t ret = send(w.Fd, req.data() + written, req.size() - written, MSG_NOSIGNAL);
+		if(ret == -1) {
+			if(errno == EINTR)
+				continue;
+			return false;
+		}
+		written += ret;
+	}
+	return true;
+}
+
+bool BatchCoordinator::readResponse(Worker& w, BatchResult& res, bool& failed)
+{
+	size_t nl = w.Buffer.find('\n');
+	if(nl == std::string::npos)
+		return false;
+
+	failed = true;
+	res.Played = false;
+	res.Duration = 0.0;
+	res.Ticks = 0;
+	if(w.Buffer.compare(0, 7, "result ") == 0) {
+		char* p;
+		size_t len = strtoul(w.Buffer.c_str() + 7, &p, 10);
+		res.Ticks = strtoul(p, &p, 10);
+		res.Duration = strtoul(p, &p, 10) * 0.001;
+		if(w.Buffer.size() < nl + 1 + len)
+			return false;
+		try {
+			res.Result = Soccer::DataExchange::parseMatchResultString(w.Buffer.substr(nl + 1, len));
+			res.Played = res.Result.Played;
+			failed = false;
+		}
+		catch(std::exception& e) {
+			LOG_WARNING(Simulation, "%s: could not parse result: %s\n", w.Address.c_str(), e.what());
+		}
+		w.Buffer.erase(0, nl + 1 + len);
+	} else {
+		LOG_WARNING(Simulation, "%s: %s\n", w.Address.c_str(), w.Buffer.substr(0, nl).c_str());
+		w.Buffer.erase(0, nl + 1);
+	}
+	return true;
+}
+
+void BatchCoordinator::dropWorker(Worker& w, std::deque<unsigned int>& pending)
+{
+	LOG_WARNING(Simulation, "Lost worker %s, requeuing %zu jobs\n", w.Address.c_str(), w.Jobs.size());
+	pending.insert(pending.begin(), w.Jobs.begin(), w.Jobs.end());
+	w.Jobs.clear();
+	close(w.Fd);
+	w.Fd = -1;
+}
+
+void BatchCoordinator::run(const std::vector<BatchJob>& jobs, const std::vector<std::string>& data,
+		ResultFunc f)
+{
+	// two jobs per worker so that a worker never waits for the network
+	static const unsigned int JobsPerWorker = 2;
+	static const unsigned int MaxRetries = 3;
+
+	std::deque<unsigned int> pending;
+	for(unsigned int i = 0; i < jobs.size(); i++)
+		pending.push_back(i);
+	std::vector<unsigned int> retries(jobs.size(), 0);
+
+	unsigned int done = 0;
+	while(done < jobs.size()) {
+		for(auto& w : mWorkers) {
+			while(w.Fd != -1 && w.Jobs.size() < JobsPerWorker && !pending.empty()) {
+				unsigned int j = pending.front();
+				if(!sendJob(w, jobs[j], data[jobs[j].File])) {
+					dropWorker(w, pending);
+					break;
+				}
+				pending.pop_front();
+				w.Jobs.push_back(j);
+			}
+		}
+		mWorkers.erase(std::remove_if(mWorkers.begin(), mWorkers.end(),
+					[](const Worker& w) { return w.Fd == -1; }), mWorkers.end());
+		if(mWorkers.empty()) {
+			throw std::runtime_error("All workers lost, " + std::to_string(jobs.size() - done) +
+					" matches not played");
+		}
+
+		std::vector<struct pollfd> fds;
+		for(auto& w : mWorkers) {
+			struct pollfd p;
+			p.fd = w.Fd;
+			p.events = POLLIN;
+			p.revents = 0;
+			fds.push_back(p);
+		}
+		if(poll(&fds[0], fds.size(), -1) == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("poll");
+			throw std::runtime_error("poll() failed");
+		}
+
+		for(unsigned int i = 0; i < fds.size(); i++) {
+			if(!fds[i].revents)
+				continue;
+			Worker& w = mWorkers[i];
+			char buf[65536];
+			ssize_t len = read(w.Fd, buf, sizeof(buf));
+			if(len == -1 && errno == EINTR)
+				continue;
+			if(len <= 0) {
+				dropWorker(w, pending);
+				continue;
+			}
+			w.Buffer.append(buf, len);
+			BatchResult res;
+			bool failed;
+			while(!w.Jobs.empty() && readResponse(w, res, failed)) {
+				unsigned int j = w.Jobs.front();
+				w.Jobs.pop_front();
+				if(failed && retries[j] < MaxRetries) {
+					retries[j]++;
+					LOG_WARNING(Simulation, "Requeuing job %u (retry %u)\n", j, retries[j]);
+					pending.push_back(j);
+					continue;
+				}
+				f(j, res);
+				done++;
+			}
+		}
+	}
+}
+
@@ -0,0 +1,48 @@
+#ifndef BATCHCOORDINATOR_H
+#define BATCHCOORDINATOR_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "match/batch/Batch.h"
+
+// Distributes batch jobs over freekick3-match workers listening on TCP
+// (freekick3-match -T port). Each worker is kept busy with a small queue
+// of jobs; the jobs of a worker whose connection is lost are handed to the
+// remaining workers, and a job a worker fails is retried a few times.
+// Only single matches are distributed; whole competitions, e.g. the
+// seasons of WorldSimulation, are only played on local threads.
+class BatchCoordinator {
+	public:
+		typedef std::function<void (unsigned int job, const BatchResult& res)> ResultFunc;
+
+		// workers are given as host:port
+		BatchCoordinator(const std::vector<std::string>& workers,
+				int ticksPerSec, double seconds);
+		~BatchCoordinator();
+		void run(const std::vector<BatchJob>& jobs, const std::vector<std::string>& data,
+				ResultFunc f);
+
+	private:
+		struct Worker {
+			std::string Address;
+			int Fd;
+			std::string Buffer;
+			std::deque<unsigned int> Jobs;
+		};
+
+		static int connectTo(const std::string& addr);
+		bool sendJob(Worker& w, const BatchJob& job, const std::string& data);
+		// failed is set if the worker couldn't play the match
+		bool readResponse(Worker& w, BatchResult& res, bool& failed);
+		void dropWorker(Worker& w, std::deque<unsigned int>& pending);
+
+		std::vector<Worker> mWorkers;
+		int mTicksPerSec;
+		double mSeconds;
+};
+
+#endif
+
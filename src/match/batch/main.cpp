@@ -0,0 +1,371 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Log.h"
+
+#include "match/Match.h"
+#include "match/MatchHeadless.h"
+#include "match/batch/Batch.h"
+#include "match/batch/BatchCoordinator.h"
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-j threads | -c workers] [-s seed] [-n seeds] [-f FPS] [-m sec] [-o file] [-l spec] <match data file or directory>...\n\n"
+			"\t-j num\tnumber of threads (default: number of CPUs)\n"
+			"\t-c list\tplay on freekick3-match -T workers, given as host:port,host:port,...\n"
+			"\t-s seed\tfirst seed (default: 1)\n"
+			"\t-n num\tnumber of seeds to play each match with (default: 1)\n"
+			"\t-f FPS\tframe rate (default: 60)\n"
+			"\t-m sec\tmatch time in seconds (default: 180)\n"
+			"\t-o file\twrite results to file instead of stdout\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n"
+			"Directories are searched recursively for *.xml, *.xml.bz2 and *.xml.gz.\n"
+			"Each result line contains: file, seed, home goals, away goals,\n"
+			"home penalties, away penalties, duration in ms and number of ticks.\n"
+			"The results are written in the order of the seeds and files.\n"
+			"\n",
+			p, Soccer::Log::usage());
+}
+
+class BatchRunner {
+	public:
+		BatchRunner(const std::vector<std::string>& files, const std::vector<std::string>& data,
+				int firstseed, int numseeds, int ticksPerSec, double seconds, FILE* out);
+		void run(int numthreads);
+		void runRemote(const std::vector<std::string>& workers);
+		void printStatistics(FILE* f) const;
+
+	private:
+		void work();
+		BatchResult playMatch(const BatchJob& job) const;
+		void addResult(unsigned int job, const BatchResult& res);
+		void writeResult(const BatchJob& job, const BatchResult& res);
+
+		const std::vector<std::string>& mFiles;
+		const std::vector<std::string>& mData;
+		int mTicksPerSec;
+		double mSeconds;
+		FILE* mOut;
+		std::vector<BatchJob> mJobs;
+		std::atomic<unsigned int> mNextJob;
+
+		// results are written out in job order
+		std::vector<BatchResult> mResultsDone;
+		std::vector<bool> mJobDone;
+		unsigned int mNextOutput;
+
+		std::mutex mMutex;
+		unsigned int mPlayed;
+		unsigned int mFailed;
+		unsigned int mResults[3];
+		unsigned int mGoals;
+		unsigned int mGoalsSquared;
+		double mMatchTime;
+		unsigned long long mTicks;
+		double mWallTime;
+};
+
+BatchRunner::BatchRunner(const std::vector<std::string>& files, const std::vector<std::string>& data,
+		int firstseed, int numseeds, int ticksPerSec, double seconds, FILE* out)
+	: mFiles(files),
+	mData(data),
+	mTicksPerSec(ticksPerSec),
+	mSeconds(seconds),
+	mOut(out),
+	mNextJob(0),
+	mNextOutput(0),
+	mPlayed(0),
+	mFailed(0),
+	mGoals(0),
+	mGoalsSquared(0),
+	mMatchTime(0.0),
+	mTicks(0),
+	mWallTime(0.0)
+{
+	for(int i = 0; i < 3; i++)
+		mResults[i] = 0;
+	for(int seed = firstseed; seed < firstseed + numseeds; seed++) {
+		for(unsigned int i = 0; i < files.size(); i++) {
+			BatchJob j;
+			j.File = i;
+			j.Seed = seed;
+			mJobs.push_back(j);
+		}
+	}
+	mResultsDone.resize(mJobs.size());
+	mJobDone.resize(mJobs.size(), false);
+}
+
+void BatchRunner::run(int numthreads)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for(int i = 0; i < numthreads; i++)
+		threads.push_back(std::thread(&BatchRunner::work, this));
+	for(auto& t : threads)
+		t.join();
+	mWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BatchRunner::runRemote(const std::vector<std::string>& workers)
+{
+	auto start = std::chrono::steady_clock::now();
+	BatchCoordinator coordinator(workers, mTicksPerSec, mSeconds);
+	coordinator.run(mJobs, mData, [&](unsigned int job, const BatchResult& res) -> void {
+			if(!res.Played) {
+				LOG_ERROR(Simulation, "%s (seed %d) was not played\n",
+					mFiles[mJobs[job].File].c_str(), mJobs[job].Seed);
+			}
+			addResult(job, res);
+			});
+	mWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BatchRunner::work()
+{
+	while(1) {
+		unsigned int i = mNextJob++;
+		if(i >= mJobs.size())
+			return;
+		BatchResult res;
+		try {
+			res = playMatch(mJobs[i]);
+		}
+		catch(std::exception& e) {
+			LOG_ERROR(Simulation, "%s (seed %d): %s\n", mFiles[mJobs[i].File].c_str(),
+					mJobs[i].Seed, e.what());
+			res.Played = false;
+			res.Duration = 0.0;
+			res.Ticks = 0;
+		}
+		addResult(i, res);
+	}
+}
+
+BatchResult BatchRunner::playMatch(const BatchJob& job) const
+{
+	auto start = std::chrono::steady_clock::now();
+
+	boost::shared_ptr<Soccer::Match> matchdata = Soccer::DataExchange::parseMatchData(mData[job.File]);
+	const Soccer::MatchRules& r = matchdata->getRules();
+	bool onlypenalties = mSeconds == 0.0;
+	boost::shared_ptr<Match> match(new Match(*matchdata, onlypenalties ? 1.0 : mSeconds,
+				r.ExtraTimeOnTie, r.PenaltiesOnTie, r.AwayGoals, r.HomeAggregate, r.AwayAggregate));
+	if(onlypenalties)
+		match->setMatchHalf(MatchHalf::PenaltyShootout);
+
+	MatchHeadless m(match, mTicksPerSec, job.Seed);
+	BatchResult res;
+	res.Played = m.play();
+	res.Result = match->getResult();
+	res.Ticks = match->getTick();
+	res.Duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return res;
+}
+
+void BatchRunner::addResult(unsigned int job, const BatchResult& res)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mResultsDone[job] = res;
+	mJobDone[job] = true;
+	while(mNextOutput < mJobs.size() && mJobDone[mNextOutput]) {
+		writeResult(mJobs[mNextOutput], mResultsDone[mNextOutput]);
+		mNextOutput++;
+	}
+}
+
+void BatchRunner::writeResult(const BatchJob& job, const BatchResult& res)
+{
+	mMatchTime += res.Duration;
+	mTicks += res.Ticks;
+	if(!res.Played) {
+		mFailed++;
+		fprintf(mOut, "%s\t%d\tfailed\n", mFiles[job.File].c_str(), job.Seed);
+		return;
+	}
+
+	const Soccer::MatchResult& r = res.Result;
+	fprintf(mOut, "%s\t%d\t%d\t%d\t%d\t%d\t%.0f\t%u\n", mFiles[job.File].c_str(), job.Seed,
+			r.HomeGoals, r.AwayGoals, r.HomePenalties, r.AwayPenalties,
+			res.Duration * 1000.0, res.Ticks);
+	fflush(mOut);
+
+	unsigned int goals = r.HomeGoals + r.AwayGoals;
+	mPlayed++;
+	mGoals += goals;
+	mGoalsSquared += goals * goals;
+	if(r.HomeGoals > r.AwayGoals)
+		mResults[0]++;
+	else if(r.HomeGoals == r.AwayGoals)
+		mResults[1]++;
+	else
+		mResults[2]++;
+}
+
+void BatchRunner::printStatistics(FILE* f) const
+{
+	fprintf(f, "Matches played: %u (%u failed)\n", mPlayed, mFailed);
+	if(mPlayed) {
+		double gpm = mGoals / (double)mPlayed;
+		double var = mGoalsSquared / (double)mPlayed - gpm * gpm;
+		fprintf(f, "Home wins: %u (%.1f%%), draws: %u (%.1f%%), away wins: %u (%.1f%%)\n",
+				mResults[0], mResults[0] * 100.0 / mPlayed,
+				mResults[1], mResults[1] * 100.0 / mPlayed,
+				mResults[2], mResults[2] * 100.0 / mPlayed);
+		fprintf(f, "Goals per match: %.3f (standard deviation %.3f)\n", gpm, sqrt(std::max(0.0, var)));
+	}
+	fprintf(f, "Wall time: %.2f s, simulation time: %.2f s\n", mWallTime, mMatchTime);
+	if(mWallTime > 0.0) {
+		fprintf(f, "Matches per second: %.2f, ticks per second: %.0f\n",
+				(mPlayed + mFailed) / mWallTime, mTicks / mWallTime);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int numthreads = std::thread::hardware_concurrency();
+	int firstseed = 1;
+	int numseeds = 1;
+	int ticksPerSec = 60;
+	double seconds = 180.0;
+	const char* outfile = nullptr;
+	std::vector<std::string> workers;
+	std::vector<std::string> paths;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-j")) {
+			if(++i >= argc) { printf("-j requires a numeric argument.\n"); exit(1); }
+			numthreads = atoi(argv[i]);
+			if(numthreads < 1) {
+				printf("-j argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-c")) {
+			if(++i >= argc) { printf("-c requires an argument.\n"); exit(1); }
+			std::stringstream ss(argv[i]);
+			std::string w;
+			while(std::getline(ss, w, ','))
+				if(!w.empty())
+					workers.push_back(w);
+		}
+		else if(!strcmp(argv[i], "-s")) {
+			if(++i >= argc) { printf("-s requires a numeric argument.\n"); exit(1); }
+			firstseed = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			numseeds = atoi(argv[i]);
+			if(numseeds < 1) {
+				printf("-n argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-f")) {
+			if(++i >= argc) { printf("-f requires a numeric argument.\n"); exit(1); }
+			ticksPerSec = atoi(argv[i]);
+			if(ticksPerSec < 1) {
+				printf("-f argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-m")) {
+			if(++i >= argc) { printf("-m requires a numeric argument.\n"); exit(1); }
+			seconds = atof(argv[i]);
+			if(seconds < 0.0) {
+				printf("-m argument must be greater than or equal to 0.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-o")) {
+			if(++i >= argc) { printf("-o requires an argument.\n"); exit(1); }
+			outfile = argv[i];
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else if(argv[i][0] == '-') {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+		else {
+			paths.push_back(argv[i]);
+		}
+	}
+
+	if(paths.empty()) {
+		usage(argv[0]);
+		exit(1);
+	}
+
+	try {
+		std::vector<std::string> files;
+		for(auto& p : paths)
+			Soccer::DataExchange::findMatchDataFiles(p, files);
+
+		std::vector<std::string> data;
+		// parsed once and passed on in the binary format
+		for(auto& fn : files) {
+			boost::shared_ptr<Soccer::Match> m = Soccer::DataExchange::parseMatchDataFile(fn.c_str());
+			data.push_back(Soccer::DataExchange::createMatchDataString(*m, Soccer::MatchDataFormat::Binary));
+		}
+
+		FILE* out = stdout;
+		if(outfile) {
+			out = fopen(outfile, "w");
+			if(!out) {
+				perror("fopen");
+				throw std::runtime_error(std::string("Could not open ") + outfile);
+			}
+		}
+
+		BatchRunner runner(files, data, firstseed, numseeds, ticksPerSec, seconds, out);
+		if(!workers.empty()) {
+			LOG_INFO(Simulation, "Playing %zu matches with %d seeds on %zu workers\n",
+					files.size(), numseeds, workers.size());
+			runner.runRemote(workers);
+		} else {
+			numthreads = std::min<int>(numthreads, files.size() * numseeds);
+			LOG_INFO(Simulation, "Playing %zu matches with %d seeds on %d threads\n",
+					files.size(), numseeds, numthreads);
+			runner.run(std::max(numthreads, 1));
+		}
+		if(outfile)
+			fclose(out);
+		Soccer::Log::flush();
+		runner.printStatistics(outfile ? stdout : stderr);
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+
+	return 0;
+}
+
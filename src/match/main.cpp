@@ -1,16 +1,23 @@
 #include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
 
 #include <iostream>
 #include <boost/shared_ptr.hpp>
 
 #include "soccer/DataExchange.h"
+#include "soccer/Log.h"
 
 #include "match/Match.h"
 #include "match/MatchSDLGUI.h"
+#include "match/MatchEventWriter.h"
+#include "match/Replay.h"
+#include "match/MatchWorker.h"
 
 void usage(const char* p)
 {
-	printf("Usage: %s <path to match data file> [-o] [-t team] [-p player] [-f FPS [-s seed]] [-d] [-m sec] [-x] [-E] [-P] [-A h a]\n\n"
+	printf("Usage: %s <path to match data file> [-o] [-t team] [-p player] [-f FPS [-s seed]] [-d] [-m sec] [-x] [-E] [-P] [-A h a] [-l spec] [-e file] [-R file] [-r file] [-O fd] [-S file]\n\n"
 			"\t-o\tobserver mode\n"
 			"\t-t team\tteam number (1 or 2)\n"
 			"\t-p num\tplayer number (1-11)\n"
@@ -22,8 +29,85 @@ void usage(const char* p)
 			"\t-E\textra time on tie\n"
 			"\t-P\tpenalties on tie\n"
 			"\t-A h a\tapply away goals rule - h-a is the aggregate result before this match\n"
+			"\t-e file\twrite match events to file\n"
+			"\t-R file\trecord replay to file\n"
+			"\t-r file\tplay back replay from file\n"
+			"\t-O fd\twrite only the match result to file descriptor fd (1: stdout)\n"
+			"\t-S file\twrite only the match result to file\n"
+			"\t\twithout -O or -S the result is written back to the match data file\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n"
+			"Worker mode: %s -w [-l spec] | -W <socket path> [-l spec] | -T [host:]port [-l spec]\n"
+			"\t-w\tplay matches requested on stdin, write results to stdout\n"
+			"\t-W path\tplay matches requested over a Unix domain socket\n"
+			"\t-T port\tplay matches requested over TCP\n"
 			"\n",
-			p);
+			p, Soccer::Log::usage(), p);
+}
+
+static void writeResult(int fd, const std::string& res)
+{
+	size_t written = 0;
+	while(written < res.size()) {
+		ssize_t ret = write(fd, res.data() + written, res.size() - written);
+		if(ret == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("write");
+			throw std::runtime_error("Could not write match result");
+		}
+		written += ret;
+	}
+	if(fd != STDOUT_FILENO)
+		close(fd);
+}
+
+int runWorker(int argc, char** argv)
+{
+	const char* socketpath = nullptr;
+	const char* tcpaddr = nullptr;
+	int i = 2;
+	if(!strcmp(argv[1], "-W")) {
+		if(argc < 3) { printf("-W requires an argument.\n"); exit(1); }
+		socketpath = argv[2];
+		i = 3;
+	} else if(!strcmp(argv[1], "-T")) {
+		if(argc < 3) { printf("-T requires an argument.\n"); exit(1); }
+		tcpaddr = argv[2];
+		i = 3;
+	}
+	for(; i < argc; i++) {
+		if(!strcmp(argv[i], "-l") && i + 1 < argc) {
+			if(!Soccer::Log::configure(argv[++i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		} else {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	try {
+		if(socketpath) {
+			MatchWorker::listen(socketpath);
+		} else if(tcpaddr) {
+			MatchWorker::listenTcp(tcpaddr);
+		} else {
+			// stdout carries the results
+			Soccer::Log::setOutput(stderr);
+			MatchWorker w(STDIN_FILENO, STDOUT_FILENO);
+			w.serve();
+		}
+	}
+	catch (std::exception& e) {
+		fprintf(stderr, "std::exception: %s\n", e.what());
+	}
+	Soccer::Log::flush();
+	return 0;
 }
 
 int main(int argc, char** argv)
@@ -33,6 +117,9 @@ int main(int argc, char** argv)
 		exit(1);
 	}
 
+	if(!strcmp(argv[1], "-w") || !strcmp(argv[1], "-W") || !strcmp(argv[1], "-T"))
+		return runWorker(argc, argv);
+
 	bool observer = false;
 	bool debug = false;
 	int teamnum = 1;
@@ -48,6 +135,11 @@ int main(int argc, char** argv)
 	bool onlypenalties = false;
 	int hg = 0;
 	int ag = 0;
+	const char* eventfile = nullptr;
+	const char* recordfile = nullptr;
+	const char* replayfile = nullptr;
+	int outputfd = -1;
+	const char* resultfile = nullptr;
 
 	for(int i = 2; i < argc; i++) {
 		if(!strcmp(argv[i], "-o")) {
@@ -109,6 +201,27 @@ int main(int argc, char** argv)
 			hg = atoi(argv[i]);
 			if(++i >= argc) { printf("-A requires two numeric arguments.\n"); exit(1); }
 			ag = atoi(argv[i]);
+		} else if(!strcmp(argv[i], "-e")) {
+			if(++i >= argc) { printf("-e requires an argument.\n"); exit(1); }
+			eventfile = argv[i];
+		} else if(!strcmp(argv[i], "-R")) {
+			if(++i >= argc) { printf("-R requires an argument.\n"); exit(1); }
+			recordfile = argv[i];
+		} else if(!strcmp(argv[i], "-r")) {
+			if(++i >= argc) { printf("-r requires an argument.\n"); exit(1); }
+			replayfile = argv[i];
+		} else if(!strcmp(argv[i], "-O")) {
+			if(++i >= argc) { printf("-O requires a numeric argument.\n"); exit(1); }
+			outputfd = atoi(argv[i]);
+		} else if(!strcmp(argv[i], "-S")) {
+			if(++i >= argc) { printf("-S requires an argument.\n"); exit(1); }
+			resultfile = argv[i];
+		} else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
 		} else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
 			usage(argv[0]);
 			exit(0);
@@ -120,14 +233,40 @@ int main(int argc, char** argv)
 		}
 	}
 
+	if(replayfile && (disableGUI || recordfile)) {
+		printf("-r cannot be used together with -x or -R.\n");
+		exit(1);
+	}
+
 	try {
-		boost::shared_ptr<Soccer::Match> matchdata = Soccer::DataExchange::parseMatchDataFile(argv[1]);
+		// the result is written in the format the match data was given in
+		Soccer::MatchDataFormat format;
+		boost::shared_ptr<Soccer::Match> matchdata = Soccer::DataExchange::parseMatchDataFile(argv[1], &format);
 		boost::shared_ptr<Match> match(new Match(*matchdata, seconds, extratime, penalties, awaygoals, hg, ag));
+		boost::shared_ptr<MatchEventWriter> eventwriter;
+		FILE* eventf = nullptr;
+		if(eventfile) {
+			eventf = fopen(eventfile, "w");
+			if(!eventf) {
+				perror("fopen");
+				throw std::runtime_error("Could not open event file");
+			}
+			boost::shared_ptr<MatchEventQueue> q(new MatchEventQueue());
+			match->setEventQueue(q);
+			eventwriter = boost::shared_ptr<MatchEventWriter>(new MatchEventWriter(q, eventf));
+		}
+		boost::shared_ptr<ReplayRecorder> recorder;
+		if(recordfile) {
+			recorder = boost::shared_ptr<ReplayRecorder>(new ReplayRecorder(recordfile));
+			match->setReplayRecorder(recorder);
+		}
 		if(onlypenalties)
 			match->setMatchHalf(MatchHalf::PenaltyShootout);
-		boost::shared_ptr<MatchGUI> gui;
-		gui = boost::shared_ptr<MatchGUI>(new MatchSDLGUI(match, observer, teamnum, playernum,
+		boost::shared_ptr<MatchSDLGUI> sdlgui(new MatchSDLGUI(match, observer, teamnum, playernum,
 					ticksPerSec, debug, useseed, disableGUI));
+		if(replayfile)
+			sdlgui->setReplay(boost::shared_ptr<ReplayReader>(new ReplayReader(replayfile)));
+		boost::shared_ptr<MatchGUI> gui = sdlgui;
 
 		if(useseed) {
 			// initialise seed after constructing MatchSDLGUI as SDL seems to
@@ -136,8 +275,17 @@ int main(int argc, char** argv)
 			srand(seed);
 		}
 
-		if(gui->play()) {
+		bool finished = gui->play();
+		if(recorder)
+			recorder->finish();
+		if(eventwriter) {
+			eventwriter->stop();
+			fclose(eventf);
+		}
+
+		if(finished) {
 			// finished match
+			Soccer::Log::flush();
 			printf("Final score: %d - %d\n", match->getResult().HomeGoals,
 					match->getResult().AwayGoals);
 			if(match->getResult().HomePenalties || match->getResult().AwayPenalties) {
@@ -148,7 +296,17 @@ int main(int argc, char** argv)
 				printf("Aggregate: %d - %d\n", match->getResult().HomeGoals + hg,
 						match->getResult().AwayGoals + ag);
 			}
-			Soccer::DataExchange::createMatchDataFile(*match, argv[1]);
+			if(outputfd != -1 || resultfile) {
+				std::string res = Soccer::DataExchange::createMatchResultString(match->getResult());
+				if(outputfd != -1) {
+					fflush(stdout);
+					writeResult(outputfd, res);
+				}
+				if(resultfile)
+					Soccer::DataExchange::writeFile(resultfile, res);
+			} else {
+				Soccer::DataExchange::createMatchDataFile(*match, argv[1], format);
+			}
 		}
 	}
 	catch (std::exception& e) {
@@ -158,5 +316,6 @@ int main(int argc, char** argv)
 		printf("Unknown exception.\n");
 	}
 
+	Soccer::Log::flush();
 	return 0;
 }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <stdexcept>
 
 #include "soccer/Competition.h"
 #include "soccer/Match.h"
@@ -6,36 +7,214 @@
 
 namespace Soccer {
 
+void Schedule::addRound(const Round& r, bool nextlegs)
+{
+	unsigned int first = mFixtures.size();
+	unsigned int previous = mRounds.empty() ? 0 : mRounds.back();
+	if(nextlegs && (mRounds.empty() || first - previous != r.getMatches().size()))
+		throw std::runtime_error("Next legs don't match the previous round.");
+
+	mRounds.push_back(first);
+	for(auto m : r.getMatches()) {
+		const MatchRules& rules = m->getRules();
+		const MatchResult& res = m->getResult();
+		Fixture f;
+		f.Home = addTeam(m->getTeam(0));
+		f.Away = addTeam(m->getTeam(1));
+		f.PreviousLeg = nextlegs ? previous + mFixtures.size() - first + 1 : 0;
+		f.Flags = (rules.ExtraTimeOnTie ? Fixture::RuleExtraTime : 0) |
+			(rules.PenaltiesOnTie ? Fixture::RulePenalties : 0) |
+			(rules.AwayGoals ? Fixture::RuleAwayGoals : 0);
+		mFixtures.push_back(f);
+		setResult(mRounds.size() - 1, mFixtures.size() - 1 - first, res);
+	}
+}
+
+unsigned int Schedule::getNumberOfRounds() const
+{
+	return mRounds.size();
+}
+
+unsigned int Schedule::getNumberOfMatches(unsigned int rn) const
+{
+	if(rn >= mRounds.size())
+		return 0;
+	else if(rn + 1 == mRounds.size())
+		return mFixtures.size() - mRounds[rn];
+	else
+		return mRounds[rn + 1] - mRounds[rn];
+}
+
+std::vector<boost::shared_ptr<Match>> Schedule::getMatches(unsigned int rn) const
+{
+	std::vector<boost::shared_ptr<Match>> ret;
+	for(unsigned int i = 0; i < getNumberOfMatches(rn); i++)
+		ret.push_back(createMatch(mRounds[rn] + i));
+	return ret;
+}
+
+boost::shared_ptr<Match> Schedule::getMatch(unsigned int rn, unsigned int i) const
+{
+	if(i >= getNumberOfMatches(rn))
+		return boost::shared_ptr<Match>();
+	else
+		return createMatch(mRounds[rn] + i);
+}
+
+void Schedule::setResult(unsigned int rn, unsigned int i, const MatchResult& res)
+{
+	assert(i < getNumberOfMatches(rn));
+	Fixture& f = mFixtures[mRounds[rn] + i];
+	if(res.Played)
+		f.Flags |= Fixture::ResultPlayed;
+	else
+		f.Flags &= ~Fixture::ResultPlayed;
+	f.HomeGoals     = res.HomeGoals;
+	f.AwayGoals     = res.AwayGoals;
+	f.HomePenalties = res.HomePenalties;
+	f.AwayPenalties = res.AwayPenalties;
+}
+
+CupEntry Schedule::getCupEntry(unsigned int rn, unsigned int i) const
+{
+	assert(i < getNumberOfMatches(rn));
+	return createCupEntry(mRounds[rn] + i);
+}
+
+const std::vector<Schedule::Fixture>& Schedule::getFixtures() const
+{
+	return mFixtures;
+}
+
+const boost::shared_ptr<StatefulTeam>& Schedule::getTeam(unsigned int i) const
+{
+	return mTeams.at(i);
+}
+
+unsigned short Schedule::addTeam(const boost::shared_ptr<StatefulTeam>& t)
+{
+	auto it = std::find(mTeams.begin(), mTeams.end(), t);
+	if(it != mTeams.end())
+		return it - mTeams.begin();
+
+	if(mTeams.size() > 0xffff)
+		throw std::runtime_error("Too many teams in the schedule.");
+	mTeams.push_back(t);
+	return mTeams.size() - 1;
+}
+
+boost::shared_ptr<Match> Schedule::createMatch(unsigned int fi) const
+{
+	const Fixture& f = mFixtures[fi];
+
+	// the aggregate of the previous legs, as seen by the home team
+	unsigned int homeagg = 0;
+	unsigned int awayagg = 0;
+	for(unsigned int l = f.PreviousLeg; l != 0; l = mFixtures[l - 1].PreviousLeg) {
+		const Fixture& p = mFixtures[l - 1];
+		homeagg += p.Home == f.Home ? p.HomeGoals : p.AwayGoals;
+		awayagg += p.Home == f.Home ? p.AwayGoals : p.HomeGoals;
+	}
+
+	boost::shared_ptr<Match> m(new Match(mTeams[f.Home], mTeams[f.Away],
+				MatchRules(f.Flags & Fixture::RuleExtraTime, f.Flags & Fixture::RulePenalties,
+					f.Flags & Fixture::RuleAwayGoals, homeagg, awayagg)));
+	if(f.Flags & Fixture::ResultPlayed) {
+		m->setCupEntry(createCupEntry(fi));
+		m->setResult(MatchResult(f.HomeGoals, f.AwayGoals, f.HomePenalties, f.AwayPenalties));
+	}
+	return m;
+}
+
+CupEntry Schedule::createCupEntry(unsigned int fi) const
+{
+	std::vector<unsigned int> legs;
+	for(unsigned int l = fi + 1; l != 0; l = mFixtures[l - 1].PreviousLeg)
+		legs.push_back(l - 1);
+
+	CupEntry c;
+	for(auto it = legs.rbegin(); it != legs.rend(); ++it) {
+		const Fixture& f = mFixtures[*it];
+		if(!(f.Flags & Fixture::ResultPlayed))
+			break;
+		c.addMatchResult(MatchResult(f.HomeGoals, f.AwayGoals, f.HomePenalties, f.AwayPenalties));
+	}
+	return c;
+}
+
+void Schedule::addOldRounds(const std::vector<Round>& rounds)
+{
+	// the legs of the cup ties weren't stored explicitly. The last leg of a
+	// tie has the teams swapped and is played until there's a winner.
+	for(unsigned int i = 0; i < rounds.size(); i++) {
+		bool nextlegs = i > 0 && !rounds[i].getMatches().empty() &&
+			rounds[i].getMatches().size() == rounds[i - 1].getMatches().size();
+		for(unsigned int j = 0; nextlegs && j < rounds[i].getMatches().size(); j++) {
+			const Match& m = *rounds[i].getMatches()[j];
+			const Match& p = *rounds[i - 1].getMatches()[j];
+			nextlegs = m.getTeam(0) == p.getTeam(1) && m.getTeam(1) == p.getTeam(0) &&
+				m.getRules().PenaltiesOnTie && !p.getRules().PenaltiesOnTie;
+		}
+		addRound(rounds[i], nextlegs);
+	}
+}
+
 StatefulCompetition::StatefulCompetition()
 	: mNextMatch(boost::shared_ptr<Match>()),
 	mThisRound(0),
-	mNextMatchId(0)
+	mNextMatchId(0),
+	mEngineSimulation(false),
+	mRoundMatchesRound(-1)
 {
 }
 
-void StatefulCompetition::setNextMatch()
+StatefulCompetition::StatefulCompetition(const StatefulCompetition& c)
+	: mSchedule(c.mSchedule),
+	mThisRound(c.mThisRound),
+	mNextMatchId(c.mNextMatchId),
+	mEngineSimulation(c.mEngineSimulation),
+	mRoundMatchesRound(-1)
 {
-	Round* r;
+	if(c.mNextMatch) {
+		updateRoundMatches();
+		mNextMatch = mRoundMatches[mNextMatchId - 1];
+	}
+}
 
-	r = mSchedule.getRound(mThisRound);
-	if(!r) {
-		mNextMatch = boost::shared_ptr<Match>();
+void StatefulCompetition::setNextMatch()
+{
+	mNextMatch = boost::shared_ptr<Match>();
+	if(mThisRound >= (int)mSchedule.getNumberOfRounds())
 		return;
-	}
 
-	mNextMatch = r->getMatch(mNextMatchId);
-	if(!mNextMatch) {
+	if(mNextMatchId >= (int)mSchedule.getNumberOfMatches(mThisRound)) {
 		mThisRound++;
 		mNextMatchId = 0;
-		r = mSchedule.getRound(mThisRound);
-		if(!r)
+		if(mThisRound >= (int)mSchedule.getNumberOfRounds())
 			return;
-		mNextMatch = r->getMatch(mNextMatchId);
 	}
 
+	if(mRoundMatchesRound != mThisRound)
+		updateRoundMatches();
+	mNextMatch = mRoundMatches[mNextMatchId];
 	mNextMatchId++;
 }
 
+void StatefulCompetition::setNextMatchResult(const MatchResult& res)
+{
+	assert(mNextMatch);
+	assert(mNextMatchId > 0);
+	mSchedule.setResult(mThisRound, mNextMatchId - 1, res);
+	mNextMatch->setResult(res);
+	mNextMatch->setCupEntry(mSchedule.getCupEntry(mThisRound, mNextMatchId - 1));
+}
+
+void StatefulCompetition::updateRoundMatches()
+{
+	mRoundMatches = mSchedule.getMatches(mThisRound);
+	mRoundMatchesRound = mThisRound;
+}
+
 const Schedule& StatefulCompetition::getSchedule() const
 {
 	return mSchedule;
@@ -48,12 +227,10 @@ const boost::shared_ptr<Match> StatefulCompetition::getNextMatch() const
 
 std::vector<boost::shared_ptr<Match>> StatefulCompetition::getCurrentRoundMatches() const
 {
-	auto r = mSchedule.getRound(mThisRound);
-	if(r) {
-		return r->getMatches();
-	} else {
-		return std::vector<boost::shared_ptr<Match>>();
-	}
+	if(mRoundMatchesRound == mThisRound)
+		return mRoundMatches;
+	else
+		return mSchedule.getMatches(mThisRound);
 }
 
 int StatefulCompetition::getNextMatchRoundNumber() const
@@ -61,6 +238,16 @@ int StatefulCompetition::getNextMatchRoundNumber() const
 	return mThisRound;
 }
 
+void StatefulCompetition::setEngineSimulation(bool e)
+{
+	mEngineSimulation = e;
+}
+
+bool StatefulCompetition::getEngineSimulation() const
+{
+	return mEngineSimulation;
+}
+
 }
 
 
@@ -4,15 +4,16 @@
 #include <boost/shared_ptr.hpp>
 #include <vector>
 
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/tracking.hpp>
+
 #include "common/Serialization.h"
+#include "soccer/Match.h"
 
 
 namespace Soccer {
 
-class Match;
-struct MatchResult;
-class StatefulTeam;
-
+// The matches of a round to be added to a Schedule.
 class Round {
 	public:
 		Round() { }
@@ -52,43 +53,81 @@ class Round {
 		}
 };
 
+// The matches of a competition. The teams are stored once in the team
+// table of the schedule and each match as a Fixture referring to it; the
+// Match objects are only created when asked for, e.g. for the GUI.
 class Schedule {
 	public:
-		Schedule() { }
-		void addRound(const Round& r)
-		{
-			mRounds.push_back(r);
-		}
+		struct Fixture {
+			enum {
+				RuleExtraTime = 1,
+				RulePenalties = 2,
+				RuleAwayGoals = 4,
+				ResultPlayed  = 8
+			};
+			unsigned short Home; // index to the team table
+			unsigned short Away;
+			unsigned int PreviousLeg; // fixture index + 1 of the previous leg of a cup tie, 0 if none
+			unsigned char Flags;
+			unsigned char HomeGoals;
+			unsigned char AwayGoals;
+			unsigned char HomePenalties;
+			unsigned char AwayPenalties;
+
+			template<class Archive>
+			void serialize(Archive& ar, const unsigned int version)
+			{
+				ar & Home;
+				ar & Away;
+				ar & PreviousLeg;
+				ar & Flags;
+				ar & HomeGoals;
+				ar & AwayGoals;
+				ar & HomePenalties;
+				ar & AwayPenalties;
+			}
+		};
 
-		unsigned int getNumberOfRounds() const
-		{
-			return mRounds.size();
-		}
-
-		const Round* getRound(unsigned int rn) const
-		{
-			if(rn >= mRounds.size())
-				return nullptr;
-			else
-				return &mRounds[rn];
-		}
-
-		Round* getRound(unsigned int rn)
-		{
-			if(rn >= mRounds.size())
-				return nullptr;
-			else
-				return &mRounds[rn];
-		}
+		Schedule() { }
+		/* If nextlegs is set, the matches of r are the next legs of the
+		 * cup ties of the previous round, in the same order. */
+		void addRound(const Round& r, bool nextlegs = false);
+		unsigned int getNumberOfRounds() const;
+		unsigned int getNumberOfMatches(unsigned int rn) const;
+		/* Creates the matches of the round. Empty if there's no such round. */
+		std::vector<boost::shared_ptr<Match>> getMatches(unsigned int rn) const;
+		boost::shared_ptr<Match> getMatch(unsigned int rn, unsigned int i) const;
+		void setResult(unsigned int rn, unsigned int i, const MatchResult& res);
+		/* The results of the cup tie up to and including the match. */
+		CupEntry getCupEntry(unsigned int rn, unsigned int i) const;
+
+		const std::vector<Fixture>& getFixtures() const;
+		const boost::shared_ptr<StatefulTeam>& getTeam(unsigned int i) const;
 
 	private:
-		std::vector<Round> mRounds;
+		unsigned short addTeam(const boost::shared_ptr<StatefulTeam>& t);
+		boost::shared_ptr<Match> createMatch(unsigned int fi) const;
+		CupEntry createCupEntry(unsigned int fi) const;
+		void addOldRounds(const std::vector<Round>& rounds);
+
+		std::vector<boost::shared_ptr<StatefulTeam>> mTeams;
+		std::vector<Fixture> mFixtures;
+		std::vector<unsigned int> mRounds; // index of the first fixture of each round
 
 		friend class boost::serialization::access;
 		template<class Archive>
 		void serialize(Archive& ar, const unsigned int version)
 		{
-			ar & mRounds;
+			if(version == 0) {
+				std::vector<Round> rounds;
+				ar & rounds;
+				addOldRounds(rounds);
+			}
+			else {
+				ar & mTeams;
+				ar & mFixtures;
+				ar & mRounds;
+			}
 		}
 };
 
@@ -99,12 +138,13 @@ enum class CompetitionType {
 };
 
 /* NOTE: for each class deriving from StatefulCompetition,
- * 1. implement matchPlayed, getType, getNumberOfTeams and getTeamsByPosition -
+ * 1. implement matchPlayed, getType, getNumberOfTeams, getTeamsByPosition and clone -
  *    they should be abstract but aren't due to serialization.
  * 2. In the constructor, add at least one round with matches in the schedule and call setNextMatch().
  * 3. add saving the class to YourCompetitionScreen::saveCompetition.
  * 4. add loading the class to LoadGameScreen::buttonPressed.
- * 5. in matchPlayed(), you must call setNextMatch(). You can add also matches to the schedule in matchPlayed().
+ * 5. in matchPlayed(), you must call setNextMatchResult() and setNextMatch(). You can add also matches
+ *    to the schedule in matchPlayed().
  */
 class StatefulCompetition {
 	public:
@@ -121,25 +161,58 @@ class StatefulCompetition {
 			assert(0); return std::vector<boost::shared_ptr<StatefulTeam>>();
 		}
 		virtual std::vector<boost::shared_ptr<Match>> getCurrentRoundMatches() const;
+		/* Copies the state of the competition, sharing the teams, so that
+		 * matches can be played in the copy without changing this one. */
+		virtual boost::shared_ptr<StatefulCompetition> clone() const {
+			assert(0); return boost::shared_ptr<StatefulCompetition>();
+		}
 		int getNextMatchRoundNumber() const;
+		/* If set, matches without human players that aren't displayed
+		 * are played with the match engine instead of simulated. */
+		void setEngineSimulation(bool e);
+		bool getEngineSimulation() const;
 
 	protected:
+		// creates the matches of the current round for the copy
+		StatefulCompetition(const StatefulCompetition& c);
+		StatefulCompetition& operator=(const StatefulCompetition& c) = delete;
 		void setNextMatch();
+		/* Stores the result of mNextMatch in the schedule. */
+		void setNextMatchResult(const MatchResult& res);
 		Schedule mSchedule;
 		boost::shared_ptr<Match> mNextMatch;
 
 	private:
+		void updateRoundMatches();
+
 		int mThisRound;
 		int mNextMatchId;
+		bool mEngineSimulation;
+		// the matches of the current round, created from the schedule
+		// when the round is started so that they stay the same objects
+		std::vector<boost::shared_ptr<Match>> mRoundMatches;
+		int mRoundMatchesRound;
 
 		friend class boost::serialization::access;
 		template<class Archive>
 		void serialize(Archive& ar, const unsigned int version)
 		{
 			ar & mSchedule;
-			ar & mNextMatch;
+			if(version < 2) {
+				boost::shared_ptr<Match> m;
+				ar & m;
+			}
 			ar & mThisRound;
 			ar & mNextMatchId;
+			if(version > 0)
+				ar & mEngineSimulation;
+			if(Archive::is_loading::value) {
+				updateRoundMatches();
+				if(mNextMatchId > 0 && mNextMatchId <= (int)mRoundMatches.size())
+					mNextMatch = mRoundMatches[mNextMatchId - 1];
+				else
+					mNextMatch = boost::shared_ptr<Match>();
+			}
 		}
 };
 
@@ -147,6 +220,10 @@ class StatefulCompetition {
 }
 
 BOOST_CLASS_EXPORT_KEY(Soccer::StatefulCompetition);
+BOOST_CLASS_VERSION(Soccer::StatefulCompetition, 2)
+BOOST_CLASS_VERSION(Soccer::Schedule, 1)
+BOOST_CLASS_IMPLEMENTATION(Soccer::Schedule::Fixture, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(Soccer::Schedule::Fixture, boost::serialization::track_never)
 
 #endif
 
@@ -69,7 +69,7 @@ void StatefulCup::matchPlayed(const MatchResult& res)
 	assert(it != mEntries.end());
 
 	it->second.addMatchResult(res);
-	mNextMatch->setCupEntry(it->second);
+	setNextMatchResult(res);
 
 	if(res.HomeGoals == res.AwayGoals) {
 		if(mLegs == 1) {
@@ -84,17 +84,6 @@ void StatefulCup::matchPlayed(const MatchResult& res)
 		setupNextRound(teams);
 		setNextMatch();
 	}
-
-	if(mNextMatch) {
-		auto newit = mEntries.find({mNextMatch->getTeam(0), mNextMatch->getTeam(1)});
-		if(newit == mEntries.end())
-			newit = mEntries.find({mNextMatch->getTeam(1), mNextMatch->getTeam(0)});
-		assert(newit != mEntries.end());
-
-		auto agg = newit->second.aggregate();
-		mNextMatch->getRules().AwayAggregate = agg.first;
-		mNextMatch->getRules().HomeAggregate = agg.second;
-	}
 }
 
 void StatefulCup::setupNextRound(std::vector<boost::shared_ptr<StatefulTeam>>& teams)
@@ -110,6 +99,7 @@ void StatefulCup::setupNextRound(std::vector<boost::shared_ptr<StatefulTeam>>& t
 	mEntries.clear();
 	std::random_shuffle(teams.begin(), teams.end());
 
+	// the schedule links the legs of each tie and sets the aggregates
 	for(unsigned int i = 0; i < mLegs; i++) {
 		Round r;
 		for(auto it = teams.begin(); it != teams.end(); ++it) {
@@ -126,7 +116,7 @@ void StatefulCup::setupNextRound(std::vector<boost::shared_ptr<StatefulTeam>>& t
 						MatchRules(pen, pen, mAwayGoals)));
 			r.addMatch(m);
 		}
-		mSchedule.addRound(r);
+		mSchedule.addRound(r, i > 0);
 	}
 }
 
@@ -134,6 +124,11 @@ StatefulCup::StatefulCup()
 {
 }
 
+boost::shared_ptr<StatefulCompetition> StatefulCup::clone() const
+{
+	return boost::shared_ptr<StatefulCompetition>(new StatefulCup(*this));
+}
+
 CompetitionType StatefulCup::getType() const
 {
 	return CompetitionType::Cup;
@@ -144,6 +139,26 @@ unsigned int StatefulCup::getTotalNumberOfRounds() const
 	return mTotalRounds;
 }
 
+const std::map<std::pair<boost::shared_ptr<StatefulTeam>, boost::shared_ptr<StatefulTeam>>, CupEntry>& StatefulCup::getEntries() const
+{
+	return mEntries;
+}
+
+unsigned int StatefulCup::getNumberOfLegs() const
+{
+	return mLegs;
+}
+
+bool StatefulCup::getAwayGoals() const
+{
+	return mAwayGoals;
+}
+
+bool StatefulCup::getOnlyOneRound() const
+{
+	return mOnlyOneRound;
+}
+
 unsigned int StatefulCup::getNumberOfTeams() const
 {
 	return mEntries.size() * 2;
@@ -26,6 +26,12 @@ class StatefulCup : public StatefulCompetition {
 		unsigned int getTotalNumberOfRounds() const;
 		virtual unsigned int getNumberOfTeams() const override;
 		virtual std::vector<boost::shared_ptr<StatefulTeam>> getTeamsByPosition() const override;
+		virtual boost::shared_ptr<StatefulCompetition> clone() const override;
+		// the ties of the current round
+		const std::map<std::pair<boost::shared_ptr<StatefulTeam>, boost::shared_ptr<StatefulTeam>>, CupEntry>& getEntries() const;
+		unsigned int getNumberOfLegs() const;
+		bool getAwayGoals() const;
+		bool getOnlyOneRound() const;
 
 	private:
 		void setupNextRound(std::vector<boost::shared_ptr<StatefulTeam>>& teams);
@@ -1,5 +1,19 @@
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
 #include <string>
+#include <algorithm>
 #include <stdexcept>
+#include <fstream>
+#include <sstream>
+
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 #include "common/Color.h"
 
@@ -171,118 +185,271 @@ TeamTactics DataExchange::parseTactics(const TiXmlElement* elem)
 	return TeamTactics(pt, pressure, longballs, fastpassing, shootclose);
 }
 
-boost::shared_ptr<Match> DataExchange::parseMatchDataFile(const char* fn)
+static bool hasSuffix(const char* fn, const char* suffix)
 {
-	TiXmlDocument doc(fn);
-	std::stringstream ss;
-	ss << "Error parsing match file " << fn;
+	size_t l = strlen(fn);
+	size_t sl = strlen(suffix);
+	return l >= sl && !strcmp(fn + l - sl, suffix);
+}
 
-	if(!doc.LoadFile(TIXML_ENCODING_UTF8))
-		throw std::runtime_error(ss.str());
+static bool isMatchFile(const std::string& fn)
+{
+	return hasSuffix(fn.c_str(), ".xml") || hasSuffix(fn.c_str(), ".xml.bz2") ||
+		hasSuffix(fn.c_str(), ".xml.gz");
+}
+
+void DataExchange::findMatchDataFiles(const std::string& path, std::vector<std::string>& files)
+{
+	struct stat st;
+	if(stat(path.c_str(), &st) == -1) {
+		perror("stat");
+		throw std::runtime_error("Could not access " + path);
+	}
+	if(!S_ISDIR(st.st_mode)) {
+		files.push_back(path);
+		return;
+	}
 
+	DIR* d = opendir(path.c_str());
+	if(!d) {
+		perror("opendir");
+		throw std::runtime_error("Could not open directory " + path);
+	}
+	std::vector<std::string> entries;
+	struct dirent* e;
+	while((e = readdir(d)) != NULL) {
+		if(e->d_name[0] == '.')
+			continue;
+		entries.push_back(path + "/" + e->d_name);
+	}
+	closedir(d);
+	std::sort(entries.begin(), entries.end());
+	for(auto& fn : entries) {
+		if(stat(fn.c_str(), &st) == 0 && (S_ISDIR(st.st_mode) || isMatchFile(fn)))
+			findMatchDataFiles(fn, files);
+	}
+}
+
+std::string DataExchange::readFile(const char* fn)
+{
+	std::ifstream ifs(fn, std::ios::in | std::ios::binary);
+	if(!ifs)
+		throw std::runtime_error(std::string("Could not open ") + fn);
+
+	// detect compression by the magic bytes rather than the file name
+	char magic[3] = { 0, 0, 0 };
+	ifs.read(magic, sizeof(magic));
+	ifs.clear();
+	ifs.seekg(0);
+
+	boost::iostreams::filtering_istream in;
+	if(magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h')
+		in.push(boost::iostreams::bzip2_decompressor());
+	else if(magic[0] == '\x1f' && magic[1] == '\x8b')
+		in.push(boost::iostreams::gzip_decompressor());
+	in.push(ifs);
+
+	std::ostringstream data;
+	try {
+		boost::iostreams::copy(in, data);
+	}
+	catch(std::exception& e) {
+		throw std::runtime_error(std::string("Could not read ") + fn + ": " + e.what());
+	}
+	return data.str();
+}
+
+void DataExchange::writeFile(const char* fn, const std::string& data)
+{
+	std::ofstream ofs(fn, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!ofs)
+		throw std::runtime_error(std::string("Could not open ") + fn);
+
+	{
+		boost::iostreams::filtering_ostream out;
+		if(hasSuffix(fn, ".bz2"))
+			out.push(boost::iostreams::bzip2_compressor());
+		else if(hasSuffix(fn, ".gz"))
+			out.push(boost::iostreams::gzip_compressor());
+		out.push(ofs);
+		out.write(data.data(), data.size());
+	}
+	if(!ofs)
+		throw std::runtime_error(std::string("Could not write ") + fn);
+}
+
+static const char MatchDataMagic[] = "FKMD";
+static const unsigned char MatchDataVersion = 1;
+
+boost::shared_ptr<Match> DataExchange::parseMatchDataFile(const char* fn, MatchDataFormat* format)
+{
+	std::string data = readFile(fn);
+	try {
+		return parseMatchData(data, format);
+	}
+	catch(std::exception& e) {
+		throw std::runtime_error(std::string("Error parsing match file ") + fn + ": " + e.what());
+	}
+}
+
+boost::shared_ptr<Match> DataExchange::parseMatchData(const std::string& data, MatchDataFormat* format)
+{
+	if(data.compare(0, 4, MatchDataMagic) == 0) {
+		if(format)
+			*format = MatchDataFormat::Binary;
+		return parseMatchDataBinary(data);
+	}
+
+	TiXmlDocument doc;
+	std::string err("Error parsing match data");
+
+	doc.Parse(data.c_str(), 0, TIXML_ENCODING_UTF8);
+	if(doc.Error())
+		throw std::runtime_error(err + ": " + doc.ErrorDesc());
+
+	if(format)
+		*format = MatchDataFormat::XML;
+	return parseMatchData(doc, err);
+}
+
+boost::shared_ptr<Match> DataExchange::parseMatchDataBinary(const std::string& data)
+{
+	if(data.size() < 5 || (unsigned char)data[4] != MatchDataVersion)
+		throw std::runtime_error("Unsupported binary match data version");
+
+	std::istringstream is(data.substr(5));
+	Match* m = nullptr;
+	try {
+		boost::archive::binary_iarchive ia(is);
+		ia >> m;
+	}
+	catch(std::exception& e) {
+		throw std::runtime_error(std::string("Error parsing binary match data: ") + e.what());
+	}
+	return boost::shared_ptr<Match>(m);
+}
+
+std::string DataExchange::createMatchDataBinary(const Match& m)
+{
+	std::ostringstream os;
+	os.write(MatchDataMagic, 4);
+	os.put(MatchDataVersion);
+	{
+		boost::archive::binary_oarchive oa(os);
+		const Match* mp = &m;
+		oa << mp;
+	}
+	return os.str();
+}
+
+boost::shared_ptr<Match> DataExchange::parseMatchData(TiXmlDocument& doc, const std::string& err)
+{
 	TiXmlHandle handle(&doc);
 
 	TiXmlElement* teamelem = handle.FirstChild("Match").FirstChild("Teams").FirstChild("Team").ToElement();
 	if(!teamelem)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	std::vector<boost::shared_ptr<Team>> teams;
 
 	for(; teamelem; teamelem = teamelem->NextSiblingElement()) {
 		if(teams.size() > 2) {
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		}
 		teams.push_back(parseTeam(teamelem, 0));
 	}
 	if(teams.size() != 2) {
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 	}
 
 	const TiXmlElement* matchreselem = handle.FirstChild("Match").FirstChild("MatchResult").ToElement();
 	if(!matchreselem)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	MatchResult mres;
 	int played;
 
 	if(matchreselem->QueryIntAttribute("played", &played) != TIXML_SUCCESS)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 	mres.Played = played;
 
 	if(mres.Played) {
 		if(matchreselem->QueryUnsignedAttribute("home", &mres.HomeGoals) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		if(matchreselem->QueryUnsignedAttribute("away", &mres.AwayGoals) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		if(matchreselem->QueryUnsignedAttribute("homePenalties", &mres.HomePenalties) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		if(matchreselem->QueryUnsignedAttribute("awayPenalties", &mres.AwayPenalties) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
+		const TiXmlElement* statselem = matchreselem->FirstChildElement("Statistics");
+		if(statselem)
+			mres.Statistics = parseMatchStatistics(statselem);
 	}
 
 	TiXmlElement* controllerelem = handle.FirstChild("Match").FirstChild("Controllers").FirstChild("Controller").ToElement();
 	if(!controllerelem)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	std::vector<TeamController> tcs;
 
 	for(; controllerelem; controllerelem = controllerelem->NextSiblingElement()) {
 		if(tcs.size() > 2) {
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		}
 		int plnum;
 		std::string controller;
 		if(controllerelem->QueryIntAttribute("number", &plnum) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		if(controllerelem->QueryStringAttribute("controller", &controller) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		if(controller == "human")
 			tcs.push_back(TeamController(true, plnum));
 		else
 			tcs.push_back(TeamController(false, 0));
 	}
 	if(tcs.size() != 2) {
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 	}
 
 	std::vector<TeamTactics> tt;
 
 	TiXmlElement* tacticelem = handle.FirstChild("Match").FirstChild("TeamTactics").FirstChild("Team").ToElement();
 	if(!tacticelem)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	for(; tacticelem; tacticelem = tacticelem->NextSiblingElement()) {
 		if(tt.size() > 2) {
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 		}
 		tt.push_back(parseTactics(tacticelem));
 	}
 	if(tt.size() != 2) {
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 	}
 
 	const TiXmlElement* matchruleselem = handle.FirstChild("Match").FirstChild("MatchRules").ToElement();
 	if(!matchruleselem)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	int et, pen, awaygoals;
 	int homeagg = 0, awayagg = 0;
 
 	if(matchruleselem->QueryIntAttribute("et", &et) != TIXML_SUCCESS)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	if(matchruleselem->QueryIntAttribute("pen", &pen) != TIXML_SUCCESS)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	if(matchruleselem->QueryIntAttribute("awaygoals", &awaygoals) != TIXML_SUCCESS)
-		throw std::runtime_error(ss.str());
+		throw std::runtime_error(err);
 
 	if(awaygoals) {
 		if(matchruleselem->QueryIntAttribute("homeaggregate", &homeagg) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 
 		if(matchruleselem->QueryIntAttribute("awayaggregate", &awayagg) != TIXML_SUCCESS)
-			throw std::runtime_error(ss.str());
+			throw std::runtime_error(err);
 	}
 
 	boost::shared_ptr<Match> m(new Match(boost::shared_ptr<StatefulTeam>(new StatefulTeam(*teams[0], tcs[0], tt[0])),
@@ -426,6 +593,72 @@ TiXmlElement* DataExchange::createPlayerElement(const Player& p)
 	return playerelem;
 }
 
+boost::shared_ptr<MatchStatistics> DataExchange::parseMatchStatistics(const TiXmlElement* elem)
+{
+	boost::shared_ptr<MatchStatistics> stats(new MatchStatistics());
+	int i = 0;
+	for(const TiXmlElement* teamelem = elem->FirstChildElement("TeamStatistics");
+			teamelem; teamelem = teamelem->NextSiblingElement()) {
+		if(i > 1)
+			throw std::runtime_error("Error parsing match statistics (too many teams)");
+		TeamStatistics& ts = stats->Teams[i];
+		if(teamelem->QueryFloatAttribute("possession", &ts.Possession) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("passesAttempted", &ts.PassesAttempted) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("passesCompleted", &ts.PassesCompleted) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("shotsOnTarget", &ts.ShotsOnTarget) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("shotsOffTarget", &ts.ShotsOffTarget) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("tackles", &ts.Tackles) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("corners", &ts.Corners) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("goalKicks", &ts.GoalKicks) != TIXML_SUCCESS ||
+				teamelem->QueryUnsignedAttribute("throwIns", &ts.ThrowIns) != TIXML_SUCCESS ||
+				teamelem->QueryFloatAttribute("defensiveThird", &ts.TimeInThird[0]) != TIXML_SUCCESS ||
+				teamelem->QueryFloatAttribute("middleThird", &ts.TimeInThird[1]) != TIXML_SUCCESS ||
+				teamelem->QueryFloatAttribute("attackingThird", &ts.TimeInThird[2]) != TIXML_SUCCESS)
+			throw std::runtime_error("Error parsing team statistics");
+
+		for(const TiXmlElement* plelem = teamelem->FirstChildElement("Player");
+				plelem; plelem = plelem->NextSiblingElement()) {
+			int id;
+			float distance;
+			if(plelem->QueryIntAttribute("id", &id) != TIXML_SUCCESS ||
+					plelem->QueryFloatAttribute("distance", &distance) != TIXML_SUCCESS)
+				throw std::runtime_error("Error parsing player statistics");
+			ts.PlayerDistance[id] = distance;
+		}
+		i++;
+	}
+	return stats;
+}
+
+TiXmlElement* DataExchange::createMatchStatisticsElement(const MatchStatistics& s)
+{
+	TiXmlElement* statselem = new TiXmlElement("Statistics");
+	for(int i = 0; i < 2; i++) {
+		const TeamStatistics& ts = s.Teams[i];
+		TiXmlElement* teamelem = new TiXmlElement("TeamStatistics");
+		teamelem->SetDoubleAttribute("possession", ts.Possession);
+		teamelem->SetAttribute("passesAttempted", ts.PassesAttempted);
+		teamelem->SetAttribute("passesCompleted", ts.PassesCompleted);
+		teamelem->SetAttribute("shotsOnTarget", ts.ShotsOnTarget);
+		teamelem->SetAttribute("shotsOffTarget", ts.ShotsOffTarget);
+		teamelem->SetAttribute("tackles", ts.Tackles);
+		teamelem->SetAttribute("corners", ts.Corners);
+		teamelem->SetAttribute("goalKicks", ts.GoalKicks);
+		teamelem->SetAttribute("throwIns", ts.ThrowIns);
+		teamelem->SetDoubleAttribute("defensiveThird", ts.TimeInThird[0]);
+		teamelem->SetDoubleAttribute("middleThird", ts.TimeInThird[1]);
+		teamelem->SetDoubleAttribute("attackingThird", ts.TimeInThird[2]);
+		for(auto& pd : ts.PlayerDistance) {
+			TiXmlElement* plelem = new TiXmlElement("Player");
+			plelem->SetAttribute("id", pd.first);
+			plelem->SetDoubleAttribute("distance", pd.second);
+			teamelem->LinkEndChild(plelem);
+		}
+		statselem->LinkEndChild(teamelem);
+	}
+	return statselem;
+}
+
 TiXmlDocument DataExchange::createMatchData(const Match& m)
 {
 	TiXmlDocument doc;
@@ -441,7 +674,8 @@ TiXmlDocument DataExchange::createMatchData(const Match& m)
 
 	TiXmlElement* teamtacticselem = new TiXmlElement("TeamTactics");
 	for(int i = 0; i < 2; i++) {
-		TiXmlElement* tacticelem = createTeamTacticsElement(m.getTeam(i)->getTactics());
+		const StatefulTeam& t = *m.getTeam(i);
+		TiXmlElement* tacticelem = createTeamTacticsElement(t.getTactics());
 		teamtacticselem->LinkEndChild(tacticelem);
 	}
 	matchelem->LinkEndChild(teamtacticselem);
@@ -452,6 +686,8 @@ TiXmlDocument DataExchange::createMatchData(const Match& m)
 	matchresultelem->SetAttribute("away", m.getResult().AwayGoals);
 	matchresultelem->SetAttribute("homePenalties", m.getResult().HomePenalties);
 	matchresultelem->SetAttribute("awayPenalties", m.getResult().AwayPenalties);
+	if(m.getResult().Statistics)
+		matchresultelem->LinkEndChild(createMatchStatisticsElement(*m.getResult().Statistics));
 	matchelem->LinkEndChild(matchresultelem);
 
 	{
@@ -486,22 +722,104 @@ TiXmlDocument DataExchange::createMatchData(const Match& m)
 	return doc;
 }
 
-void DataExchange::createMatchDataFile(const Match& m, const char* fn)
+void DataExchange::createMatchDataFile(const Match& m, const char* fn, MatchDataFormat format)
 {
+	if(format == MatchDataFormat::Binary || hasSuffix(fn, ".bz2") || hasSuffix(fn, ".gz")) {
+		writeFile(fn, createMatchDataString(m, format));
+		return;
+	}
 	TiXmlDocument doc = createMatchData(m);
 	if(!doc.SaveFile(fn)) {
 		throw std::runtime_error(std::string("Unable to save XML file ") + fn);
 	}
 }
 
-void DataExchange::createMatchDataFile(const Match& m, FILE* file)
+void DataExchange::createMatchDataFile(const Match& m, FILE* file, MatchDataFormat format)
 {
+	if(format == MatchDataFormat::Binary) {
+		std::string data = createMatchDataBinary(m);
+		if(fwrite(data.data(), 1, data.size(), file) != data.size())
+			throw std::runtime_error(std::string("Unable to save match data file"));
+		return;
+	}
 	TiXmlDocument doc = createMatchData(m);
 	if(!doc.SaveFile(file)) {
 		throw std::runtime_error(std::string("Unable to save match data file"));
 	}
 }
 
+std::string DataExchange::createMatchDataString(const Match& m, MatchDataFormat format)
+{
+	if(format == MatchDataFormat::Binary)
+		return createMatchDataBinary(m);
+
+	TiXmlDocument doc = createMatchData(m);
+	TiXmlPrinter printer;
+	doc.Accept(&printer);
+	return std::string(printer.CStr());
+}
+
+std::string DataExchange::createMatchResultString(const MatchResult& r)
+{
+	std::ostringstream ss;
+	ss << "result " << r.Played << " " << r.HomeGoals << " " << r.AwayGoals << " " <<
+		r.HomePenalties << " " << r.AwayPenalties << "\n";
+	if(r.Statistics) {
+		for(int i = 0; i < 2; i++) {
+			const TeamStatistics& ts = r.Statistics->Teams[i];
+			ss << "statistics " << i << " " << ts.Possession << " " <<
+				ts.PassesAttempted << " " << ts.PassesCompleted << " " <<
+				ts.ShotsOnTarget << " " << ts.ShotsOffTarget << " " <<
+				ts.Tackles << " " << ts.Corners << " " << ts.GoalKicks << " " <<
+				ts.ThrowIns << " " << ts.TimeInThird[0] << " " <<
+				ts.TimeInThird[1] << " " << ts.TimeInThird[2];
+			for(auto& pd : ts.PlayerDistance)
+				ss << " " << pd.first << ":" << pd.second;
+			ss << "\n";
+		}
+	}
+	return ss.str();
+}
+
+MatchResult DataExchange::parseMatchResultString(const std::string& data)
+{
+	std::istringstream ss(data);
+	std::string line;
+	MatchResult r;
+	bool gotresult = false;
+	while(std::getline(ss, line)) {
+		std::istringstream ls(line);
+		std::string type;
+		ls >> type;
+		if(type == "result") {
+			if(!(ls >> r.Played >> r.HomeGoals >> r.AwayGoals >> r.HomePenalties >> r.AwayPenalties))
+				throw std::runtime_error("Error parsing match result");
+			gotresult = true;
+		}
+		else if(type == "statistics") {
+			int i;
+			if(!(ls >> i) || i < 0 || i > 1)
+				throw std::runtime_error("Error parsing match statistics");
+			if(!r.Statistics)
+				r.Statistics = boost::shared_ptr<MatchStatistics>(new MatchStatistics());
+			TeamStatistics& ts = r.Statistics->Teams[i];
+			if(!(ls >> ts.Possession >> ts.PassesAttempted >> ts.PassesCompleted >>
+						ts.ShotsOnTarget >> ts.ShotsOffTarget >> ts.Tackles >>
+						ts.Corners >> ts.GoalKicks >> ts.ThrowIns >>
+						ts.TimeInThird[0] >> ts.TimeInThird[1] >> ts.TimeInThird[2]))
+				throw std::runtime_error("Error parsing match statistics");
+			int id;
+			char colon;
+			float distance;
+			while(ls >> id >> colon >> distance)
+				ts.PlayerDistance[id] = distance;
+		}
+	}
+	if(!gotresult)
+		throw std::runtime_error("No match result found");
+	return r;
+}
+
 void DataExchange::updateTeamDatabase(const char* fn, TeamDatabase& db)
 {
 	TiXmlDocument doc(fn);
@@ -715,5 +1033,45 @@ void DataExchange::createPlayerDatabase(const char* fn, const PlayerDatabase& db
 	}
 }
 
+SimulationParameters DataExchange::parseSimulationParametersFile(const char* fn)
+{
+	TiXmlDocument doc(fn);
+	if(!doc.LoadFile(TIXML_ENCODING_UTF8)) {
+		throw std::runtime_error(std::string("Could not load XML file ") + fn);
+	}
+
+	const TiXmlElement* elem = doc.FirstChildElement("Simulation");
+	if(!elem)
+		throw std::runtime_error(std::string("Error parsing simulation parameters in ") + fn);
+
+	SimulationParameters p;
+	if(elem->QueryFloatAttribute("goalscale", &p.GoalScale) == TIXML_WRONG_TYPE ||
+			elem->QueryFloatAttribute("homeadvantage", &p.HomeAdvantage) == TIXML_WRONG_TYPE ||
+			elem->QueryFloatAttribute("skillexponent", &p.SkillExponent) == TIXML_WRONG_TYPE ||
+			elem->QueryFloatAttribute("variance", &p.Variance) == TIXML_WRONG_TYPE ||
+			elem->QueryFloatAttribute("wings", &p.Wings) == TIXML_WRONG_TYPE)
+		throw std::runtime_error(std::string("Error parsing simulation parameters in ") + fn);
+	if(p.GoalScale <= 0.0f || p.HomeAdvantage <= 0.0f || p.SkillExponent <= 0.0f)
+		throw std::runtime_error(std::string("Invalid simulation parameters in ") + fn);
+	return p;
+}
+
+void DataExchange::createSimulationParametersFile(const char* fn, const SimulationParameters& p)
+{
+	TiXmlDocument doc;
+	TiXmlDeclaration* decl = new TiXmlDeclaration("1.0", "", "");
+	TiXmlElement* elem = new TiXmlElement("Simulation");
+	elem->SetDoubleAttribute("goalscale", p.GoalScale);
+	elem->SetDoubleAttribute("homeadvantage", p.HomeAdvantage);
+	elem->SetDoubleAttribute("skillexponent", p.SkillExponent);
+	elem->SetDoubleAttribute("variance", p.Variance);
+	elem->SetDoubleAttribute("wings", p.Wings);
+	doc.LinkEndChild(decl);
+	doc.LinkEndChild(elem);
+	if(!doc.SaveFile(fn)) {
+		throw std::runtime_error(std::string("Unable to save XML file ") + fn);
+	}
+}
+
 
 }
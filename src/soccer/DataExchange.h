@@ -2,6 +2,8 @@
 #define SOCCER_DATAEXCHANGE_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include <tinyxml.h>
@@ -16,13 +18,45 @@ class Player;
 class Team;
 class TeamTactics;
 class TeamDatabase;
+struct MatchStatistics;
+struct MatchResult;
+struct SimulationParameters;
+
+// Match data can be exchanged as XML or in a compact binary format. The
+// readers detect the format; the binary format starts with "FKMD" and a
+// format version, followed by the boost serialization of the match.
+enum class MatchDataFormat {
+	XML,
+	Binary
+};
 
 class DataExchange {
 	public:
 		static boost::shared_ptr<Player> parsePlayer(const TiXmlElement* pelem);
-		static boost::shared_ptr<Match> parseMatchDataFile(const char* fn);
-		static void createMatchDataFile(const Match& m, const char* fn);
-		static void createMatchDataFile(const Match& m, FILE* file);
+		// match data files may be compressed with bzip2 or gzip. When
+		// writing, the compression is chosen by the .bz2 or .gz suffix.
+		// format, if given, is set to the format the data was in.
+		static boost::shared_ptr<Match> parseMatchDataFile(const char* fn,
+				MatchDataFormat* format = nullptr);
+		static boost::shared_ptr<Match> parseMatchData(const std::string& data,
+				MatchDataFormat* format = nullptr);
+		static void createMatchDataFile(const Match& m, const char* fn,
+				MatchDataFormat format = MatchDataFormat::XML);
+		static void createMatchDataFile(const Match& m, FILE* file,
+				MatchDataFormat format = MatchDataFormat::XML);
+		static std::string createMatchDataString(const Match& m,
+				MatchDataFormat format = MatchDataFormat::XML);
+		// only the result of a match, as a few lines of text:
+		// "result <played> <home> <away> <home penalties> <away penalties>"
+		// and, if collected, a "statistics <team> ..." line per team
+		static std::string createMatchResultString(const MatchResult& r);
+		static MatchResult parseMatchResultString(const std::string& data);
+		// adds the match data files (*.xml, *.xml.bz2 and *.xml.gz)
+		// under path, searching directories recursively, in sorted
+		// order. A path that isn't a directory is added as is.
+		static void findMatchDataFiles(const std::string& path, std::vector<std::string>& files);
+		static std::string readFile(const char* fn);
+		static void writeFile(const char* fn, const std::string& data);
 
 		static void updateTeamDatabase(const char* fn, TeamDatabase& db);
 		static void updatePlayerDatabase(const char* fn, PlayerDatabase& db);
@@ -33,10 +67,20 @@ class DataExchange {
 		static TeamTactics parseTactics(const TiXmlElement* elem);
 		static TiXmlElement* createTeamTacticsElement(const TeamTactics& t);
 
+		static boost::shared_ptr<MatchStatistics> parseMatchStatistics(const TiXmlElement* elem);
+		static TiXmlElement* createMatchStatisticsElement(const MatchStatistics& s);
+
+		// attributes missing from the file keep their default values
+		static SimulationParameters parseSimulationParametersFile(const char* fn);
+		static void createSimulationParametersFile(const char* fn, const SimulationParameters& p);
+
 		static void createTeamDatabase(const char* fn, const TeamDatabase& db);
 		static void createPlayerDatabase(const char* fn, const PlayerDatabase& db);
 
 	private:
+		static boost::shared_ptr<Match> parseMatchData(TiXmlDocument& doc, const std::string& err);
+		static boost::shared_ptr<Match> parseMatchDataBinary(const std::string& data);
+		static std::string createMatchDataBinary(const Match& m);
 		static TiXmlDocument createMatchData(const Match& m);
 };
 
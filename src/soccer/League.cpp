@@ -5,6 +5,7 @@
 #include "soccer/League.h"
 #include "soccer/Match.h"
 #include "soccer/Team.h"
+#include "soccer/Log.h"
 
 namespace Soccer {
 
@@ -24,6 +25,11 @@ unsigned int StatefulLeague::getLevel() const
 	return mLevel;
 }
 
+int StatefulLeague::getPointsPerWin() const
+{
+	return mPointsPerWin;
+}
+
 void StatefulLeague::resetTeams(std::vector<boost::shared_ptr<StatefulTeam>>& teams)
 {
 	setRoundRobin(teams);
@@ -35,6 +41,8 @@ void StatefulLeague::matchPlayed(const MatchResult& res)
 	assert(mNextMatch);
 	assert(res.Played);
 
+	setNextMatchResult(res);
+
 	auto meit1 = mEntries.find(mNextMatch->getTeam(0));
 	auto meit2 = mEntries.find(mNextMatch->getTeam(1));
 	assert(meit1 != mEntries.end());
@@ -63,6 +71,7 @@ void StatefulLeague::matchPlayed(const MatchResult& res)
 		meit1->second.Draws++;
 		meit2->second.Draws++;
 	}
+	updateRanking(meit1->first, meit2->first);
 	setNextMatch();
 }
 
@@ -77,6 +86,7 @@ void StatefulLeague::setRoundRobin(std::vector<boost::shared_ptr<StatefulTeam>>&
 	for(auto t : teams) {
 		mEntries.insert(std::make_pair(t, LeagueEntry()));
 	}
+	sortRanking();
 
 	if((teams.size() & 1) != 0) {
 		// add dummy team
@@ -103,10 +113,10 @@ void StatefulLeague::setRoundRobin(std::vector<boost::shared_ptr<StatefulTeam>>&
 					}
 
 					r.addMatch(boost::shared_ptr<Match>(new Match(teams[ind1], teams[ind2], MatchRules(false, false, false))));
-					printf("%5d-%-5d ", teams[ind1]->getId(), teams[ind2]->getId());
+					LOG_TRACE(Competition, "%5d-%-5d ", teams[ind1]->getId(), teams[ind2]->getId());
 				}
 			}
-			printf("\n");
+			LOG_TRACE(Competition, "\n");
 			mSchedule.addRound(r);
 			std::rotate(teams.begin() + 1, teams.begin() + 2, teams.end());
 		}
@@ -123,6 +133,11 @@ StatefulLeague::StatefulLeague()
 {
 }
 
+boost::shared_ptr<StatefulCompetition> StatefulLeague::clone() const
+{
+	return boost::shared_ptr<StatefulCompetition>(new StatefulLeague(*this));
+}
+
 CompetitionType StatefulLeague::getType() const
 {
 	return CompetitionType::League;
@@ -133,29 +148,83 @@ unsigned int StatefulLeague::getNumberOfTeams() const
 	return mEntries.size();
 }
 
+bool StatefulLeague::ranksBefore(const boost::shared_ptr<StatefulTeam>& t1,
+		const boost::shared_ptr<StatefulTeam>& t2) const
+{
+	const LeagueEntry& e1 = mEntries.find(t1)->second;
+	const LeagueEntry& e2 = mEntries.find(t2)->second;
+	if(e1.Points != e2.Points)
+		return e1.Points > e2.Points;
+	int gd1 = e1.GoalsFor - e1.GoalsAgainst;
+	int gd2 = e2.GoalsFor - e2.GoalsAgainst;
+	if(gd1 != gd2)
+		return gd1 > gd2;
+	if(e1.GoalsFor != e2.GoalsFor)
+		return e1.GoalsFor > e2.GoalsFor;
+	return strcmp(t1->getName().c_str(), t2->getName().c_str()) < 0;
+}
+
+void StatefulLeague::sortRanking()
+{
+	mRanking.clear();
+	for(auto& e : mEntries)
+		mRanking.push_back(e.first);
+	std::sort(mRanking.begin(), mRanking.end(),
+			[&](const boost::shared_ptr<StatefulTeam>& t1, const boost::shared_ptr<StatefulTeam>& t2) {
+			return ranksBefore(t1, t2); });
+
+	mPositions.clear();
+	for(unsigned int i = 0; i < mRanking.size(); i++)
+		mPositions[mRanking[i]] = i;
+}
+
+bool StatefulLeague::moveTeam(const boost::shared_ptr<StatefulTeam>& t)
+{
+	unsigned int pos = mPositions[t];
+	unsigned int i = pos;
+	while(i > 0 && ranksBefore(mRanking[i], mRanking[i - 1])) {
+		std::swap(mRanking[i], mRanking[i - 1]);
+		mPositions[mRanking[i]] = i;
+		i--;
+	}
+	while(i + 1 < mRanking.size() && ranksBefore(mRanking[i + 1], mRanking[i])) {
+		std::swap(mRanking[i], mRanking[i + 1]);
+		mPositions[mRanking[i]] = i;
+		i++;
+	}
+	mPositions[t] = i;
+	return i != pos;
+}
+
+void StatefulLeague::updateRanking(const boost::shared_ptr<StatefulTeam>& t1,
+		const boost::shared_ptr<StatefulTeam>& t2)
+{
+	// the rest of the table is still in order, so once neither team
+	// moves the whole table is
+	bool moved = true;
+	while(moved) {
+		moved = moveTeam(t1);
+		if(moveTeam(t2))
+			moved = true;
+	}
+}
+
 std::vector<boost::shared_ptr<StatefulTeam>> StatefulLeague::getTeamsByPosition() const
 {
-	std::vector<std::pair<boost::shared_ptr<StatefulTeam>, LeagueEntry>> ves(mEntries.begin(), mEntries.end());
-	std::sort(ves.begin(), ves.end(), [](const std::pair<boost::shared_ptr<StatefulTeam>, LeagueEntry>& p1,
-				const std::pair<boost::shared_ptr<StatefulTeam>, LeagueEntry>& p2) -> bool {
-			if(p1.second.Points != p2.second.Points)
-				return p1.second.Points > p2.second.Points;
-			int gd1 = p1.second.GoalsFor - p1.second.GoalsAgainst;
-			int gd2 = p2.second.GoalsFor - p2.second.GoalsAgainst;
-			if(gd1 != gd2)
-				return gd1 > gd2;
-			if(p1.second.GoalsFor != p2.second.GoalsFor)
-				return p1.second.GoalsFor > p2.second.GoalsFor;
-			return strcmp(p1.first->getName().c_str(),
-				p2.first->getName().c_str()) < 0;
-			});
-
-	std::vector<boost::shared_ptr<StatefulTeam>> res;
-	for(auto t : ves)
-		res.push_back(t.first);
-	return res;
+	return mRanking;
+}
+
+const std::vector<boost::shared_ptr<StatefulTeam>>& StatefulLeague::getRanking() const
+{
+	return mRanking;
 }
 
+unsigned int StatefulLeague::getPosition(const boost::shared_ptr<StatefulTeam>& t) const
+{
+	auto it = mPositions.find(t);
+	assert(it != mPositions.end());
+	return it->second;
+}
 
 }
 
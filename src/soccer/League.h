@@ -54,11 +54,27 @@ class StatefulLeague : public StatefulCompetition {
 		virtual CompetitionType getType() const override;
 		virtual unsigned int getNumberOfTeams() const override;
 		virtual std::vector<boost::shared_ptr<StatefulTeam>> getTeamsByPosition() const override;
+		virtual boost::shared_ptr<StatefulCompetition> clone() const override;
+		// as getTeamsByPosition() but without copying
+		const std::vector<boost::shared_ptr<StatefulTeam>>& getRanking() const;
+		// 0 is the first place
+		unsigned int getPosition(const boost::shared_ptr<StatefulTeam>& t) const;
 		unsigned int getLevel() const;
+		int getPointsPerWin() const;
 
 	private:
 		void setRoundRobin(std::vector<boost::shared_ptr<StatefulTeam>>& teams);
+		bool ranksBefore(const boost::shared_ptr<StatefulTeam>& t1,
+				const boost::shared_ptr<StatefulTeam>& t2) const;
+		void sortRanking();
+		bool moveTeam(const boost::shared_ptr<StatefulTeam>& t);
+		void updateRanking(const boost::shared_ptr<StatefulTeam>& t1,
+				const boost::shared_ptr<StatefulTeam>& t2);
 		std::map<boost::shared_ptr<StatefulTeam>, LeagueEntry> mEntries;
+		// the table, kept sorted by matchPlayed(). A result only moves
+		// the two teams by a few places.
+		std::vector<boost::shared_ptr<StatefulTeam>> mRanking;
+		std::map<boost::shared_ptr<StatefulTeam>, unsigned int> mPositions;
 		const int mPointsPerWin;
 		const unsigned int mNumCycles;
 		const int mLevel;
@@ -73,6 +89,8 @@ class StatefulLeague : public StatefulCompetition {
 			ar & mEntries;
 			ar & const_cast<int&>(mPointsPerWin);
 			ar & const_cast<unsigned int&>(mNumCycles);
+			if(Archive::is_loading::value)
+				sortRanking();
 		}
 };
 
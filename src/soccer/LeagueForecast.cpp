@@ -0,0 +1,182 @@
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "soccer/LeagueForecast.h"
+#include "soccer/League.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+
+namespace Soccer {
+
+LeagueForecast::LeagueForecast(const StatefulLeague& l, unsigned int promoted, unsigned int relegated)
+	: mTeams(l.getRanking()),
+	mPromoted(promoted),
+	mRelegated(relegated),
+	mPointsPerWin(l.getPointsPerWin()),
+	mIterations(0)
+{
+	std::map<boost::shared_ptr<StatefulTeam>, unsigned short> indices;
+	for(unsigned int i = 0; i < mTeams.size(); i++) {
+		const LeagueEntry& e = l.getEntries().find(mTeams[i])->second;
+		TableEntry te;
+		te.Points = e.Points;
+		te.GoalDifference = e.GoalsFor - e.GoalsAgainst;
+		te.GoalsFor = e.GoalsFor;
+		mTable.push_back(te);
+		mProfiles.push_back(mTeams[i]->getSimulationProfile());
+		indices[mTeams[i]] = i;
+	}
+
+	// the last tie breaker is the team name, as in getTeamsByPosition()
+	std::vector<unsigned int> byname(mTeams.size());
+	for(unsigned int i = 0; i < byname.size(); i++)
+		byname[i] = i;
+	std::sort(byname.begin(), byname.end(), [&](unsigned int a, unsigned int b) {
+			return strcmp(mTeams[a]->getName().c_str(), mTeams[b]->getName().c_str()) < 0; });
+	mNameOrder.resize(mTeams.size());
+	for(unsigned int i = 0; i < byname.size(); i++)
+		mNameOrder[byname[i]] = i;
+
+	const Schedule& s = l.getSchedule();
+	for(auto& sf : s.getFixtures()) {
+		if(sf.Flags & Schedule::Fixture::ResultPlayed)
+			continue;
+		Fixture f;
+		f.Home = indices[s.getTeam(sf.Home)];
+		f.Away = indices[s.getTeam(sf.Away)];
+		mFixtures.push_back(f);
+	}
+
+	mCounts.resize(mTeams.size() * mTeams.size(), 0);
+}
+
+void LeagueForecast::run(unsigned int iterations, unsigned int numthreads, unsigned int seed)
+{
+	if(numthreads == 0)
+		numthreads = std::max(1u, std::thread::hardware_concurrency());
+	numthreads = std::max(1u, std::min(numthreads, iterations));
+
+	std::vector<std::vector<unsigned int>> counts(numthreads,
+			std::vector<unsigned int>(mCounts.size(), 0));
+	std::vector<std::thread> threads;
+	for(unsigned int t = 0; t < numthreads; t++) {
+		unsigned int n = iterations / numthreads + (t < iterations % numthreads ? 1 : 0);
+		threads.push_back(std::thread(&LeagueForecast::work, this, n, seed, t, std::ref(counts[t])));
+	}
+	for(auto& t : threads)
+		t.join();
+
+	for(auto& c : counts)
+		for(unsigned int i = 0; i < mCounts.size(); i++)
+			mCounts[i] += c[i];
+	mIterations += iterations;
+}
+
+void LeagueForecast::work(unsigned int iterations, unsigned int seed, unsigned int threadnum,
+		std::vector<unsigned int>& counts) const
+{
+	// one generator per thread, so that the threads don't need to share
+	// state and the results are reproducible
+	std::seed_seq seq{seed, threadnum};
+	std::mt19937 rng(seq);
+	const MatchRules rules(false, false, false);
+	const unsigned int numteams = mTeams.size();
+
+	// allocated once, reused for each iteration
+	std::vector<TableEntry> table(numteams);
+	std::vector<unsigned int> order(numteams);
+
+	for(unsigned int it = 0; it < iterations; it++) {
+		std::copy(mTable.begin(), mTable.end(), table.begin());
+
+		for(auto& f : mFixtures) {
+			MatchResult r = SimulationStrength::simulate(*mProfiles[f.Home], *mProfiles[f.Away],
+					rules, rng);
+			TableEntry& home = table[f.Home];
+			TableEntry& away = table[f.Away];
+			int diff = (int)r.HomeGoals - (int)r.AwayGoals;
+			home.GoalDifference += diff;
+			away.GoalDifference -= diff;
+			home.GoalsFor += r.HomeGoals;
+			away.GoalsFor += r.AwayGoals;
+			if(diff > 0)
+				home.Points += mPointsPerWin;
+			else if(diff < 0)
+				away.Points += mPointsPerWin;
+			else {
+				home.Points++;
+				away.Points++;
+			}
+		}
+
+		for(unsigned int i = 0; i < numteams; i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) -> bool {
+				const TableEntry& e1 = table[a];
+				const TableEntry& e2 = table[b];
+				if(e1.Points != e2.Points)
+					return e1.Points > e2.Points;
+				if(e1.GoalDifference != e2.GoalDifference)
+					return e1.GoalDifference > e2.GoalDifference;
+				if(e1.GoalsFor != e2.GoalsFor)
+					return e1.GoalsFor > e2.GoalsFor;
+				return mNameOrder[a] < mNameOrder[b];
+				});
+		for(unsigned int i = 0; i < numteams; i++)
+			counts[order[i] * numteams + i]++;
+	}
+}
+
+const std::vector<boost::shared_ptr<StatefulTeam>>& LeagueForecast::getTeams() const
+{
+	return mTeams;
+}
+
+unsigned int LeagueForecast::getNumberOfIterations() const
+{
+	return mIterations;
+}
+
+unsigned int LeagueForecast::getNumberOfRemainingMatches() const
+{
+	return mFixtures.size();
+}
+
+float LeagueForecast::getPositionProbability(unsigned int team, unsigned int pos) const
+{
+	return getRangeProbability(team, pos, pos + 1);
+}
+
+float LeagueForecast::getRangeProbability(unsigned int team, unsigned int first, unsigned int last) const
+{
+	if(!mIterations || team >= mTeams.size())
+		return 0.0f;
+	last = std::min<unsigned int>(last, mTeams.size());
+	unsigned int n = 0;
+	for(unsigned int i = first; i < last; i++)
+		n += mCounts[team * mTeams.size() + i];
+	return n / (float)mIterations;
+}
+
+float LeagueForecast::getTitleProbability(unsigned int team) const
+{
+	return getRangeProbability(team, 0, 1);
+}
+
+float LeagueForecast::getPromotionProbability(unsigned int team) const
+{
+	return getRangeProbability(team, 0, mPromoted);
+}
+
+float LeagueForecast::getRelegationProbability(unsigned int team) const
+{
+	unsigned int n = std::min<unsigned int>(mRelegated, mTeams.size());
+	return getRangeProbability(team, mTeams.size() - n, mTeams.size());
+}
+
+}
+
@@ -0,0 +1,68 @@
+#ifndef SOCCER_LEAGUEFORECAST_H
+#define SOCCER_LEAGUEFORECAST_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace Soccer {
+
+class StatefulLeague;
+class StatefulTeam;
+struct SimulationProfile;
+
+// Estimates the final table of a league by simulating the remaining
+// matches many times with the statistical match model, starting from the
+// current table. The league itself isn't changed.
+class LeagueForecast {
+	public:
+		// the top promoted and bottom relegated teams are counted as
+		// promoted and relegated
+		LeagueForecast(const StatefulLeague& l, unsigned int promoted = 0, unsigned int relegated = 0);
+		// numthreads 0: number of CPUs. The result only depends on the
+		// seed and the number of threads.
+		void run(unsigned int iterations, unsigned int numthreads = 0, unsigned int seed = 1);
+
+		// in the order of the current table
+		const std::vector<boost::shared_ptr<StatefulTeam>>& getTeams() const;
+		unsigned int getNumberOfIterations() const;
+		unsigned int getNumberOfRemainingMatches() const;
+		// pos 0 is the first place
+		float getPositionProbability(unsigned int team, unsigned int pos) const;
+		float getTitleProbability(unsigned int team) const;
+		float getPromotionProbability(unsigned int team) const;
+		float getRelegationProbability(unsigned int team) const;
+
+	private:
+		struct TableEntry {
+			int Points;
+			int GoalDifference;
+			int GoalsFor;
+		};
+
+		struct Fixture {
+			unsigned short Home;
+			unsigned short Away;
+		};
+
+		void work(unsigned int iterations, unsigned int seed, unsigned int threadnum,
+				std::vector<unsigned int>& counts) const;
+		float getRangeProbability(unsigned int team, unsigned int first, unsigned int last) const;
+
+		std::vector<boost::shared_ptr<StatefulTeam>> mTeams;
+		std::vector<boost::shared_ptr<const SimulationProfile>> mProfiles;
+		std::vector<TableEntry> mTable;
+		std::vector<unsigned int> mNameOrder;
+		std::vector<Fixture> mFixtures;
+		unsigned int mPromoted;
+		unsigned int mRelegated;
+		int mPointsPerWin;
+
+		// number of times team i finished in position j: i * teams + j
+		std::vector<unsigned int> mCounts;
+		unsigned int mIterations;
+};
+
+}
+
+#endif
+
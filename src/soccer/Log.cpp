@@ -0,0 +1,252 @@
+#include <stdarg.h>
+#include <string.h>
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "soccer/Log.h"
+
+namespace Soccer {
+
+namespace {
+
+const char* LevelNames[] = { "trace", "debug", "info", "warning", "error", "none" };
+const char* CategoryNames[] = { "general", "match", "ai", "referee", "tactics",
+	"competition", "simulation", "performance" };
+
+static_assert(sizeof(CategoryNames) / sizeof(CategoryNames[0]) == (int)LogCategory::NumCategories,
+		"log category names out of sync");
+
+// Log lines are appended to a front buffer by the callers and written out
+// by a background thread, so that the simulating threads never wait on I/O
+// unless the buffer fills up.
+class LogSink {
+	public:
+		LogSink();
+		~LogSink();
+		void write(const char* buf, size_t len);
+		void flush();
+		void setOutput(FILE* f);
+
+	private:
+		void start();
+		void run();
+
+		static const size_t MaxBufferSize = 1 << 20;
+
+		std::mutex mMutex;
+		std::condition_variable mDataAvailable;
+		std::condition_variable mDataWritten;
+		std::string mFront;
+		std::string mBack;
+		FILE* mOutput;
+		bool mRunning;
+		bool mQuit;
+		bool mWriting;
+		std::thread mThread;
+};
+
+LogSink::LogSink()
+	: mOutput(stdout),
+	mRunning(false),
+	mQuit(false),
+	mWriting(false)
+{
+}
+
+LogSink::~LogSink()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if(!mRunning)
+			return;
+		mQuit = true;
+	}
+	mDataAvailable.notify_one();
+	mThread.join();
+}
+
+void LogSink::start()
+{
+	mRunning = true;
+	mFront.reserve(MaxBufferSize);
+	mBack.reserve(MaxBufferSize);
+	mThread = std::thread(&LogSink::run, this);
+}
+
+void LogSink::write(const char* buf, size_t len)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if(!mRunning)
+		start();
+	while(mFront.size() + len > MaxBufferSize && !mFront.empty()) {
+		mDataAvailable.notify_one();
+		mDataWritten.wait(lock);
+	}
+	bool wasEmpty = mFront.empty();
+	mFront.append(buf, len);
+	if(wasEmpty)
+		mDataAvailable.notify_one();
+}
+
+void LogSink::flush()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if(!mRunning)
+		return;
+	while(!mFront.empty() || mWriting) {
+		mDataAvailable.notify_one();
+		mDataWritten.wait(lock);
+	}
+}
+
+void LogSink::setOutput(FILE* f)
+{
+	flush();
+	std::unique_lock<std::mutex> lock(mMutex);
+	mOutput = f;
+}
+
+void LogSink::run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(1) {
+		while(mFront.empty() && !mQuit)
+			mDataAvailable.wait(lock);
+		if(mFront.empty() && mQuit)
+			break;
+
+		mBack.swap(mFront);
+		mWriting = true;
+		FILE* out = mOutput;
+		lock.unlock();
+
+		fwrite(mBack.data(), 1, mBack.size(), out);
+		fflush(out);
+		mBack.clear();
+
+		lock.lock();
+		mWriting = false;
+		mDataWritten.notify_all();
+	}
+}
+
+LogSink& sink()
+{
+	static LogSink s;
+	return s;
+}
+
+bool parseLevel(const std::string& s, LogLevel& l)
+{
+	for(int i = 0; i <= (int)LogLevel::None; i++) {
+		if(s == LevelNames[i]) {
+			l = (LogLevel)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool parseCategory(const std::string& s, LogCategory& c)
+{
+	for(int i = 0; i < (int)LogCategory::NumCategories; i++) {
+		if(s == CategoryNames[i]) {
+			c = (LogCategory)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+}
+
+unsigned char Log::mLevels[(int)LogCategory::NumCategories] = {
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+	(unsigned char)LogLevel::Info,
+};
+
+void Log::write(LogCategory c, LogLevel l, const char* fmt, ...)
+{
+	char buf[1024];
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	if(len < 0)
+		return;
+	if(len >= (int)sizeof(buf)) {
+		len = sizeof(buf) - 1;
+		buf[len - 1] = '\n';
+	}
+	sink().write(buf, len);
+	if(l >= LogLevel::Error)
+		sink().flush();
+}
+
+void Log::setLevel(LogLevel l)
+{
+	for(int i = 0; i < (int)LogCategory::NumCategories; i++)
+		mLevels[i] = (unsigned char)l;
+}
+
+void Log::setLevel(LogCategory c, LogLevel l)
+{
+	mLevels[(int)c] = (unsigned char)l;
+}
+
+bool Log::configure(const std::string& spec)
+{
+	size_t pos = 0;
+	while(pos <= spec.size()) {
+		size_t end = spec.find(',', pos);
+		if(end == std::string::npos)
+			end = spec.size();
+		std::string item = spec.substr(pos, end - pos);
+		pos = end + 1;
+		if(item.empty())
+			continue;
+
+		size_t eq = item.find('=');
+		LogLevel l;
+		if(eq == std::string::npos) {
+			if(!parseLevel(item, l))
+				return false;
+			setLevel(l);
+		} else {
+			LogCategory c;
+			if(!parseCategory(item.substr(0, eq), c) ||
+					!parseLevel(item.substr(eq + 1), l))
+				return false;
+			setLevel(c, l);
+		}
+	}
+	return true;
+}
+
+void Log::setOutput(FILE* f)
+{
+	sink().setOutput(f);
+}
+
+void Log::flush()
+{
+	sink().flush();
+}
+
+const char* Log::usage()
+{
+	return "\tlog spec: comma separated list of <level> or <category>=<level>\n"
+		"\t\tlevels: trace debug info warning error none (default: info)\n"
+		"\t\tcategories: general match ai referee tactics competition simulation performance\n";
+}
+
+}
+
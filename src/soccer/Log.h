@@ -0,0 +1,81 @@
+#ifndef SOCCER_LOG_H
+#define SOCCER_LOG_H
+
+#include <stdio.h>
+
+#include <string>
+
+// Log statements below this level are compiled out entirely.
+// 0 = trace, 1 = debug, 2 = info, 3 = warning, 4 = error.
+#ifndef FREEKICK_LOG_MIN_LEVEL
+#define FREEKICK_LOG_MIN_LEVEL 1
+#endif
+
+namespace Soccer {
+
+enum class LogLevel {
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	None
+};
+
+enum class LogCategory {
+	General,
+	Match,
+	AI,
+	Referee,
+	Tactics,
+	Competition,
+	Simulation,
+	Performance,
+	NumCategories
+};
+
+class Log {
+	public:
+		static bool enabled(LogCategory c, LogLevel l);
+		static void write(LogCategory c, LogLevel l, const char* fmt, ...)
+			__attribute__ ((format (printf, 3, 4)));
+
+		static void setLevel(LogLevel l);
+		static void setLevel(LogCategory c, LogLevel l);
+
+		// spec is a comma separated list of "level" or "category=level",
+		// e.g. "warning,ai=debug,match=info". Returns false on parse error.
+		static bool configure(const std::string& spec);
+		static void setOutput(FILE* f);
+
+		// blocks until everything written so far has reached the output.
+		static void flush();
+		static const char* usage();
+
+	private:
+		static unsigned char mLevels[(int)LogCategory::NumCategories];
+};
+
+inline bool Log::enabled(LogCategory c, LogLevel l)
+{
+	return (unsigned char)l >= mLevels[(int)c];
+}
+
+}
+
+#define LOG_ENABLED(cat, lvl) (FREEKICK_LOG_MIN_LEVEL <= (int)Soccer::LogLevel::lvl && \
+		Soccer::Log::enabled(Soccer::LogCategory::cat, Soccer::LogLevel::lvl))
+
+#define LOG_WRITE(cat, lvl, ...) do { \
+	if(LOG_ENABLED(cat, lvl)) \
+		Soccer::Log::write(Soccer::LogCategory::cat, Soccer::LogLevel::lvl, __VA_ARGS__); \
+	} while(0)
+
+#define LOG_TRACE(cat, ...)   LOG_WRITE(cat, Trace, __VA_ARGS__)
+#define LOG_DEBUG(cat, ...)   LOG_WRITE(cat, Debug, __VA_ARGS__)
+#define LOG_INFO(cat, ...)    LOG_WRITE(cat, Info, __VA_ARGS__)
+#define LOG_WARNING(cat, ...) LOG_WRITE(cat, Warning, __VA_ARGS__)
+#define LOG_ERROR(cat, ...)   LOG_WRITE(cat, Error, __VA_ARGS__)
+
+#endif
+
@@ -1,15 +1,20 @@
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "common/Math.h"
 
 #include "soccer/Match.h"
 #include "soccer/DataExchange.h"
 #include "soccer/Team.h"
-
-// #define DEBUG_SIMULATION
+#include "soccer/Log.h"
 
 namespace Soccer {
 
@@ -97,6 +102,10 @@ std::pair<int, int> CupEntry::aggregate() const
 	return res;
 }
 
+const std::vector<MatchResult>& CupEntry::getMatchResults() const
+{
+	return mMatchResults;
+}
 std::pair<int, int> CupEntry::penalties() const
 {
 	std::pair<int, int> res;
@@ -144,70 +153,51 @@ MatchResult Match::play(bool display) const
 	if(display) {
 		RunningMatch rm = RunningMatch(*this);
 		MatchResult r;
-		while(!rm.matchFinished(&r)) {
-			sleep(1);
-		}
+		rm.waitForMatch(&r, -1);
 		return r;
 	}
 	else {
-		if(!MatchDataDumpDirectory.empty()) {
-			std::string s(MatchDataDumpDirectory);
-			s += teamNameToFilename(mTeam1->getName()) + "-vs-" + teamNameToFilename(mTeam2->getName()) + ".xml";
-			FILE* f = fopen(s.c_str(), "w");
-			if(f) {
-				DataExchange::createMatchDataFile(*this, f);
-				std::cout << "Created match data file " << s << "\n";
-				fclose(f);
-			} else {
-				perror("fopen");
-				std::cerr << "Could not createa match data file.\n";
-			}
+		// seeded from rand() so that srand() still determines the results
+		return simulate(rand());
+	}
+}
+
+MatchResult Match::simulate(unsigned int seed) const
+{
+	if(!MatchDataDumpDirectory.empty()) {
+		std::string s(MatchDataDumpDirectory);
+		s += teamNameToFilename(mTeam1->getName()) + "-vs-" + teamNameToFilename(mTeam2->getName()) + ".xml";
+		FILE* f = fopen(s.c_str(), "w");
+		if(f) {
+			DataExchange::createMatchDataFile(*this, f);
+			LOG_INFO(Simulation, "Created match data file %s\n", s.c_str());
+			fclose(f);
+		} else {
+			perror("fopen");
+			std::cerr << "Could not createa match data file.\n";
 		}
-		return simulateMatchResult();
 	}
+	return simulateMatchResult(seed);
 }
 
-MatchResult Match::simulateMatchResult() const
+MatchResult Match::simulateMatchResult(unsigned int seed) const
 {
-	SimulationStrength s1(*mTeam1);
-	SimulationStrength s2(*mTeam2);
-	return s1.simulateAgainst(s2, mRules);
+	std::mt19937 rng(seed);
+	return SimulationStrength::simulate(*mTeam1->getSimulationProfile(),
+			*mTeam2->getSimulationProfile(), mRules, rng);
 }
 
-SimulationStrength::SimulationStrength(const StatefulTeam& t)
-	: mCenterDefense(0.0f),
-	mCenterGet(0.0f),
-	mCenterUse(0.0f),
-	mLeftDefense(0.0f),
-	mLeftGet(0.0f),
-	mLeftUse(0.0f),
-	mRightDefense(0.0f),
-	mRightGet(0.0f),
-	mRightUse(0.0f),
-	mCenterTry(0.0f),
-	mLeftTry(0.0f),
-	mRightTry(0.0f),
-	mLongBalls(0.0f)
+SimulationProfile::SimulationProfile(const StatefulTeam& t)
+	: Version(t.getVersion()),
+	Pressure(t.getTactics().Pressure * 0.5f + 0.25f),
+	LongBalls(t.getTactics().LongBalls * 0.5f + 0.25f)
 {
 	/* TODO: make use of FastPassing and ShootClose here. */
-	float press = t.getTactics().Pressure * 0.5f + 0.25f;
-	float wings = 0.5f;
-	float variance = 0.05f;
-
-	mLongBalls = t.getTactics().LongBalls * 0.5f + 0.25f;
-
-	press += (rand() % 2000 - 1000) * 0.001f * variance;
-	mLongBalls += (rand() % 2000 - 1000) * 0.001f * variance;
-	wings += (rand() % 2000 - 1000) * 0.001f * variance;
-
-	press = Common::clamp(0.25f, press, 0.75f);
-	mLongBalls = Common::clamp(0.1f, mLongBalls, 0.9f);
-	wings = Common::clamp(0.25f, wings, 0.75f);
-
-#ifdef DEBUG_SIMULATION
-			printf("Team %25s Pressure %2.3f Long balls %2.3f Wings %2.3f\n",
-					t.getName().c_str(), press, mLongBalls, wings);
-#endif
+	for(int i = 0; i < 3; i++) {
+		Defense[i] = 0.0f;
+		Get[i] = 0.0f;
+		Use[i] = 0.0f;
+	}
 
 	for(auto p : t.getPlayers()) {
 		auto it = t.getTactics().mTactics.find(p->getId());
@@ -215,9 +205,8 @@ SimulationStrength::SimulationStrength(const StatefulTeam& t)
 			continue;
 
 		if(it->second.Position == PlayerPosition::Goalkeeper) {
-			mCenterDefense += p->getSkills().GoalKeeping;
-			mLeftDefense   += p->getSkills().GoalKeeping;
-			mRightDefense  += p->getSkills().GoalKeeping;
+			for(int i = 0; i < 3; i++)
+				Defense[i] += p->getSkills().GoalKeeping;
 		}
 		else {
 			float generalplayerskill = (p->getSkills().Passing +
@@ -237,89 +226,144 @@ SimulationStrength::SimulationStrength(const StatefulTeam& t)
 				use += p->getSkills().ShotPower * generalplayerskill;
 			}
 
-			get *= press;
-			use *= (1.0f - press);
-
-			// use this to tune goals/match
-			use *= 4.0f;
-
-#ifdef DEBUG_SIMULATION
-			printf("Player %25s %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f\n",
-					p->getName().c_str(),
-					mLeftDefense, mCenterDefense, mRightDefense,
-					mLeftGet, mCenterGet, mRightGet,
-					mLeftUse, mCenterUse, mRightUse);
-#endif
 			float xpos = it->second.WidthPosition;
 			float centered = 1.0f - fabs(xpos);
 			centered = Common::clamp(0.0f, centered, 1.0f);
-			bool left = xpos < 0.0f;
-			mCenterDefense += def * centered;
-			mCenterGet += get * centered;
-			mCenterUse += use * centered;
-			if(left) {
-				mLeftDefense += def * (1.0f - centered);
-				mLeftGet += get * (1.0f - centered);
-				mLeftUse += use * (1.0f - centered);
-			}
-			else {
-				mRightDefense += def * (1.0f - centered);
-				mRightGet += get * (1.0f - centered);
-				mRightUse += use * (1.0f - centered);
-			}
+			int side = xpos < 0.0f ? 0 : 2;
+			Defense[1] += def * centered;
+			Get[1] += get * centered;
+			Use[1] += use * centered;
+			Defense[side] += def * (1.0f - centered);
+			Get[side] += get * (1.0f - centered);
+			Use[side] += use * (1.0f - centered);
 		}
 	}
 
-	mCenterTry = (mCenterGet) * (1.0f - wings);
-	mLeftTry   = (mLeftGet)   * (0.5f * wings);
-	mRightTry  = (mRightGet)  * (0.5f * wings);
+	LOG_TRACE(Simulation, "Team   %25s %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f\n",
+			t.getName().c_str(),
+			Defense[0], Defense[1], Defense[2],
+			Get[0], Get[1], Get[2],
+			Use[0], Use[1], Use[2]);
+}
 
-#ifdef DEBUG_SIMULATION
-			printf("Team   %25s %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f = %3.2f %3.2f %3.2f\n",
-					t.getName().c_str(),
-					mLeftDefense, mCenterDefense, mRightDefense,
-					mLeftGet, mCenterGet, mRightGet,
-					mLeftUse, mCenterUse, mRightUse);
-#endif
+static SimulationParameters CurrentSimulationParameters;
+
+SimulationParameters::SimulationParameters()
+	: GoalScale(4.0f),
+	HomeAdvantage(1.0f),
+	SkillExponent(1.0f),
+	Variance(0.05f),
+	Wings(0.5f)
+{
+}
+
+const SimulationParameters& SimulationParameters::get()
+{
+	return CurrentSimulationParameters;
+}
+
+void SimulationParameters::set(const SimulationParameters& p)
+{
+	CurrentSimulationParameters = p;
 }
 
-int SimulationStrength::pickOne(const std::vector<float>& values)
+SimulationStrength::SimulationStrength(const SimulationProfile& p, std::mt19937& rng,
+		const SimulationParameters& par)
+{
+	float press = p.Pressure;
+	float wings = par.Wings;
+	float variance = par.Variance;
+
+	mLongBalls = p.LongBalls;
+	mHomeAdvantage = par.HomeAdvantage;
+
+	press += (randomValue(rng) * 2.0f - 1.0f) * variance;
+	mLongBalls += (randomValue(rng) * 2.0f - 1.0f) * variance;
+	wings += (randomValue(rng) * 2.0f - 1.0f) * variance;
+
+	press = Common::clamp(0.25f, press, 0.75f);
+	mLongBalls = Common::clamp(0.1f, mLongBalls, 0.9f);
+	wings = Common::clamp(0.25f, wings, 0.75f);
+
+	for(int i = 0; i < 3; i++) {
+		mDefense[i] = p.Defense[i];
+		mGet[i] = p.Get[i] * press;
+		mUse[i] = p.Use[i] * (1.0f - press);
+		if(par.SkillExponent != 1.0f) {
+			mDefense[i] = powf(mDefense[i], par.SkillExponent);
+			mGet[i] = powf(mGet[i], par.SkillExponent);
+			mUse[i] = powf(mUse[i], par.SkillExponent);
+		}
+		mUse[i] *= par.GoalScale;
+	}
+
+	mTry[0] = mGet[0] * (0.5f * wings);
+	mTry[1] = mGet[1] * (1.0f - wings);
+	mTry[2] = mGet[2] * (0.5f * wings);
+}
+
+float SimulationStrength::randomValue(std::mt19937& rng)
+{
+	// [0, 1)
+	return (rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+int SimulationStrength::pickOne(const float* values, int num, std::mt19937& rng)
 {
 	float total = 0.0f;
-	for(auto t : values) {
-		total += t;
+	for(int i = 0; i < num; i++) {
+		total += values[i];
 	}
 
-	float randvalue = (rand() % 10000) / 10000.0f;
+	float randvalue = randomValue(rng);
 	float sum = 0.0f;
-	int i = 0;
-	for(auto t : values) {
-		sum += t;
+	for(int i = 0; i < num; i++) {
+		sum += values[i];
 		if(randvalue * total < sum) {
 			return i;
 		}
-		i++;
 	}
-	return values.size() - 1;
+	return num - 1;
+}
+
+MatchResult SimulationStrength::simulate(const SimulationProfile& t1, const SimulationProfile& t2,
+		const MatchRules& r, std::mt19937& rng, MatchStatistics* stats,
+		const SimulationParameters& par)
+{
+	SimulationStrength s1(t1, rng, par);
+	SimulationStrength s2(t2, rng, par);
+	return s1.simulateAgainst(s2, r, rng, stats);
+}
+
+void SimulationStrength::simulateMatches(const SimulationFixture* fixtures, unsigned int num,
+		unsigned int repetitions, const MatchRules& r, std::mt19937& rng,
+		MatchResult* results, const SimulationParameters& par)
+{
+	for(unsigned int i = 0; i < num; i++) {
+		for(unsigned int j = 0; j < repetitions; j++) {
+			results[i * repetitions + j] = simulate(*fixtures[i].Home, *fixtures[i].Away, r, rng,
+					nullptr, par);
+		}
+	}
 }
 
-MatchResult SimulationStrength::simulateAgainst(const SimulationStrength& t2, const MatchRules& r)
+MatchResult SimulationStrength::simulateAgainst(const SimulationStrength& t2, const MatchRules& r,
+		std::mt19937& rng, MatchStatistics* stats) const
 {
 	const int steps = 9;
 	unsigned int homegoals = 0, awaygoals = 0;
 
-	float totalTry = mCenterTry + mLeftTry + mRightTry +
-		t2.mCenterTry + t2.mLeftTry + t2.mRightTry;
-	float centerTry = (mCenterTry + t2.mCenterTry) / totalTry;
-	float leftTry = (mLeftTry + t2.mRightTry)      / totalTry;
-	float rightTry = (mRightTry + t2.mLeftTry)     / totalTry;
-	std::vector<float> tries;
-	tries.push_back(leftTry);
-	tries.push_back(centerTry);
-	tries.push_back(rightTry);
+	float totalTry = mTry[0] + mTry[1] + mTry[2] +
+		t2.mTry[0] + t2.mTry[1] + t2.mTry[2];
+	// the left side of the home team plays against the right side of
+	// the away team
+	float tries[3];
+	tries[0] = (mTry[0] + t2.mTry[2]) / totalTry;
+	tries[1] = (mTry[1] + t2.mTry[1]) / totalTry;
+	tries[2] = (mTry[2] + t2.mTry[0]) / totalTry;
 
 	for(int i = 0; i < steps; i++) {
-		simulateStep(t2, homegoals, awaygoals, tries);
+		simulateStep(t2, homegoals, awaygoals, tries, rng, stats);
 	}
 
 	bool tie;
@@ -330,7 +374,7 @@ MatchResult SimulationStrength::simulateAgainst(const SimulationStrength& t2, co
 
 	if(tie && r.ExtraTimeOnTie) {
 		for(int i = 0; i < 3; i++) {
-			simulateStep(t2, homegoals, awaygoals, tries);
+			simulateStep(t2, homegoals, awaygoals, tries, rng, stats);
 		}
 	}
 
@@ -339,11 +383,22 @@ MatchResult SimulationStrength::simulateAgainst(const SimulationStrength& t2, co
 	else
 		tie = homegoals == r.AwayAggregate && awaygoals == r.HomeAggregate;
 
+	if(stats) {
+		// the statistical model only knows which team had the ball
+		// and whether the attack ended in a goal
+		unsigned int home = stats->Teams[0].ShotsOnTarget + stats->Teams[0].ShotsOffTarget;
+		unsigned int away = stats->Teams[1].ShotsOnTarget + stats->Teams[1].ShotsOffTarget;
+		if(home + away) {
+			stats->Teams[0].Possession = home / (float)(home + away);
+			stats->Teams[1].Possession = away / (float)(home + away);
+		}
+	}
+
 	if(tie && r.PenaltiesOnTie) {
-		int homepen = rand() % 3 + 3;
-		int awaypen = rand() % 3 + 3;
+		int homepen = rng() % 3 + 3;
+		int awaypen = rng() % 3 + 3;
 		if(homepen == awaypen) {
-			int h = rand() % 2;
+			int h = rng() % 2;
 			if(h)
 				homepen++;
 			else
@@ -356,48 +411,19 @@ MatchResult SimulationStrength::simulateAgainst(const SimulationStrength& t2, co
 
 }
 
-void SimulationStrength::simulateStep(const SimulationStrength& t2, unsigned int& homegoals, unsigned int& awaygoals, const std::vector<float>& tries)
+void SimulationStrength::simulateStep(const SimulationStrength& t2, unsigned int& homegoals, unsigned int& awaygoals,
+		const float* tries, std::mt19937& rng, MatchStatistics* stats) const
 {
-#ifdef DEBUG_SIMULATION
-	printf("Step ");
-#endif
+	LOG_TRACE(Simulation, "Step ");
 
-	int trynum = pickOne(tries);
-	float t1get, t2get;
-	float t1def, t1att, t2def, t2att;
-	if(trynum == 0) {
-		t1get = mLeftGet;
-		t1def = mLeftDefense;
-		t1att = mLeftUse;
-		t2get = t2.mRightGet;
-		t2def = t2.mRightDefense;
-		t2att = t2.mRightUse;
-#ifdef DEBUG_SIMULATION
-		printf("left ");
-#endif
-	}
-	else if(trynum == 1) {
-		t1get = mCenterGet;
-		t1def = mCenterDefense;
-		t1att = mCenterUse;
-		t2get = t2.mCenterGet;
-		t2def = t2.mCenterDefense;
-		t2att = t2.mCenterUse;
-#ifdef DEBUG_SIMULATION
-		printf("center ");
-#endif
-	}
-	else {
-		t1get = mRightGet;
-		t1def = mRightDefense;
-		t1att = mRightUse;
-		t2get = t2.mLeftGet;
-		t2def = t2.mLeftDefense;
-		t2att = t2.mLeftUse;
-#ifdef DEBUG_SIMULATION
-		printf("right ");
-#endif
-	}
+	// 0: left, 1: center, 2: right from the home team's view
+	int trynum = pickOne(tries, 3, rng);
+	float t1get = mGet[trynum];
+	float t1def = mDefense[trynum];
+	float t1att = mUse[trynum];
+	float t2get = t2.mGet[2 - trynum];
+	float t2def = t2.mDefense[2 - trynum];
+	float t2att = t2.mUse[2 - trynum];
 
 	int holdnum;
 	if(t1get && !t2get) {
@@ -409,37 +435,35 @@ void SimulationStrength::simulateStep(const SimulationStrength& t2, unsigned int
 	else {
 		float difftomiddle = fabs(t1get - ((t1get + t2get) / 2.0f));
 		float totalLongBalls = Common::clamp(0.0f, (mLongBalls + t2.mLongBalls) / 2.0f, 1.0f);
-		std::vector<float> holding;
-		float t1chance = t1get + difftomiddle * totalLongBalls;
-		float t2chance = t2get + difftomiddle * totalLongBalls;
-		holding.push_back(t1chance);
-		holding.push_back(t2chance);
-		holdnum = pickOne(holding);
-		assert(t1chance >= 0.0f);
-		assert(t2chance >= 0.0f);
+		float holding[2];
+		holding[0] = t1get + difftomiddle * totalLongBalls;
+		holding[1] = t2get + difftomiddle * totalLongBalls;
+		holdnum = pickOne(holding, 2, rng);
+		assert(holding[0] >= 0.0f);
+		assert(holding[1] >= 0.0f);
 	}
 	float att, def;
 	bool homescorer;
 	if(holdnum == 0) {
-#ifdef DEBUG_SIMULATION
-		printf("home ");
-#endif
-		att = t1att;
+		LOG_TRACE(Simulation, "home ");
+		att = t1att * mHomeAdvantage;
 		def = t2def;
 		homescorer = true;
 	}
 	else {
-#ifdef DEBUG_SIMULATION
-		printf("away ");
-#endif
+		LOG_TRACE(Simulation, "away ");
 		att = t2att;
 		def = t1def;
 		homescorer = false;
 	}
-	std::vector<float> scoring;
-	scoring.push_back(att);
-	scoring.push_back(def);
-	int scorenum = pickOne(scoring);
+	float scoring[2] = { att, def };
+	int scorenum = pickOne(scoring, 2, rng);
+	if(stats) {
+		if(scorenum == 0)
+			stats->Teams[homescorer ? 0 : 1].ShotsOnTarget++;
+		else
+			stats->Teams[homescorer ? 0 : 1].ShotsOffTarget++;
+	}
 	if(scorenum == 0) {
 		if(homescorer) {
 			homegoals++;
@@ -447,14 +471,10 @@ void SimulationStrength::simulateStep(const SimulationStrength& t2, unsigned int
 		else {
 			awaygoals++;
 		}
-#ifdef DEBUG_SIMULATION
-		printf("scores! %d-%d\n", homegoals, awaygoals);
-#endif
+		LOG_TRACE(Simulation, "scores! %d-%d\n", homegoals, awaygoals);
 	}
 	else {
-#ifdef DEBUG_SIMULATION
-		printf("blocked\n");
-#endif
+		LOG_TRACE(Simulation, "blocked\n");
 	}
 }
 
@@ -507,10 +527,23 @@ Match::Match()
 }
 
 RunningMatch::RunningMatch(const Match& m)
+	: mChildPid(-1),
+	mResultFd(-1),
+	mPidFd(-1),
+	mFinished(false)
 {
-	tmpnam(matchfilenamebuf);
-	DataExchange::createMatchDataFile(m, matchfilenamebuf);
-	std::cout << "Created temporary file " << matchfilenamebuf << "\n";
+	std::string data = DataExchange::createMatchDataString(m, MatchDataFormat::Binary);
+	int datafd = memfd_create("freekick3-match", MFD_CLOEXEC);
+	if(datafd == -1) {
+		perror("memfd_create");
+		throw std::runtime_error("Could not create match data file");
+	}
+	if(write(datafd, data.data(), data.size()) != (ssize_t)data.size()) {
+		perror("write");
+		close(datafd);
+		throw std::runtime_error("Could not write match data");
+	}
+
 	int teamnum = 0;
 	int plnum = 0;
 	if(m.getTeam(0)->getController().HumanControlled && !m.getTeam(1)->getController().HumanControlled) {
@@ -521,17 +554,49 @@ RunningMatch::RunningMatch(const Match& m)
 		teamnum = 2;
 		plnum = m.getTeam(1)->getController().PlayerShirtNumber;
 	}
-	startMatch(teamnum, plnum, m.getRules());
+	startMatch(teamnum, plnum, m.getRules(), datafd);
+	close(datafd);
 }
 
-void RunningMatch::startMatch(int teamnum, int playernum, const MatchRules& rules)
+RunningMatch::RunningMatch(RunningMatch&& rm)
+	: mChildPid(rm.mChildPid),
+	mResultFd(rm.mResultFd),
+	mPidFd(rm.mPidFd),
+	mResultData(std::move(rm.mResultData)),
+	mFinished(rm.mFinished),
+	mResult(rm.mResult)
 {
+	rm.mChildPid = -1;
+	rm.mResultFd = -1;
+	rm.mPidFd = -1;
+}
+
+RunningMatch::~RunningMatch()
+{
+	if(mResultFd != -1)
+		close(mResultFd);
+	if(mPidFd != -1)
+		close(mPidFd);
+}
+
+void RunningMatch::startMatch(int teamnum, int playernum, const MatchRules& rules, int datafd)
+{
+	int resultpipe[2];
+	if(pipe2(resultpipe, O_CLOEXEC) == -1) {
+		perror("pipe2");
+		throw std::runtime_error("pipe() failed");
+	}
+
 	pid_t fret = fork();
 	if(fret == 0) {
-		/* child */
+		/* child - only pass on the match data and the result pipe */
+		fcntl(datafd, F_SETFD, 0);
+		fcntl(resultpipe[1], F_SETFD, 0);
 		std::vector<std::string> args;
 		args.push_back("freekick3-match");
-		args.push_back(matchfilenamebuf);
+		args.push_back(std::string("/dev/fd/") + std::to_string(datafd));
+		args.push_back("-O");
+		args.push_back(std::to_string(resultpipe[1]));
 		if(teamnum == 0) {
 			args.push_back("-o");
 		}
@@ -555,65 +620,135 @@ void RunningMatch::startMatch(int teamnum, int playernum, const MatchRules& rule
 			args.push_back(std::to_string(rules.AwayAggregate).c_str());
 		}
 
-		std::cout << "Running command: ";
-		for(auto arg : args) {
-			std::cout << arg << " ";
-		}
-		std::cout << "\n";
-
-		char **argsarray = new char*[args.size() + 1];
-
-		for(unsigned int i = 0; i < args.size(); i++) {
-			argsarray[i] = const_cast<char*>(args[i].c_str());
-		}
-		argsarray[args.size()] = (char*)0;
-
-		if(execvp("freekick3-match", argsarray) == -1) {
-			/* try bin/freekick3-match */
-			char cwdbuf[256];
-			if(getcwd(cwdbuf, 256) == NULL) {
-				perror("getcwd");
-				exit(1);
-			}
-			else {
-				std::string fullpath(cwdbuf);
-				fullpath += "/bin/freekick3-match";
-				if(execv(fullpath.c_str(), argsarray) == -1) {
-					perror("execl");
-					fprintf(stderr, "tried running %s\n", fullpath.c_str());
-					exit(1);
-				}
-			}
-		}
-		delete[] argsarray;
+		execMatchBinary(args);
 	}
 	else if(fret != -1) {
 		/* parent */
+		close(resultpipe[1]);
 		mChildPid = fret;
+		mResultFd = resultpipe[0];
+#ifdef SYS_pidfd_open
+		mPidFd = syscall(SYS_pidfd_open, mChildPid, 0);
+#endif
 		return;
 	}
 	else {
 		perror("fork");
+		close(resultpipe[0]);
+		close(resultpipe[1]);
 		throw std::runtime_error("fork() failed");
 	}
 }
 
+void RunningMatch::execMatchBinary(const std::vector<std::string>& args)
+{
+	// stdout may be the worker protocol channel
+	std::cerr << "Running command: ";
+	for(auto arg : args) {
+		std::cerr << arg << " ";
+	}
+	std::cerr << "\n";
+
+	char **argsarray = new char*[args.size() + 1];
+
+	for(unsigned int i = 0; i < args.size(); i++) {
+		argsarray[i] = const_cast<char*>(args[i].c_str());
+	}
+	argsarray[args.size()] = (char*)0;
+
+	/* only called in a forked child, so exit with _exit() to skip the
+	 * static destructors of the parent's state (e.g. the worker pool) */
+	if(execvp("freekick3-match", argsarray) == -1) {
+		/* try bin/freekick3-match */
+		char cwdbuf[256];
+		if(getcwd(cwdbuf, 256) == NULL) {
+			perror("getcwd");
+		}
+		else {
+			std::string fullpath(cwdbuf);
+			fullpath += "/bin/freekick3-match";
+			if(execv(fullpath.c_str(), argsarray) == -1) {
+				perror("execl");
+				fprintf(stderr, "tried running %s\n", fullpath.c_str());
+			}
+		}
+	}
+	_exit(1);
+}
+
 bool RunningMatch::matchFinished(MatchResult* r)
+{
+	return waitForMatch(r, 0);
+}
+
+bool RunningMatch::waitForMatch(MatchResult* r, int timeout)
 {
 	assert(r);
-	pid_t waited = waitpid(mChildPid, NULL, WNOHANG);
-	if(waited == -1) {
-		perror("waitpid");
-	}
-	if(waited == mChildPid) {
-		boost::shared_ptr<Match> match = DataExchange::parseMatchDataFile(matchfilenamebuf);
-		unlink(matchfilenamebuf);
-		*r = match->getResult();
-		return true;
+	while(!mFinished) {
+		// the result pipe is closed when the child exits; the pidfd, if
+		// available, also catches a child that closed the pipe early.
+		struct pollfd fds[2];
+		int nfds = 0;
+		if(mResultFd != -1) {
+			fds[nfds].fd = mResultFd;
+			fds[nfds].events = POLLIN;
+			nfds++;
+		}
+		if(mPidFd != -1) {
+			fds[nfds].fd = mPidFd;
+			fds[nfds].events = POLLIN;
+			nfds++;
+		}
+		if(nfds == 0) {
+			childExited();
+			break;
+		}
+
+		int ret = poll(fds, nfds, timeout);
+		if(ret == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("poll");
+			throw std::runtime_error("poll() failed");
+		}
+		if(ret == 0)
+			return false;
+
+		for(int i = 0; i < nfds; i++) {
+			if(!fds[i].revents)
+				continue;
+			if(fds[i].fd == mResultFd) {
+				char buf[65536];
+				ssize_t len = read(mResultFd, buf, sizeof(buf));
+				if(len > 0) {
+					mResultData.append(buf, len);
+				} else if(len == 0 || errno != EINTR) {
+					close(mResultFd);
+					mResultFd = -1;
+				}
+			} else if(fds[i].fd == mPidFd) {
+				close(mPidFd);
+				mPidFd = -1;
+			}
+		}
+		if(mResultFd == -1 && mPidFd == -1)
+			childExited();
 	}
-	else {
-		return false;
+	*r = mResult;
+	return true;
+}
+
+void RunningMatch::childExited()
+{
+	int status;
+	if(waitpid(mChildPid, &status, 0) == -1)
+		perror("waitpid");
+	mFinished = true;
+	if(mResultData.empty()) {
+		LOG_INFO(General, "Match was not finished\n");
+		return;
 	}
+	mResult = DataExchange::parseMatchResultString(mResultData);
 }
 
 
@@ -2,7 +2,9 @@
 #define SOCCER_MATCH_H
 
 #include <map>
+#include <random>
 #include <boost/shared_ptr.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "soccer/PlayerTactics.h"
 #include "soccer/Player.h"
@@ -41,6 +43,50 @@ class MatchRules {
 		}
 };
 
+struct TeamStatistics {
+	float Possession = 0.0f; // share of the time in play, 0-1
+	unsigned int PassesAttempted = 0;
+	unsigned int PassesCompleted = 0;
+	unsigned int ShotsOnTarget = 0;
+	unsigned int ShotsOffTarget = 0;
+	unsigned int Tackles = 0;
+	unsigned int Corners = 0;
+	unsigned int GoalKicks = 0;
+	unsigned int ThrowIns = 0;
+	// share of the time in play the ball was in the team's
+	// defensive, middle and attacking third
+	float TimeInThird[3] = { 0.0f, 0.0f, 0.0f };
+	std::map<int, float> PlayerDistance; // player id => metres run
+
+	friend class boost::serialization::access;
+	template<class Archive>
+		void serialize(Archive& ar, const unsigned int version)
+		{
+			ar & Possession;
+			ar & PassesAttempted;
+			ar & PassesCompleted;
+			ar & ShotsOnTarget;
+			ar & ShotsOffTarget;
+			ar & Tackles;
+			ar & Corners;
+			ar & GoalKicks;
+			ar & ThrowIns;
+			ar & TimeInThird;
+			ar & PlayerDistance;
+		}
+};
+
+struct MatchStatistics {
+	TeamStatistics Teams[2];
+
+	friend class boost::serialization::access;
+	template<class Archive>
+		void serialize(Archive& ar, const unsigned int version)
+		{
+			ar & Teams;
+		}
+};
+
 struct MatchResult {
 	MatchResult() : Played(false) { }
 	MatchResult(unsigned int h, unsigned int a, unsigned int hp = 0, unsigned int ap = 0) :
@@ -53,6 +99,7 @@ struct MatchResult {
 	unsigned int HomePenalties = 0;
 	unsigned int AwayPenalties = 0;
 	bool Played;
+	boost::shared_ptr<MatchStatistics> Statistics; // not set if not collected
 
 	friend class boost::serialization::access;
 	template<class Archive>
@@ -63,6 +110,8 @@ struct MatchResult {
 			ar & HomePenalties;
 			ar & AwayPenalties;
 			ar & Played;
+			if(version > 0)
+				ar & Statistics;
 		}
 };
 
@@ -73,6 +122,7 @@ class CupEntry {
 		bool firstWon() const;
 		std::pair<int, int> aggregate() const;
 		std::pair<int, int> penalties() const;
+		const std::vector<MatchResult>& getMatchResults() const;
 
 	private:
 		bool firstWinsByAwayGoals() const;
@@ -87,41 +137,103 @@ class CupEntry {
 		}
 };
 
+// The part of the statistical match simulation that only depends on the
+// players and the tactics of a team. Cached by StatefulTeam.
+struct SimulationProfile {
+	SimulationProfile(const StatefulTeam& t);
+	unsigned int Version; // StatefulTeam version the profile was built for
+	float Pressure;
+	float LongBalls;
+	// left, center, right. Get and Use are scaled by the pressure
+	// of the match.
+	float Defense[3];
+	float Get[3];
+	float Use[3];
+};
+
+// Constants of the statistical match simulation. freekick3-calibrate fits
+// them to the match engine and writes them to share/Simulation.xml; without
+// that file the defaults are used.
+struct SimulationParameters {
+	SimulationParameters();
+	float GoalScale;     // scales the attacking strength, sets the goals per match
+	float HomeAdvantage; // scales the attacking strength of the home team
+	float SkillExponent; // > 1: skill differences count more
+	float Variance;      // of the tactics of a team in a match
+	float Wings;         // share of attacks on the wings
+
+	// the parameters used by default. Not thread safe, so set them
+	// before any matches are simulated.
+	static const SimulationParameters& get();
+	static void set(const SimulationParameters& p);
+};
+
+struct SimulationFixture {
+	const SimulationProfile* Home;
+	const SimulationProfile* Away;
+};
+
 class SimulationStrength {
 	public:
-		SimulationStrength(const StatefulTeam& t);
-		MatchResult simulateAgainst(const SimulationStrength& t2, const MatchRules& r);
+		SimulationStrength(const SimulationProfile& p, std::mt19937& rng,
+				const SimulationParameters& par = SimulationParameters::get());
+		MatchResult simulateAgainst(const SimulationStrength& t2, const MatchRules& r,
+				std::mt19937& rng, MatchStatistics* stats = nullptr) const;
+
+		static MatchResult simulate(const SimulationProfile& t1, const SimulationProfile& t2,
+				const MatchRules& r, std::mt19937& rng, MatchStatistics* stats = nullptr,
+				const SimulationParameters& par = SimulationParameters::get());
+		// simulates each of the num fixtures repetitions times without
+		// allocating. The result of repetition j of fixture i is
+		// stored in results[i * repetitions + j].
+		static void simulateMatches(const SimulationFixture* fixtures, unsigned int num,
+				unsigned int repetitions, const MatchRules& r, std::mt19937& rng,
+				MatchResult* results,
+				const SimulationParameters& par = SimulationParameters::get());
 
 	private:
-		void simulateStep(const SimulationStrength& t2, unsigned int& homegoals, unsigned int& awaygoals, const std::vector<float>& tries);
-
-		static int pickOne(const std::vector<float>& values);
-		float mCenterDefense;
-		float mCenterGet;
-		float mCenterUse;
-		float mLeftDefense;
-		float mLeftGet;
-		float mLeftUse;
-		float mRightDefense;
-		float mRightGet;
-		float mRightUse;
-
-		float mCenterTry;
-		float mLeftTry;
-		float mRightTry;
+		void simulateStep(const SimulationStrength& t2, unsigned int& homegoals, unsigned int& awaygoals,
+				const float* tries, std::mt19937& rng, MatchStatistics* stats) const;
+
+		static float randomValue(std::mt19937& rng);
+		static int pickOne(const float* values, int num, std::mt19937& rng);
+		// left, center, right
+		float mDefense[3];
+		float mGet[3];
+		float mUse[3];
+		float mTry[3];
 
 		float mLongBalls;
+		float mHomeAdvantage;
 };
 
+// Runs a match in a freekick3-match child process. The match data is
+// passed in a memfd and the result comes back over a pipe.
 class RunningMatch {
 	public:
 		RunningMatch(const Match& m);
+		RunningMatch(RunningMatch&& rm);
+		RunningMatch(const RunningMatch&) = delete;
+		RunningMatch& operator=(const RunningMatch&) = delete;
+		~RunningMatch();
 		bool matchFinished(MatchResult* r);
 
+		// waits for at most timeout milliseconds (-1: no limit) for the
+		// match to finish. Returns true once the match has finished.
+		bool waitForMatch(MatchResult* r, int timeout);
+		// replaces the current (forked) process with freekick3-match,
+		// looking for it in PATH and then in bin/. Doesn't return.
+		static void execMatchBinary(const std::vector<std::string>& args);
+
 	private:
-		void startMatch(int teamnum, int playernum, const MatchRules& rules);
+		void startMatch(int teamnum, int playernum, const MatchRules& rules, int datafd);
+		void childExited();
 		pid_t mChildPid;
-		char matchfilenamebuf[L_tmpnam];
+		int mResultFd;
+		int mPidFd;
+		std::string mResultData;
+		bool mFinished;
+		MatchResult mResult;
 };
 
 class Match {
@@ -129,6 +241,9 @@ class Match {
 		Match(const boost::shared_ptr<StatefulTeam> t1, const boost::shared_ptr<StatefulTeam> t2,
 				const MatchRules& r);
 		MatchResult play(bool display) const;
+		// plays the match without display like play(false), with the
+		// simulation seeded with seed instead of rand()
+		MatchResult simulate(unsigned int seed) const;
 		RunningMatch startMatch(bool display) const;
 		const MatchResult& getResult() const;
 		void setResult(const MatchResult& m);
@@ -140,7 +255,7 @@ class Match {
 		static void setMatchDataDumpDirectory(const std::string& s);
 
 	private:
-		MatchResult simulateMatchResult() const;
+		MatchResult simulateMatchResult(unsigned int seed) const;
 
 		static std::string MatchDataDumpDirectory;
 
@@ -165,5 +280,7 @@ class Match {
 
 }
 
+BOOST_CLASS_VERSION(Soccer::MatchResult, 1)
+
 #endif
 
@@ -0,0 +1,257 @@
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
+
+#include "soccer/MatchWorkerPool.h"
+#include "soccer/Competition.h"
+#include "soccer/DataExchange.h"
+#include "soccer/Team.h"
+#include "soccer/Log.h"
+
+namespace Soccer {
+
+MatchWorkerPool::MatchWorkerPool(unsigned int numworkers)
+	: mNumWorkers(numworkers),
+	mRandom(std::random_device()())
+{
+	if(!mNumWorkers)
+		mNumWorkers = std::max(1u, std::thread::hardware_concurrency());
+}
+
+MatchWorkerPool::~MatchWorkerPool()
+{
+	for(auto& w : mWorkers)
+		stopWorker(w, false);
+}
+
+MatchWorkerPool& MatchWorkerPool::getInstance()
+{
+	static MatchWorkerPool pool;
+	return pool;
+}
+
+void MatchWorkerPool::startWorkers()
+{
+	while(mWorkers.size() < mNumWorkers) {
+		int fds[2];
+		if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == -1) {
+			perror("socketpair");
+			throw std::runtime_error("socketpair() failed");
+		}
+
+		pid_t fret = fork();
+		if(fret == 0) {
+			/* child - runs at a lower priority so that a match the
+			 * user is watching at the same time stays smooth */
+			errno = 0;
+			if(nice(10) == -1 && errno)
+				perror("nice");
+			dup2(fds[1], STDIN_FILENO);
+			dup2(fds[1], STDOUT_FILENO);
+			std::vector<std::string> args;
+			args.push_back("freekick3-match");
+			args.push_back("-w");
+			RunningMatch::execMatchBinary(args);
+		}
+		close(fds[1]);
+		if(fret == -1) {
+			perror("fork");
+			close(fds[0]);
+			throw std::runtime_error("fork() failed");
+		}
+
+		Worker w;
+		w.Pid = fret;
+		w.Fd = fds[0];
+		w.Job = -1;
+		mWorkers.push_back(w);
+	}
+	LOG_INFO(Simulation, "Started %u match workers\n", mNumWorkers);
+}
+
+void MatchWorkerPool::stopWorker(Worker& w, bool kill)
+{
+	if(w.Pid == -1)
+		return;
+	if(kill) {
+		::kill(w.Pid, SIGTERM);
+	} else {
+		const char quit[] = "quit\n";
+		send(w.Fd, quit, sizeof(quit) - 1, MSG_NOSIGNAL);
+	}
+	close(w.Fd);
+	waitpid(w.Pid, NULL, 0);
+	w.Pid = -1;
+	w.Fd = -1;
+}
+
+void MatchWorkerPool::dropWorker(Worker& w, std::deque<unsigned int>& pending)
+{
+	LOG_WARNING(Simulation, "Lost match worker %d%s\n", (int)w.Pid,
+			w.Job != -1 ? ", requeuing its match" : "");
+	if(w.Job != -1)
+		pending.push_front(w.Job);
+	w.Job = -1;
+	w.Buffer.clear();
+	stopWorker(w, true);
+}
+
+bool MatchWorkerPool::sendMatch(Worker& w, const Match& m)
+{
+	std::string data = DataExchange::createMatchDataString(m, MatchDataFormat::Binary);
+	std::string req = "match " + std::to_string(data.size()) + " -s " +
+		std::to_string(mRandom() >> 1) + "\n" + data;
+	size_t written = 0;
+	while(written < req.size()) {
+		ssize_t ret = send(w.Fd, req.data() + written, req.size() - written, MSG_NOSIGNAL);
+		if(ret == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("send");
+			return false;
+		}
+		written += ret;
+	}
+	return true;
+}
+
+bool MatchWorkerPool::readResponse(Worker& w, std::vector<MatchResult>& results)
+{
+	size_t nl = w.Buffer.find('\n');
+	if(nl == std::string::npos)
+		return false;
+
+	if(w.Buffer.compare(0, 7, "result ") == 0) {
+		size_t len = strtoul(w.Buffer.c_str() + 7, NULL, 10);
+		if(w.Buffer.size() < nl + 1 + len)
+			return false;
+		try {
+			results[w.Job] = DataExchange::parseMatchResultString(w.Buffer.substr(nl + 1, len));
+		}
+		catch(std::exception& e) {
+			LOG_WARNING(Simulation, "Could not parse match worker result: %s\n", e.what());
+		}
+		w.Buffer.erase(0, nl + 1 + len);
+	} else {
+		LOG_WARNING(Simulation, "Match worker: %s\n", w.Buffer.substr(0, nl).c_str());
+		w.Buffer.erase(0, nl + 1);
+	}
+	w.Job = -1;
+	return true;
+}
+
+std::vector<MatchResult> MatchWorkerPool::playMatches(const std::vector<boost::shared_ptr<Match>>& matches,
+		ProgressFunc progress)
+{
+	std::vector<MatchResult> results(matches.size());
+	if(matches.empty())
+		return results;
+
+	startWorkers();
+
+	std::deque<unsigned int> pending;
+	for(unsigned int i = 0; i < matches.size(); i++)
+		pending.push_back(i);
+
+	unsigned int done = 0;
+	while(done < matches.size()) {
+		for(auto& w : mWorkers) {
+			if(w.Job == -1 && !pending.empty()) {
+				unsigned int j = pending.front();
+				if(!sendMatch(w, *matches[j])) {
+					dropWorker(w, pending);
+					continue;
+				}
+				pending.pop_front();
+				w.Job = j;
+			}
+		}
+		mWorkers.erase(std::remove_if(mWorkers.begin(), mWorkers.end(),
+					[](const Worker& w) { return w.Pid == -1; }), mWorkers.end());
+
+		std::vector<struct pollfd> fds;
+		std::vector<Worker*> busy;
+		for(auto& w : mWorkers) {
+			if(w.Job != -1) {
+				struct pollfd p;
+				p.fd = w.Fd;
+				p.events = POLLIN;
+				p.revents = 0;
+				fds.push_back(p);
+				busy.push_back(&w);
+			}
+		}
+		if(fds.empty()) {
+			LOG_ERROR(Simulation, "No match workers left, %u matches not played\n",
+					(unsigned int)matches.size() - done);
+			break;
+		}
+
+		if(poll(&fds[0], fds.size(), -1) == -1) {
+			if(errno == EINTR)
+				continue;
+			perror("poll");
+			throw std::runtime_error("poll() failed");
+		}
+
+		for(unsigned int i = 0; i < fds.size(); i++) {
+			if(!fds[i].revents)
+				continue;
+			Worker& w = *busy[i];
+			char buf[65536];
+			ssize_t len = read(w.Fd, buf, sizeof(buf));
+			if(len == -1 && errno == EINTR)
+				continue;
+			if(len <= 0) {
+				dropWorker(w, pending);
+				continue;
+			}
+			w.Buffer.append(buf, len);
+			if(!readResponse(w, results))
+				continue;
+			done++;
+			if(progress)
+				progress(done, matches.size());
+		}
+		mWorkers.erase(std::remove_if(mWorkers.begin(), mWorkers.end(),
+					[](const Worker& w) { return w.Pid == -1; }), mWorkers.end());
+	}
+	return results;
+}
+
+unsigned int MatchWorkerPool::playRound(StatefulCompetition& c, ProgressFunc progress)
+{
+	std::vector<boost::shared_ptr<Match>> round = c.getCurrentRoundMatches();
+	std::vector<boost::shared_ptr<Match>> matches;
+	for(auto it = std::find(round.begin(), round.end(), c.getNextMatch()); it != round.end(); ++it) {
+		if((*it)->getTeam(0)->getController().HumanControlled ||
+				(*it)->getTeam(1)->getController().HumanControlled)
+			break;
+		matches.push_back(*it);
+	}
+
+	std::vector<MatchResult> results = playMatches(matches, progress);
+	unsigned int played = 0;
+	for(unsigned int i = 0; i < matches.size(); i++) {
+		if(!results[i].Played)
+			break;
+		assert(c.getNextMatch() == matches[i]);
+		matches[i]->setResult(results[i]);
+		c.matchPlayed(results[i]);
+		played++;
+	}
+	return played;
+}
+
+}
+
@@ -0,0 +1,69 @@
+#ifndef SOCCER_MATCHWORKERPOOL_H
+#define SOCCER_MATCHWORKERPOOL_H
+
+#include <sys/types.h>
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <random>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/Match.h"
+
+namespace Soccer {
+
+class StatefulCompetition;
+
+// Plays matches with the match engine, without display, on a pool of
+// freekick3-match worker processes (freekick3-match -w). The workers are
+// started on first use and kept running until the pool is destroyed.
+class MatchWorkerPool {
+	public:
+		// numworkers = 0: one worker per CPU
+		MatchWorkerPool(unsigned int numworkers = 0);
+		~MatchWorkerPool();
+		MatchWorkerPool(const MatchWorkerPool&) = delete;
+		MatchWorkerPool& operator=(const MatchWorkerPool&) = delete;
+
+		typedef std::function<void (unsigned int done, unsigned int total)> ProgressFunc;
+
+		// returns the results in the order of the matches. The match of
+		// a worker that exits is played again by another worker; a match
+		// that couldn't be played has a result with Played == false.
+		std::vector<MatchResult> playMatches(const std::vector<boost::shared_ptr<Match>>& matches,
+				ProgressFunc progress = ProgressFunc());
+
+		// plays the AI-vs-AI matches starting from the next match up
+		// to the end of its round and passes the results on to the
+		// competition in order. Returns the number of matches played.
+		unsigned int playRound(StatefulCompetition& c, ProgressFunc progress = ProgressFunc());
+
+		static MatchWorkerPool& getInstance();
+
+	private:
+		struct Worker {
+			pid_t Pid;
+			int Fd;
+			std::string Buffer;
+			int Job;
+		};
+
+		void startWorkers();
+		void stopWorker(Worker& w, bool kill);
+		void dropWorker(Worker& w, std::deque<unsigned int>& pending);
+		bool sendMatch(Worker& w, const Match& m);
+		bool readResponse(Worker& w, std::vector<MatchResult>& results);
+
+		unsigned int mNumWorkers;
+		std::vector<Worker> mWorkers;
+		// for the match seeds
+		std::mt19937 mRandom;
+};
+
+}
+
+#endif
+
@@ -0,0 +1,488 @@
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include "soccer/ProgressionForecast.h"
+#include "soccer/Cup.h"
+#include "soccer/League.h"
+#include "soccer/Tournament.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+
+namespace Soccer {
+
+ProgressionForecast::ProgressionForecast(const StatefulCup& c)
+	: mAllAdvance(c.getOnlyOneRound()),
+	mIterations(0)
+{
+	addCupPhase(c);
+	if(!c.getOnlyOneRound()) {
+		for(unsigned int n = mPhases[0].Teams / 2; n >= 2; n /= 2) {
+			Phase p = mPhases[0];
+			p.Teams = n;
+			mPhases.push_back(p);
+		}
+	}
+	finishSetup();
+}
+
+ProgressionForecast::ProgressionForecast(const StatefulTournament& t)
+	: mAllAdvance(false),
+	mIterations(0)
+{
+	auto st = t.getCurrentStage();
+	if(st) {
+		const auto& groups = st->getGroups();
+		boost::shared_ptr<StatefulCup> cup = boost::dynamic_pointer_cast<StatefulCup>(groups[0]);
+		if(cup) {
+			addCupPhase(*cup);
+		}
+		else {
+			std::vector<boost::shared_ptr<StatefulLeague>> leagues;
+			for(auto g : groups) {
+				boost::shared_ptr<StatefulLeague> l = boost::dynamic_pointer_cast<StatefulLeague>(g);
+				if(l)
+					leagues.push_back(l);
+			}
+			addGroupPhase(leagues);
+		}
+	}
+
+	for(auto s : t.getRemainingStages()) {
+		Phase p;
+		p.Teams = s->getTotalTeams();
+		p.Groups = 0;
+		p.Legs = 1;
+		p.AwayGoals = false;
+		boost::shared_ptr<GroupStage> gs = boost::dynamic_pointer_cast<GroupStage>(s);
+		boost::shared_ptr<KnockoutStage> ks = boost::dynamic_pointer_cast<KnockoutStage>(s);
+		if(gs) {
+			p.Group = true;
+			p.Groups = gs->getNumberOfGroups();
+		}
+		else if(ks) {
+			p.Group = false;
+			p.Legs = ks->getNumberOfLegs();
+			p.AwayGoals = ks->getAwayGoals();
+		}
+		else {
+			continue;
+		}
+		mPhases.push_back(p);
+	}
+	finishSetup();
+}
+
+unsigned short ProgressionForecast::addTeam(const boost::shared_ptr<StatefulTeam>& t)
+{
+	mTeams.push_back(t);
+	mProfiles.push_back(t->getSimulationProfile());
+	TableEntry te;
+	te.Points = 0;
+	te.GoalDifference = 0;
+	te.GoalsFor = 0;
+	mStartTable.push_back(te);
+	return mTeams.size() - 1;
+}
+
+void ProgressionForecast::addCupPhase(const StatefulCup& c)
+{
+	for(auto& e : c.getEntries()) {
+		Tie t;
+		t.Team[0] = addTeam(e.first.first);
+		t.Team[1] = addTeam(e.first.second);
+		t.LegsPlayed = 0;
+		for(int i = 0; i < 2; i++) {
+			t.Goals[i] = 0;
+			t.AwayGoals[i] = 0;
+			t.Penalties[i] = 0;
+		}
+		for(auto& r : e.second.getMatchResults()) {
+			// the second team plays at home in every other leg
+			int home = t.LegsPlayed & 1;
+			t.Goals[home] += r.HomeGoals;
+			t.Goals[1 - home] += r.AwayGoals;
+			t.AwayGoals[1 - home] += r.AwayGoals;
+			t.Penalties[home] = r.HomePenalties;
+			t.Penalties[1 - home] = r.AwayPenalties;
+			t.LegsPlayed++;
+		}
+		mStartTies.push_back(t);
+	}
+
+	Phase p;
+	p.Group = false;
+	p.Teams = mTeams.size();
+	p.Groups = 0;
+	p.Legs = c.getNumberOfLegs();
+	p.AwayGoals = c.getAwayGoals();
+	mPhases.push_back(p);
+}
+
+void ProgressionForecast::addGroupPhase(const std::vector<boost::shared_ptr<StatefulLeague>>& groups)
+{
+	for(auto l : groups) {
+		std::map<boost::shared_ptr<StatefulTeam>, unsigned short> indices;
+		for(auto t : l->getRanking()) {
+			unsigned short i = addTeam(t);
+			const LeagueEntry& e = l->getEntries().find(t)->second;
+			mStartTable[i].Points = e.Points;
+			mStartTable[i].GoalDifference = e.GoalsFor - e.GoalsAgainst;
+			mStartTable[i].GoalsFor = e.GoalsFor;
+			mStartGroups.push_back(i);
+			indices[t] = i;
+		}
+		mStartGroupSizes.push_back(indices.size());
+
+		const Schedule& s = l->getSchedule();
+		for(auto& sf : s.getFixtures()) {
+			if(sf.Flags & Schedule::Fixture::ResultPlayed)
+				continue;
+			Fixture f;
+			f.Home = indices[s.getTeam(sf.Home)];
+			f.Away = indices[s.getTeam(sf.Away)];
+			mStartFixtures.push_back(f);
+		}
+	}
+
+	Phase p;
+	p.Group = true;
+	p.Teams = mTeams.size();
+	p.Groups = groups.size();
+	p.Legs = 1;
+	p.AwayGoals = false;
+	mPhases.push_back(p);
+}
+
+void ProgressionForecast::addStageName(const Phase& p)
+{
+	if(p.Group)
+		mStageNames.push_back("Groups");
+	else if(p.Teams == 2)
+		mStageNames.push_back("Final");
+	else if(p.Teams == 4)
+		mStageNames.push_back("Semi");
+	else if(p.Teams == 8)
+		mStageNames.push_back("Quarter");
+	else
+		mStageNames.push_back("Last " + std::to_string(p.Teams));
+}
+
+void ProgressionForecast::finishSetup()
+{
+	for(auto& p : mPhases)
+		addStageName(p);
+	mStageNames.push_back(mAllAdvance ? "Next round" : "Winner");
+
+	std::vector<unsigned int> order(mTeams.size());
+	for(unsigned int i = 0; i < order.size(); i++)
+		order[i] = i;
+
+	// ties are broken by the team name as in getTeamsByPosition()
+	std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+			return strcmp(mTeams[a]->getName().c_str(), mTeams[b]->getName().c_str()) < 0; });
+	mNameOrder.resize(mTeams.size());
+	for(unsigned int i = 0; i < order.size(); i++)
+		mNameOrder[order[i]] = i;
+
+	// StatefulCup lists the winners in the order of its entry map, whose
+	// keys compare the stored team pointers
+	std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+			return mTeams[a].get() < mTeams[b].get(); });
+	mAddressOrder.resize(mTeams.size());
+	for(unsigned int i = 0; i < order.size(); i++)
+		mAddressOrder[order[i]] = i;
+
+	mCounts.resize(mTeams.size() * mStageNames.size(), 0);
+}
+
+void ProgressionForecast::run(unsigned int iterations, unsigned int numthreads, unsigned int seed)
+{
+	if(numthreads == 0)
+		numthreads = std::max(1u, std::thread::hardware_concurrency());
+	numthreads = std::max(1u, std::min(numthreads, iterations));
+
+	std::vector<std::vector<unsigned int>> counts(numthreads,
+			std::vector<unsigned int>(mCounts.size(), 0));
+	std::vector<std::thread> threads;
+	for(unsigned int t = 0; t < numthreads; t++) {
+		unsigned int n = iterations / numthreads + (t < iterations % numthreads ? 1 : 0);
+		threads.push_back(std::thread(&ProgressionForecast::work, this, n, seed, t, std::ref(counts[t])));
+	}
+	for(auto& t : threads)
+		t.join();
+
+	for(auto& c : counts)
+		for(unsigned int i = 0; i < mCounts.size(); i++)
+			mCounts[i] += c[i];
+	mIterations += iterations;
+}
+
+unsigned int ProgressionForecast::runUntil(float maxerror, unsigned int maxiterations,
+		unsigned int numthreads, unsigned int seed)
+{
+	const unsigned int batch = 5000;
+	unsigned int done = 0;
+	for(unsigned int i = 0; done < maxiterations; i++) {
+		unsigned int n = std::min(batch, maxiterations - done);
+		run(n, numthreads, seed + i);
+		done += n;
+		if(getMaxStandardError() <= maxerror)
+			break;
+	}
+	return done;
+}
+
+void ProgressionForecast::work(unsigned int iterations, unsigned int seed, unsigned int threadnum,
+		std::vector<unsigned int>& counts) const
+{
+	std::seed_seq seq{seed, threadnum};
+	std::mt19937 rng(seq);
+	const unsigned int numstages = mStageNames.size();
+
+	Scratch s;
+	s.Teams.reserve(mTeams.size());
+	s.Next.reserve(mTeams.size());
+	s.Ties.reserve(mTeams.size() / 2 + 1);
+	s.Table.resize(mTeams.size());
+	s.Ranked.reserve(mTeams.size());
+
+	for(unsigned int it = 0; it < iterations; it++) {
+		s.Teams.clear();
+		for(unsigned int i = 0; i < mPhases.size(); i++) {
+			const Phase& p = mPhases[i];
+			s.Next.clear();
+			if(p.Group)
+				playGroupPhase(p, i == 0, s, rng);
+			else
+				playKnockoutPhase(p, i == 0, s, rng);
+
+			for(auto t : s.Teams)
+				counts[t * numstages + i]++;
+
+			if(i + 1 < mPhases.size() && s.Next.size() > mPhases[i + 1].Teams)
+				s.Next.resize(mPhases[i + 1].Teams);
+			std::swap(s.Teams, s.Next);
+		}
+
+		if(mAllAdvance) {
+			for(auto t : s.Teams)
+				counts[t * numstages + numstages - 1]++;
+		}
+		else if(!s.Teams.empty()) {
+			counts[s.Teams[0] * numstages + numstages - 1]++;
+		}
+	}
+}
+
+void ProgressionForecast::playKnockoutPhase(const Phase& p, bool first, Scratch& s, std::mt19937& rng) const
+{
+	if(first) {
+		s.Ties.assign(mStartTies.begin(), mStartTies.end());
+		s.Teams.clear();
+		for(auto& t : s.Ties) {
+			s.Teams.push_back(t.Team[0]);
+			s.Teams.push_back(t.Team[1]);
+		}
+	}
+	else {
+		// the draw
+		std::shuffle(s.Teams.begin(), s.Teams.end(), rng);
+		s.Ties.clear();
+		for(unsigned int i = 0; i + 1 < s.Teams.size(); i += 2) {
+			Tie t;
+			t.Team[0] = s.Teams[i];
+			t.Team[1] = s.Teams[i + 1];
+			t.LegsPlayed = 0;
+			for(int j = 0; j < 2; j++) {
+				t.Goals[j] = 0;
+				t.AwayGoals[j] = 0;
+				t.Penalties[j] = 0;
+			}
+			s.Ties.push_back(t);
+		}
+		std::sort(s.Ties.begin(), s.Ties.end(), [&](const Tie& t1, const Tie& t2) -> bool {
+				if(t1.Team[0] != t2.Team[0])
+					return mAddressOrder[t1.Team[0]] < mAddressOrder[t2.Team[0]];
+				return mAddressOrder[t1.Team[1]] < mAddressOrder[t2.Team[1]];
+				});
+	}
+
+	for(auto& t : s.Ties) {
+		playTie(t, p, rng);
+
+		// as in CupEntry::firstWon()
+		bool firstwon;
+		if(t.Goals[0] > t.Goals[1] || t.Penalties[0] > t.Penalties[1])
+			firstwon = true;
+		else if(t.Goals[1] > t.Goals[0] || t.Penalties[1] > t.Penalties[0])
+			firstwon = false;
+		else if(t.LegsPlayed > 1)
+			firstwon = t.AwayGoals[0] > t.AwayGoals[1];
+		else
+			firstwon = false;
+		s.Next.push_back(t.Team[firstwon ? 0 : 1]);
+	}
+}
+
+void ProgressionForecast::playTie(Tie& t, const Phase& p, std::mt19937& rng) const
+{
+	for(; t.LegsPlayed < p.Legs; t.LegsPlayed++) {
+		int home = t.LegsPlayed & 1;
+		bool last = t.LegsPlayed == p.Legs - 1;
+		MatchRules r(last, last, p.AwayGoals, t.Goals[home], t.Goals[1 - home]);
+		MatchResult res = SimulationStrength::simulate(*mProfiles[t.Team[home]],
+				*mProfiles[t.Team[1 - home]], r, rng);
+		t.Goals[home] += res.HomeGoals;
+		t.Goals[1 - home] += res.AwayGoals;
+		t.AwayGoals[1 - home] += res.AwayGoals;
+		t.Penalties[home] = res.HomePenalties;
+		t.Penalties[1 - home] = res.AwayPenalties;
+	}
+}
+
+void ProgressionForecast::playGroupPhase(const Phase& p, bool first, Scratch& s, std::mt19937& rng) const
+{
+	// s.Ranked has the teams of each group, one group after another
+	if(first) {
+		s.Ranked.assign(mStartGroups.begin(), mStartGroups.end());
+		s.GroupSizes.assign(mStartGroupSizes.begin(), mStartGroupSizes.end());
+		s.Teams.assign(mStartGroups.begin(), mStartGroups.end());
+		for(auto t : s.Ranked)
+			s.Table[t] = mStartTable[t];
+		for(auto& f : mStartFixtures)
+			playGroupMatch(f.Home, f.Away, s, rng);
+	}
+	else {
+		// the teams are divided to the groups as in
+		// StatefulTournament::addGroupStage()
+		s.Ranked.clear();
+		s.GroupSizes.clear();
+		for(unsigned int g = 0; g < p.Groups; g++) {
+			unsigned int n = 0;
+			for(unsigned int i = g; i < s.Teams.size(); i += p.Groups) {
+				s.Ranked.push_back(s.Teams[i]);
+				TableEntry& te = s.Table[s.Teams[i]];
+				te.Points = 0;
+				te.GoalDifference = 0;
+				te.GoalsFor = 0;
+				n++;
+			}
+			s.GroupSizes.push_back(n);
+		}
+
+		// double round robin
+		unsigned int begin = 0;
+		for(auto n : s.GroupSizes) {
+			for(unsigned int i = begin; i < begin + n; i++)
+				for(unsigned int j = begin; j < begin + n; j++)
+					if(i != j)
+						playGroupMatch(s.Ranked[i], s.Ranked[j], s, rng);
+			begin += n;
+		}
+	}
+
+	unsigned int begin = 0;
+	unsigned int maxsize = 0;
+	for(auto n : s.GroupSizes) {
+		rankGroup(begin, begin + n, s);
+		begin += n;
+		maxsize = std::max(maxsize, n);
+	}
+
+	// as in StatefulTournamentStage::getTeamsByPosition()
+	for(unsigned int i = 0; i < maxsize; i++) {
+		begin = 0;
+		for(auto n : s.GroupSizes) {
+			if(i < n)
+				s.Next.push_back(s.Ranked[begin + i]);
+			begin += n;
+		}
+	}
+}
+
+void ProgressionForecast::playGroupMatch(unsigned short home, unsigned short away, Scratch& s, std::mt19937& rng) const
+{
+	static const MatchRules rules(false, false, false);
+	MatchResult r = SimulationStrength::simulate(*mProfiles[home], *mProfiles[away], rules, rng);
+	TableEntry& h = s.Table[home];
+	TableEntry& a = s.Table[away];
+	int diff = (int)r.HomeGoals - (int)r.AwayGoals;
+	h.GoalDifference += diff;
+	a.GoalDifference -= diff;
+	h.GoalsFor += r.HomeGoals;
+	a.GoalsFor += r.AwayGoals;
+	if(diff > 0)
+		h.Points += 3;
+	else if(diff < 0)
+		a.Points += 3;
+	else {
+		h.Points++;
+		a.Points++;
+	}
+}
+
+void ProgressionForecast::rankGroup(unsigned int begin, unsigned int end, Scratch& s) const
+{
+	std::sort(s.Ranked.begin() + begin, s.Ranked.begin() + end, [&](unsigned short a, unsigned short b) -> bool {
+			const TableEntry& e1 = s.Table[a];
+			const TableEntry& e2 = s.Table[b];
+			if(e1.Points != e2.Points)
+				return e1.Points > e2.Points;
+			if(e1.GoalDifference != e2.GoalDifference)
+				return e1.GoalDifference > e2.GoalDifference;
+			if(e1.GoalsFor != e2.GoalsFor)
+				return e1.GoalsFor > e2.GoalsFor;
+			return mNameOrder[a] < mNameOrder[b];
+			});
+}
+
+const std::vector<boost::shared_ptr<StatefulTeam>>& ProgressionForecast::getTeams() const
+{
+	return mTeams;
+}
+
+unsigned int ProgressionForecast::getNumberOfStages() const
+{
+	return mStageNames.size();
+}
+
+const std::string& ProgressionForecast::getStageName(unsigned int stage) const
+{
+	return mStageNames.at(stage);
+}
+
+unsigned int ProgressionForecast::getNumberOfIterations() const
+{
+	return mIterations;
+}
+
+float ProgressionForecast::getReachProbability(unsigned int team, unsigned int stage) const
+{
+	if(!mIterations || team >= mTeams.size() || stage >= mStageNames.size())
+		return 0.0f;
+	return mCounts[team * mStageNames.size() + stage] / (float)mIterations;
+}
+
+float ProgressionForecast::getStandardError(unsigned int team, unsigned int stage) const
+{
+	if(!mIterations)
+		return 1.0f;
+	float p = getReachProbability(team, stage);
+	return sqrt(p * (1.0f - p) / mIterations);
+}
+
+float ProgressionForecast::getMaxStandardError() const
+{
+	float e = mIterations ? 0.0f : 1.0f;
+	for(unsigned int i = 0; i < mTeams.size(); i++)
+		for(unsigned int j = 0; j < mStageNames.size(); j++)
+			e = std::max(e, getStandardError(i, j));
+	return e;
+}
+
+}
+
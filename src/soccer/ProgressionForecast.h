@@ -0,0 +1,124 @@
+#ifndef SOCCER_PROGRESSIONFORECAST_H
+#define SOCCER_PROGRESSIONFORECAST_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <boost/shared_ptr.hpp>
+
+namespace Soccer {
+
+class StatefulCup;
+class StatefulTournament;
+class StatefulLeague;
+class StatefulTeam;
+struct SimulationProfile;
+
+// Estimates how far each team gets in a cup or a tournament by playing the
+// rest of it many times with the statistical match model, including the
+// draws of the later rounds and the tie-break rules. The competition itself
+// isn't changed.
+class ProgressionForecast {
+	public:
+		ProgressionForecast(const StatefulCup& c);
+		ProgressionForecast(const StatefulTournament& t);
+
+		// numthreads 0: number of CPUs. The result only depends on the
+		// seed and the number of threads.
+		void run(unsigned int iterations, unsigned int numthreads = 0, unsigned int seed = 1);
+		// runs batches until getMaxStandardError() is at most maxerror or
+		// maxiterations have been run. Returns the number of iterations.
+		unsigned int runUntil(float maxerror, unsigned int maxiterations,
+				unsigned int numthreads = 0, unsigned int seed = 1);
+
+		// the teams still in the competition
+		const std::vector<boost::shared_ptr<StatefulTeam>>& getTeams() const;
+		// the current stage, the later stages and the winner
+		unsigned int getNumberOfStages() const;
+		const std::string& getStageName(unsigned int stage) const;
+		unsigned int getNumberOfIterations() const;
+		float getReachProbability(unsigned int team, unsigned int stage) const;
+		// standard error of getReachProbability()
+		float getStandardError(unsigned int team, unsigned int stage) const;
+		float getMaxStandardError() const;
+
+	private:
+		struct Phase {
+			bool Group;
+			unsigned int Teams;
+			unsigned int Groups;
+			unsigned int Legs;
+			bool AwayGoals;
+		};
+
+		struct Tie {
+			unsigned short Team[2];
+			unsigned int LegsPlayed;
+			int Goals[2];
+			int AwayGoals[2];
+			int Penalties[2]; // of the last leg
+		};
+
+		struct TableEntry {
+			int Points;
+			int GoalDifference;
+			int GoalsFor;
+		};
+
+		struct Fixture {
+			unsigned short Home;
+			unsigned short Away;
+		};
+
+		// per thread, reused for each iteration
+		struct Scratch {
+			std::vector<unsigned short> Teams;
+			std::vector<unsigned short> Next;
+			std::vector<Tie> Ties;
+			std::vector<TableEntry> Table;
+			std::vector<unsigned short> Ranked;
+			std::vector<unsigned int> GroupSizes;
+		};
+
+		unsigned short addTeam(const boost::shared_ptr<StatefulTeam>& t);
+		void addCupPhase(const StatefulCup& c);
+		void addGroupPhase(const std::vector<boost::shared_ptr<StatefulLeague>>& groups);
+		void addStageName(const Phase& p);
+		void finishSetup();
+
+		void work(unsigned int iterations, unsigned int seed, unsigned int threadnum,
+				std::vector<unsigned int>& counts) const;
+		void playKnockoutPhase(const Phase& p, bool first, Scratch& s, std::mt19937& rng) const;
+		void playGroupPhase(const Phase& p, bool first, Scratch& s, std::mt19937& rng) const;
+		void playTie(Tie& t, const Phase& p, std::mt19937& rng) const;
+		void playGroupMatch(unsigned short home, unsigned short away, Scratch& s, std::mt19937& rng) const;
+		void rankGroup(unsigned int begin, unsigned int end, Scratch& s) const;
+
+		std::vector<boost::shared_ptr<StatefulTeam>> mTeams;
+		std::vector<boost::shared_ptr<const SimulationProfile>> mProfiles;
+		std::vector<unsigned int> mNameOrder;
+		// order of the teams in StatefulCup's entry map
+		std::vector<unsigned int> mAddressOrder;
+
+		std::vector<Phase> mPhases;
+		std::vector<std::string> mStageNames;
+		// after the last phase, only the first team has won unless the
+		// competition ends after one cup round
+		bool mAllAdvance;
+
+		// state of the current phase
+		std::vector<Tie> mStartTies;
+		std::vector<TableEntry> mStartTable;
+		std::vector<Fixture> mStartFixtures;
+		std::vector<unsigned short> mStartGroups; // teams of the groups in order
+		std::vector<unsigned int> mStartGroupSizes;
+
+		// number of times team i reached stage j: i * stages + j
+		std::vector<unsigned int> mCounts;
+		unsigned int mIterations;
+};
+
+}
+
+#endif
+
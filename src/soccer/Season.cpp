@@ -8,6 +8,41 @@ StatefulLeagueSystem::StatefulLeagueSystem()
 {
 }
 
+boost::shared_ptr<StatefulLeagueSystem> StatefulLeagueSystem::create(const LeagueSystem& country)
+{
+	std::map<boost::shared_ptr<Team>, boost::shared_ptr<StatefulTeam>> teams;
+	return create(country, boost::shared_ptr<Team>(), teams);
+}
+
+boost::shared_ptr<StatefulLeagueSystem> StatefulLeagueSystem::create(const LeagueSystem& country,
+		boost::shared_ptr<Team> humanteam,
+		std::map<boost::shared_ptr<Team>, boost::shared_ptr<StatefulTeam>>& teams)
+{
+	boost::shared_ptr<StatefulLeagueSystem> leaguesystem(new StatefulLeagueSystem());
+	std::map<unsigned int, boost::shared_ptr<StatefulLeague>> leagues;
+
+	for(auto& l : country.getContainer()) {
+		if(l.second->getName() == "Non-League")
+			continue;
+		assert(leagues.find(l.second->getLevel()) == leagues.end());
+
+		std::vector<boost::shared_ptr<StatefulTeam>> leagueteams;
+		for(auto& t : l.second->getContainer()) {
+			boost::shared_ptr<StatefulTeam> st(new StatefulTeam(*t.second,
+						TeamController(humanteam && t.second == humanteam, 0),
+						AITactics::createTeamTactics(*t.second)));
+			teams.insert({t.second, st});
+			leagueteams.push_back(st);
+		}
+		leagues.insert({l.second->getLevel(), boost::shared_ptr<StatefulLeague>(new
+					StatefulLeague(leagueteams, l.second->getLevel()))});
+	}
+
+	for(auto& l : leagues)
+		leaguesystem->addLeague(l.second);
+	return leaguesystem;
+}
+
 void StatefulLeagueSystem::addLeague(boost::shared_ptr<StatefulLeague> l)
 {
 	mLeagues.push_back(l);
@@ -26,54 +61,63 @@ std::vector<boost::shared_ptr<StatefulLeague>>& StatefulLeagueSystem::getLeagues
 void StatefulLeagueSystem::promoteAndRelegateTeams()
 {
 	std::vector<std::vector<boost::shared_ptr<StatefulTeam>>> oldLeagueTeams;
-	std::vector<std::vector<boost::shared_ptr<StatefulTeam>>> newLeagueTeams;
+	std::vector<unsigned int> promoted;
+	std::vector<unsigned int> relegated;
 
 	for(auto it = mLeagues.begin(); it != mLeagues.end(); ++it) {
-		oldLeagueTeams.push_back((*it)->getTeamsByPosition());
+		oldLeagueTeams.push_back((*it)->getRanking());
+		promoted.push_back(getNumberOfPromotedTeams(**it));
+		relegated.push_back(getNumberOfRelegatedTeams(**it));
 	}
 
-	for(auto it = oldLeagueTeams.begin(); it != oldLeagueTeams.end(); ++it) {
-		/* Relegate three teams from this league, promote three teams from the next league */
-		auto thisLeague = *it;
-		++it;
-		if(it == oldLeagueTeams.end()) {
-			newLeagueTeams.push_back(thisLeague);
-			break;
-		}
-		auto nextLeague = *it;
-
+	for(unsigned int i = 0; i < mLeagues.size(); i++) {
+		/* The top teams of the league below are promoted, the bottom
+		 * teams of the league above relegated */
+		const auto& thisLeague = oldLeagueTeams[i];
 		std::vector<boost::shared_ptr<StatefulTeam>> newThisLeague;
-		std::vector<boost::shared_ptr<StatefulTeam>> newNextLeague;
-		unsigned int teamsToMove = 3;
-		if(thisLeague.size() / 2 < teamsToMove)
-			teamsToMove = thisLeague.size() / 2;
-		if(nextLeague.size() / 2 < teamsToMove)
-			teamsToMove = nextLeague.size() / 2;
-
-		for(unsigned int i = 0; i < teamsToMove; i++) {
-			newNextLeague.push_back(thisLeague.back());
-			thisLeague.pop_back();
-			newThisLeague.push_back(nextLeague.front());
-			nextLeague.erase(nextLeague.begin());
+		if(i + 1 < mLeagues.size()) {
+			const auto& nextLeague = oldLeagueTeams[i + 1];
+			newThisLeague.insert(newThisLeague.end(), nextLeague.begin(),
+					nextLeague.begin() + relegated[i]);
 		}
-
-		for(auto t : thisLeague) {
-			newThisLeague.push_back(t);
+		if(i > 0) {
+			const auto& prevLeague = oldLeagueTeams[i - 1];
+			newThisLeague.insert(newThisLeague.end(), prevLeague.rbegin(),
+					prevLeague.rbegin() + promoted[i]);
 		}
+		newThisLeague.insert(newThisLeague.end(), thisLeague.begin() + promoted[i],
+				thisLeague.end() - relegated[i]);
+		mLeagues[i] = boost::shared_ptr<StatefulLeague>(new StatefulLeague(newThisLeague, mLeagues[i]->getLevel()));
+	}
+}
 
-		for(auto t : nextLeague) {
-			newNextLeague.push_back(t);
-		}
+unsigned int StatefulLeagueSystem::getNumberOfTeamsToMove(const StatefulLeague& upper,
+		const StatefulLeague& lower)
+{
+	unsigned int teamsToMove = 3;
+	if(upper.getNumberOfTeams() / 2 < teamsToMove)
+		teamsToMove = upper.getNumberOfTeams() / 2;
+	if(lower.getNumberOfTeams() / 2 < teamsToMove)
+		teamsToMove = lower.getNumberOfTeams() / 2;
+	return teamsToMove;
+}
 
-		newLeagueTeams.push_back(newThisLeague);
-		newLeagueTeams.push_back(newNextLeague);
+unsigned int StatefulLeagueSystem::getNumberOfPromotedTeams(const StatefulLeague& l) const
+{
+	for(unsigned int i = 1; i < mLeagues.size(); i++) {
+		if(mLeagues[i].get() == &l)
+			return getNumberOfTeamsToMove(*mLeagues[i - 1], l);
 	}
+	return 0;
+}
 
-	assert(mLeagues.size() == newLeagueTeams.size());
-
-	for(unsigned int i = 0; i < mLeagues.size(); i++) {
-		mLeagues[i] = boost::shared_ptr<StatefulLeague>(new StatefulLeague(newLeagueTeams[i], mLeagues[i]->getLevel()));
+unsigned int StatefulLeagueSystem::getNumberOfRelegatedTeams(const StatefulLeague& l) const
+{
+	for(unsigned int i = 0; i + 1 < mLeagues.size(); i++) {
+		if(mLeagues[i].get() == &l)
+			return getNumberOfTeamsToMove(l, *mLeagues[i + 1]);
 	}
+	return 0;
 }
 
 
@@ -122,6 +166,25 @@ boost::shared_ptr<StatefulLeagueSystem> Season::getLeagueSystem()
 	return mLeagueSystem;
 }
 
+void Season::setEngineSimulation(bool e)
+{
+	if(mLeague)
+		mLeague->setEngineSimulation(e);
+	if(mCup)
+		mCup->setEngineSimulation(e);
+	if(mTournament)
+		mTournament->setEngineSimulation(e);
+	if(mLeagueSystem) {
+		for(auto& l : mLeagueSystem->getLeagues())
+			l->setEngineSimulation(e);
+	}
+}
+
+bool Season::getEngineSimulation() const
+{
+	return mLeague && mLeague->getEngineSimulation();
+}
+
 void Season::createSchedule()
 {
 	mSchedule.clear();
@@ -176,15 +239,7 @@ boost::shared_ptr<Season> Season::createSeason(boost::shared_ptr<StatefulTeam> t
 	boost::shared_ptr<StatefulLeague> plleague;
 
 	for(auto& l : leaguesystem->getLeagues()) {
-		bool playerLeagueFound = false;
-
-		for(auto& t : l->getTeamsByPosition()) {
-			if(t == team) {
-				playerLeagueFound = true;
-			}
-		}
-
-		if(playerLeagueFound) {
+		if(l->getEntries().find(team) != l->getEntries().end()) {
 			assert(!plleague);
 			plleague = l;
 		}
@@ -209,50 +264,24 @@ boost::shared_ptr<Season> Season::createSeason(boost::shared_ptr<Team> plteam,
 {
 	std::map<boost::shared_ptr<Team>, boost::shared_ptr<StatefulTeam>> allteams;
 
-	boost::shared_ptr<StatefulLeagueSystem> leaguesystem;
-	if(addSystem)
-		leaguesystem = boost::shared_ptr<StatefulLeagueSystem>(new StatefulLeagueSystem());
+	boost::shared_ptr<StatefulLeagueSystem> leaguesystem = StatefulLeagueSystem::create(*country,
+			plteam, allteams);
 	boost::shared_ptr<StatefulCup> cup;
 	boost::shared_ptr<StatefulLeague> plleague;
-	boost::shared_ptr<StatefulTeam> team;
-
-	std::map<unsigned int, boost::shared_ptr<StatefulLeague>> leagues;
-
-	for(auto& l : country->getContainer()) {
-		bool playerLeagueFound = false;
-		assert(leagues.find(l.second->getLevel()) == leagues.end());
-
-		if(l.second->getName() == "Non-League")
-			continue;
-
-		std::vector<boost::shared_ptr<StatefulTeam>> leagueteams;
-		for(auto& t : l.second->getContainer()) {
-			boost::shared_ptr<StatefulTeam> st(new StatefulTeam(*t.second,
-						TeamController(t.second == plteam, 0),
-						AITactics::createTeamTactics(*t.second)));
-			allteams.insert({t.second, st});
-			if(t.second == plteam) {
-				playerLeagueFound = true;
-				team = st;
-			}
-			leagueteams.push_back(st);
-		}
-		boost::shared_ptr<StatefulLeague> league = boost::shared_ptr<StatefulLeague>(new
-				StatefulLeague(leagueteams, l.second->getLevel()));
-		leagues.insert({l.second->getLevel(), league});
 
-		if(playerLeagueFound) {
+	auto plit = allteams.find(plteam);
+	assert(plit != allteams.end());
+	boost::shared_ptr<StatefulTeam> team = plit->second;
+	for(auto& l : leaguesystem->getLeagues()) {
+		if(l->getEntries().find(team) != l->getEntries().end()) {
 			assert(!plleague);
-			plleague = league;
+			plleague = l;
 		}
 	}
 	assert(plleague);
 
-	if(addSystem) {
-		for(auto& l : leagues) {
-			leaguesystem->addLeague(l.second);
-		}
-	}
+	if(!addSystem)
+		leaguesystem = boost::shared_ptr<StatefulLeagueSystem>();
 
 	{
 		std::vector<boost::shared_ptr<StatefulTeam>> cupteams;
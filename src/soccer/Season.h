@@ -2,6 +2,7 @@
 #define SOCCERSEASON_H
 
 #include <boost/shared_ptr.hpp>
+#include <map>
 #include <vector>
 
 #include "common/Serialization.h"
@@ -17,12 +18,27 @@ namespace Soccer {
 class StatefulLeagueSystem {
 	public:
 		StatefulLeagueSystem();
+		// the leagues of a country with AI controlled teams, without the
+		// cup
+		static boost::shared_ptr<StatefulLeagueSystem> create(const LeagueSystem& country);
+		// as above, with humanteam controlled by the human player. The
+		// stateful teams created are added to teams.
+		static boost::shared_ptr<StatefulLeagueSystem> create(const LeagueSystem& country,
+				boost::shared_ptr<Team> humanteam,
+				std::map<boost::shared_ptr<Team>, boost::shared_ptr<StatefulTeam>>& teams);
 		void addLeague(boost::shared_ptr<StatefulLeague> l);
 		void setCup(boost::shared_ptr<StatefulCup> c);
 		std::vector<boost::shared_ptr<StatefulLeague>>& getLeagues();
 		void promoteAndRelegateTeams();
+		// the number of teams moving between the league and the one
+		// above or below at the end of the season, 0 if there's none
+		unsigned int getNumberOfPromotedTeams(const StatefulLeague& l) const;
+		unsigned int getNumberOfRelegatedTeams(const StatefulLeague& l) const;
 
 	private:
+		static unsigned int getNumberOfTeamsToMove(const StatefulLeague& upper,
+				const StatefulLeague& lower);
+
 		std::vector<boost::shared_ptr<StatefulLeague>> mLeagues;
 		boost::shared_ptr<StatefulCup> mCup;
 
@@ -50,6 +66,9 @@ class Season {
 		boost::shared_ptr<StatefulTournament> getTournament();
 		boost::shared_ptr<StatefulLeagueSystem> getLeagueSystem();
 		const std::vector<std::pair<CompetitionType, unsigned int>>& getSchedule() const;
+		// sets engine simulation for all competitions of the season
+		void setEngineSimulation(bool e);
+		bool getEngineSimulation() const;
 
 	private:
 		void createSchedule();
@@ -2,6 +2,7 @@
 #include <stdexcept>
 
 #include "soccer/Team.h"
+#include "soccer/Match.h"
 
 namespace Soccer {
 
@@ -18,6 +19,13 @@ TeamTactics::TeamTactics(const std::map<int, PlayerTactics>& pt,
 {
 }
 
+size_t TeamTactics::getMemoryUsage() const
+{
+	// a map node has three pointers and the color in addition to the value
+	return sizeof(*this) + mTactics.size() *
+		(sizeof(std::pair<const int, PlayerTactics>) + 4 * sizeof(void*));
+}
+
 Kit::Kit(KitType t, const Common::Color& shirt1, const Common::Color& shirt2,
 		const Common::Color& shorts, const Common::Color& socks)
 	: mType(t),
@@ -56,53 +64,71 @@ const Color& Kit::getSocksColor() const
 }
 
 
+size_t TeamRoster::getMemoryUsage() const
+{
+	return sizeof(*this) + PlayerIds.capacity() * sizeof(int) +
+		Players.capacity() * sizeof(boost::shared_ptr<Player>);
+}
+
 Team::Team(int id, const char* name, const Kit& homekit, const Kit& awaykit,
 		const std::vector<int>& players, unsigned int position)
 	: mId(id),
 	mName(name),
-	mPlayerIds(players),
-	mHomeKit(homekit),
-	mAwayKit(awaykit),
+	mRoster(new TeamRoster()),
 	mPosition(position)
 {
+	mRoster->PlayerIds = players;
+	mRoster->HomeKit = homekit;
+	mRoster->AwayKit = awaykit;
 }
 
 Team::Team(int id, const char* name, const Kit& homekit, const Kit& awaykit,
 		const std::vector<boost::shared_ptr<Player>>& players, unsigned int position)
 	: mId(id),
 	mName(name),
-	mPlayers(players),
-	mHomeKit(homekit),
-	mAwayKit(awaykit),
+	mRoster(new TeamRoster()),
 	mPosition(position)
 {
+	mRoster->Players = players;
+	mRoster->HomeKit = homekit;
+	mRoster->AwayKit = awaykit;
+}
+
+TeamRoster& Team::editRoster()
+{
+	if(!mRoster.unique())
+		mRoster.reset(new TeamRoster(*mRoster));
+	return *mRoster;
 }
 
 void Team::addPlayer(boost::shared_ptr<Player> p)
 {
-	mPlayers.push_back(p);
+	editRoster().Players.push_back(p);
+	mVersion++;
 }
 
 const boost::shared_ptr<Player> Team::getPlayer(unsigned int i) const
 {
-	if(i >= mPlayers.size())
+	if(i >= mRoster->Players.size())
 		return boost::shared_ptr<Player>();
 	else
-		return mPlayers[i];
+		return mRoster->Players[i];
 }
 
 void Team::fetchPlayersFromDB(const PlayerDatabase& db)
 {
-	for(auto id : mPlayerIds) {
+	TeamRoster& r = editRoster();
+	for(auto id : r.PlayerIds) {
 		auto it = db.find(id);
 		if(it == db.end()) {
 			std::stringstream ss;
 			ss << "Player " << id << " not found in the player database!";
 			throw std::runtime_error(ss.str());
 		}
-		mPlayers.push_back(it->second);
+		r.Players.push_back(it->second);
 	}
-	mPlayerIds.clear();
+	r.PlayerIds.clear();
+	mVersion++;
 }
 
 int Team::getId() const
@@ -127,12 +153,12 @@ const std::string& Team::getName() const
 
 const std::vector<boost::shared_ptr<Player>>& Team::getPlayers() const
 {
-	return mPlayers;
+	return mRoster->Players;
 }
 
 const boost::shared_ptr<Player> Team::getPlayerById(int i) const
 {
-	for(auto p : mPlayers)
+	for(auto p : mRoster->Players)
 		if(p->getId() == i)
 			return p;
 	return boost::shared_ptr<Player>();
@@ -140,19 +166,29 @@ const boost::shared_ptr<Player> Team::getPlayerById(int i) const
 
 const Kit& Team::getHomeKit() const
 {
-	return mHomeKit;
+	return mRoster->HomeKit;
 }
 
 const Kit& Team::getAwayKit() const
 {
-	return mAwayKit;
+	return mRoster->AwayKit;
+}
+
+unsigned int Team::getVersion() const
+{
+	return mVersion;
+}
+
+boost::shared_ptr<const TeamRoster> Team::getRoster() const
+{
+	return mRoster;
 }
 
 
 StatefulTeam::StatefulTeam(const Team& t, TeamController c, const TeamTactics& tt)
 	: Team(t),
 	mController(c),
-	mTactics(tt)
+	mTactics(new TeamTactics(tt))
 {
 }
 
@@ -166,25 +202,95 @@ TeamController& StatefulTeam::getController()
 	return mController;
 }
 
-TeamTactics& StatefulTeam::getTactics()
+const TeamTactics& StatefulTeam::getTactics() const
 {
-	return mTactics;
+	return *mTactics;
 }
 
-const TeamTactics& StatefulTeam::getTactics() const
+TeamTactics& StatefulTeam::editTactics()
 {
-	return mTactics;
+	mVersion++;
+	if(!mTactics.unique())
+		mTactics.reset(new TeamTactics(*mTactics));
+	return *mTactics;
 }
 
 void StatefulTeam::setTactics(const TeamTactics& t)
 {
-	mTactics = t;
+	mTactics.reset(new TeamTactics(t));
+	mVersion++;
+}
+
+boost::shared_ptr<const SimulationProfile> StatefulTeam::getSimulationProfile() const
+{
+	// may be called from several simulation threads at once
+	boost::shared_ptr<const SimulationProfile> p = boost::atomic_load(&mSimulationProfile);
+	if(!p || p->Version != mVersion) {
+		p.reset(new SimulationProfile(*this));
+		boost::atomic_store(&mSimulationProfile, p);
+	}
+	return p;
 }
 
 StatefulTeam::StatefulTeam()
 {
 }
 
+TeamMemoryUsage::TeamMemoryUsage()
+	: mBytes(0),
+	mUnsharedBytes(0)
+{
+}
+
+void TeamMemoryUsage::addTeam(const Team& t)
+{
+	if(!mTeams.insert(&t).second)
+		return;
+
+	boost::shared_ptr<const TeamRoster> r = t.getRoster();
+	size_t bytes = r->getMemoryUsage();
+	mUnsharedBytes += bytes;
+	if(mRosters.insert(r.get()).second)
+		mBytes += bytes;
+}
+
+void TeamMemoryUsage::addTeam(const StatefulTeam& t)
+{
+	if(mTeams.count(&t))
+		return;
+
+	addTeam(static_cast<const Team&>(t));
+	size_t bytes = t.getTactics().getMemoryUsage();
+	mUnsharedBytes += bytes;
+	if(mTactics.insert(&t.getTactics()).second)
+		mBytes += bytes;
+}
+
+unsigned int TeamMemoryUsage::getNumberOfTeams() const
+{
+	return mTeams.size();
+}
+
+unsigned int TeamMemoryUsage::getNumberOfRosters() const
+{
+	return mRosters.size();
+}
+
+unsigned int TeamMemoryUsage::getNumberOfTactics() const
+{
+	return mTactics.size();
+}
+
+size_t TeamMemoryUsage::getBytes() const
+{
+	return mBytes;
+}
+
+size_t TeamMemoryUsage::getUnsharedBytes() const
+{
+	return mUnsharedBytes;
+}
+
 TeamTactics::TeamTactics()
 {
 }
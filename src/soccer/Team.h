@@ -2,7 +2,9 @@
 #define SOCCER_TEAM_H
 
 #include <vector>
+#include <set>
 #include <boost/shared_ptr.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "common/Color.h"
 #include "common/Serialization.h"
@@ -16,6 +18,7 @@
 namespace Soccer {
 
 class Team;
+struct SimulationProfile;
 
 class TeamTactics {
 	public:
@@ -30,6 +33,8 @@ class TeamTactics {
 		float FastPassing; // dribbling vs. many passes (weighing dribble)
 		float ShootClose;  // far shots vs. close shots (weighing shooting)
 
+		size_t getMemoryUsage() const;
+
 	private:
 		friend class boost::serialization::access;
 		template<class Archive>
@@ -98,6 +103,30 @@ class Kit {
 		}
 };
 
+// The players and the kits of a team. Shared by the copies of a team,
+// e.g. the StatefulTeams created from a team of the database, and copied
+// by the team that changes it.
+struct TeamRoster {
+	std::vector<int> PlayerIds;
+	std::vector<boost::shared_ptr<Player>> Players;
+	Kit HomeKit;
+	Kit AwayKit;
+
+	// not including the players
+	size_t getMemoryUsage() const;
+
+	private:
+	friend class boost::serialization::access;
+	template<class Archive>
+	void serialize(Archive& ar, const unsigned int version)
+	{
+		ar & PlayerIds;
+		ar & Players;
+		ar & HomeKit;
+		ar & AwayKit;
+	}
+};
+
 class Team {
 	public:
 		Team(int id, const char* name, const Kit& homekit, const Kit& awaykit, const std::vector<int>& players,
@@ -117,16 +146,20 @@ class Team {
 		const boost::shared_ptr<Player> getPlayerById(int i) const;
 		const Kit& getHomeKit() const;
 		const Kit& getAwayKit() const;
+		// changes whenever the players or the tactics may have changed
+		unsigned int getVersion() const;
+		boost::shared_ptr<const TeamRoster> getRoster() const;
 
 	protected:
 		int mId;
 		std::string mName;
+		unsigned int mVersion = 0;
 
 	private:
-		std::vector<int> mPlayerIds;
-		std::vector<boost::shared_ptr<Player>> mPlayers;
-		Kit mHomeKit;
-		Kit mAwayKit;
+		// copies the roster first if it's shared
+		TeamRoster& editRoster();
+
+		boost::shared_ptr<TeamRoster> mRoster;
 		unsigned int mPosition;
 
 		friend class boost::serialization::access;
@@ -135,10 +168,16 @@ class Team {
 		{
 			ar & mId;
 			ar & mName;
-			ar & mPlayerIds;
-			ar & mPlayers;
-			ar & mHomeKit;
-			ar & mAwayKit;
+			if(version == 0) {
+				mRoster.reset(new TeamRoster());
+				ar & mRoster->PlayerIds;
+				ar & mRoster->Players;
+				ar & mRoster->HomeKit;
+				ar & mRoster->AwayKit;
+			}
+			else {
+				ar & mRoster;
+			}
 		}
 };
 
@@ -147,14 +186,21 @@ class StatefulTeam : public Team {
 		StatefulTeam(const Team& t, TeamController c, const TeamTactics& tt);
 		const TeamController& getController() const;
 		TeamController& getController();
-		TeamTactics& getTactics();
 		const TeamTactics& getTactics() const;
+		// for changing the tactics in place, copies them first if
+		// they're shared
+		TeamTactics& editTactics();
 		void setTactics(const TeamTactics& t);
+		// the profile is built on first use and rebuilt after the
+		// players or the tactics have changed
+		boost::shared_ptr<const SimulationProfile> getSimulationProfile() const;
 
 	private:
 		TeamController mController;
+		mutable boost::shared_ptr<const SimulationProfile> mSimulationProfile;
 	protected:
-		TeamTactics mTactics;
+		// shared by the copies of the team until changed
+		boost::shared_ptr<TeamTactics> mTactics;
 
 	private:
 		StatefulTeam();
@@ -164,13 +210,43 @@ class StatefulTeam : public Team {
 		{
 			ar & boost::serialization::base_object<Team>(*this);
 			ar & mController;
-			ar & mTactics;
+			if(version == 0) {
+				mTactics.reset(new TeamTactics());
+				ar & *mTactics;
+			}
+			else {
+				ar & mTactics;
+			}
 		}
 };
 
+// Adds up the memory used by the rosters and the tactics of teams,
+// counting the ones shared by several teams once.
+class TeamMemoryUsage {
+	public:
+		TeamMemoryUsage();
+		void addTeam(const Team& t);
+		void addTeam(const StatefulTeam& t);
+		unsigned int getNumberOfTeams() const;
+		unsigned int getNumberOfRosters() const;
+		unsigned int getNumberOfTactics() const;
+		size_t getBytes() const;
+		// if each team had a copy of its roster and tactics
+		size_t getUnsharedBytes() const;
+
+	private:
+		std::set<const void*> mTeams;
+		std::set<const void*> mRosters;
+		std::set<const void*> mTactics;
+		size_t mBytes;
+		size_t mUnsharedBytes;
+};
+
 
 }
 
+BOOST_CLASS_VERSION(Soccer::Team, 1)
+BOOST_CLASS_VERSION(Soccer::StatefulTeam, 1)
 
 #endif
 
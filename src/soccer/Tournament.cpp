@@ -3,6 +3,7 @@
 #include <boost/serialization/export.hpp>
 
 #include "soccer/Tournament.h"
+#include "soccer/Log.h"
 
 using namespace Common;
 
@@ -208,13 +209,21 @@ std::vector<boost::shared_ptr<Match>> StatefulTournamentStage::getCurrentRoundMa
 	return ret;
 }
 
+boost::shared_ptr<StatefulCompetition> StatefulTournamentStage::clone() const
+{
+	boost::shared_ptr<StatefulTournamentStage> s(new StatefulTournamentStage(*this));
+	for(auto& g : s->mTournamentGroups)
+		g = g->clone();
+	return s;
+}
+
 
 StatefulTournament::StatefulTournament(const TournamentConfig& tc, std::vector<boost::shared_ptr<StatefulTeam>>& teams)
 	: mTeams(teams),
 	mConfig(tc)
 {
 	assert(tc.mStages.size());
-	std::cout << tc.mStages.size() << " rounds in tournament.\n";
+	LOG_DEBUG(Competition, "%zu rounds in tournament.\n", tc.mStages.size());
 	mConfig.mStages.back()->addStage(*this);
 	mConfig.mStages.pop_back();
 }
@@ -316,6 +325,20 @@ std::vector<boost::shared_ptr<Match>> StatefulTournament::getCurrentRoundMatches
 	return tr->getCurrentRoundMatches();
 }
 
+boost::shared_ptr<StatefulCompetition> StatefulTournament::clone() const
+{
+	// the stages of the config aren't changed, so they're shared
+	boost::shared_ptr<StatefulTournament> t(new StatefulTournament(*this));
+	for(auto& s : t->mTournamentStages)
+		s = boost::static_pointer_cast<StatefulTournamentStage>(s->clone());
+	return t;
+}
+
+std::vector<boost::shared_ptr<TournamentStage>> StatefulTournament::getRemainingStages() const
+{
+	return std::vector<boost::shared_ptr<TournamentStage>>(mConfig.mStages.rbegin(), mConfig.mStages.rend());
+}
+
 StatefulTournament::StatefulTournament()
 	: mConfig(TournamentConfig("Unnamed"))
 {
@@ -147,6 +147,7 @@ class StatefulTournamentStage : public StatefulCompetition {
 		boost::shared_ptr<StatefulCompetition> getCurrentTournamentGroup();
 		const std::vector<boost::shared_ptr<StatefulCompetition>>& getGroups() const;
 		virtual std::vector<boost::shared_ptr<Match>> getCurrentRoundMatches() const override;
+		virtual boost::shared_ptr<StatefulCompetition> clone() const override;
 
 	private:
 		std::vector<boost::shared_ptr<StatefulCompetition>> mTournamentGroups;
@@ -174,6 +175,9 @@ class StatefulTournament : public StatefulCompetition {
 		const boost::shared_ptr<StatefulTournamentStage> getCurrentStage() const;
 		boost::shared_ptr<StatefulTournamentStage> getCurrentStage();
 		virtual std::vector<boost::shared_ptr<Match>> getCurrentRoundMatches() const override;
+		virtual boost::shared_ptr<StatefulCompetition> clone() const override;
+		// the stages after the current one, in the order they're played
+		std::vector<boost::shared_ptr<TournamentStage>> getRemainingStages() const;
 
 		void addGroupStage(const GroupStage& r);
 		void addKnockoutStage(const KnockoutStage& r);
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <random>
+#include <thread>
+
+#include "soccer/WorldSimulation.h"
+#include "soccer/Continent.h"
+#include "soccer/League.h"
+#include "soccer/Season.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+#include "soccer/Log.h"
+
+namespace Soccer {
+
+WorldSimulation::WorldSimulation(unsigned int seed)
+	: mSeed(seed),
+	mSeason(0),
+	mSeasonTime(0.0)
+{
+}
+
+void WorldSimulation::addLeagueSystem(const std::string& name, boost::shared_ptr<StatefulLeagueSystem> ls)
+{
+	WorldLeagueSystem w;
+	w.Name = name;
+	w.LeagueSystem = ls;
+	w.Matches = 0;
+	w.Seconds = 0.0;
+	mLeagueSystems.push_back(w);
+}
+
+void WorldSimulation::addCountries(const TeamDatabase& db)
+{
+	for(auto& c : db.getContainer()) {
+		for(auto& country : c.second->getContainer()) {
+			boost::shared_ptr<StatefulLeagueSystem> ls = StatefulLeagueSystem::create(*country.second);
+			if(!ls->getLeagues().empty())
+				addLeagueSystem(country.first, ls);
+		}
+	}
+}
+
+void WorldSimulation::playSeason(unsigned int numthreads)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// the largest league systems first so that the threads finish at
+	// about the same time
+	std::vector<unsigned int> order(mLeagueSystems.size());
+	std::vector<unsigned int> sizes(mLeagueSystems.size(), 0);
+	for(unsigned int i = 0; i < mLeagueSystems.size(); i++) {
+		order[i] = i;
+		for(auto& l : mLeagueSystems[i].LeagueSystem->getLeagues())
+			sizes[i] += l->getNumberOfTeams() * l->getNumberOfTeams();
+	}
+	std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+			return sizes[a] > sizes[b]; });
+
+	if(numthreads == 0)
+		numthreads = std::max(1u, std::thread::hardware_concurrency());
+	numthreads = std::max(1u, std::min<unsigned int>(numthreads, mLeagueSystems.size()));
+
+	std::atomic<unsigned int> next(0);
+	std::vector<std::exception_ptr> errors(numthreads);
+	std::vector<std::thread> threads;
+	for(unsigned int t = 0; t < numthreads; t++) {
+		threads.push_back(std::thread([&, t]() {
+			try {
+				while(1) {
+					unsigned int i = next++;
+					if(i >= order.size())
+						return;
+					playLeagueSystem(mLeagueSystems[order[i]], order[i]);
+				}
+			}
+			catch(...) {
+				errors[t] = std::current_exception();
+			}
+		}));
+	}
+	for(auto& t : threads)
+		t.join();
+	for(auto& e : errors)
+		if(e)
+			std::rethrow_exception(e);
+
+	mSeason++;
+	mSeasonTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	LOG_INFO(Simulation, "Season %u: %zu league systems in %.3f s\n", mSeason,
+			mLeagueSystems.size(), mSeasonTime);
+}
+
+void WorldSimulation::playLeagueSystem(WorldLeagueSystem& ls, unsigned int index) const
+{
+	auto start = std::chrono::steady_clock::now();
+	std::seed_seq seq{mSeed, mSeason, index};
+	std::mt19937 rng(seq);
+
+	ls.Matches = 0;
+	for(auto& l : ls.LeagueSystem->getLeagues()) {
+		while(1) {
+			const boost::shared_ptr<Match> m = l->getNextMatch();
+			if(!m)
+				break;
+			MatchResult r = SimulationStrength::simulate(*m->getTeam(0)->getSimulationProfile(),
+					*m->getTeam(1)->getSimulationProfile(), m->getRules(), rng);
+			m->setResult(r);
+			l->matchPlayed(r);
+			ls.Matches++;
+		}
+	}
+	ls.LeagueSystem->promoteAndRelegateTeams();
+
+	ls.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	LOG_DEBUG(Simulation, "%s: %u matches in %.3f s\n", ls.Name.c_str(), ls.Matches, ls.Seconds);
+}
+
+const std::vector<WorldLeagueSystem>& WorldSimulation::getLeagueSystems() const
+{
+	return mLeagueSystems;
+}
+
+unsigned int WorldSimulation::getSeason() const
+{
+	return mSeason;
+}
+
+double WorldSimulation::getSeasonTime() const
+{
+	return mSeasonTime;
+}
+
+}
+
@@ -0,0 +1,57 @@
+#ifndef SOCCER_WORLDSIMULATION_H
+#define SOCCER_WORLDSIMULATION_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace Soccer {
+
+class StatefulLeagueSystem;
+class TeamDatabase;
+
+struct WorldLeagueSystem {
+	std::string Name;
+	boost::shared_ptr<StatefulLeagueSystem> LeagueSystem;
+	// of the last season played
+	unsigned int Matches;
+	double Seconds;
+};
+
+// Plays the seasons of many league systems, e.g. all the countries of the
+// team database, on a pool of threads. All the league matches are
+// simulated with the statistical match model, after which teams are
+// promoted and relegated in each league system. The cups aren't played.
+class WorldSimulation {
+	public:
+		// the results only depend on the seed and the league systems,
+		// not on the number of threads
+		WorldSimulation(unsigned int seed = 1);
+		void addLeagueSystem(const std::string& name, boost::shared_ptr<StatefulLeagueSystem> ls);
+		// adds a league system for each country of the database that
+		// has leagues
+		void addCountries(const TeamDatabase& db);
+
+		// plays the rest of the current season of each league system.
+		// numthreads 0: number of CPUs.
+		void playSeason(unsigned int numthreads = 0);
+
+		const std::vector<WorldLeagueSystem>& getLeagueSystems() const;
+		// number of seasons played
+		unsigned int getSeason() const;
+		// wall time of the last season played
+		double getSeasonTime() const;
+
+	private:
+		void playLeagueSystem(WorldLeagueSystem& ls, unsigned int index) const;
+
+		unsigned int mSeed;
+		unsigned int mSeason;
+		double mSeasonTime;
+		std::vector<WorldLeagueSystem> mLeagueSystems;
+};
+
+}
+
+#endif
+
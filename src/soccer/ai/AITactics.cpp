@@ -3,8 +3,7 @@
 #include "common/Math.h"
 
 #include "soccer/Team.h"
-
-#define TACTICS_DEBUG
+#include "soccer/Log.h"
 
 namespace Soccer {
 
@@ -26,11 +25,9 @@ PlayerSkillValue AITactics::calculatePlayerSkill(const Player& p)
 		p.getSkills().BallControl +
 		p.getSkills().Heading;
 
-#ifdef TACTICS_DEBUG
-	printf("%30s %3.4f %3.4f %3.4f %3.4f\n", p.getName().c_str(),
+	LOG_DEBUG(Tactics, "%30s %3.4f %3.4f %3.4f %3.4f\n", p.getName().c_str(),
 			ps.Goalkeeping, ps.Defending,
 			ps.Midfield, ps.Forward);
-#endif
 
 	return ps;
 }
@@ -43,9 +40,7 @@ TeamTactics AITactics::createTeamTactics(const Team& team, unsigned int def, uns
 
 	std::vector<Item> skillvalues;
 
-#ifdef TACTICS_DEBUG
-	printf("%30s %6s %6s %6s %6s\n", "Name", "GK", "DF", "MF", "FW");
-#endif
+	LOG_DEBUG(Tactics, "%30s %6s %6s %6s %6s\n", "Name", "GK", "DF", "MF", "FW");
 
 	for(auto p : team.getPlayers()) {
 		skillvalues.push_back(std::make_pair(p, calculatePlayerSkill(*p)));
@@ -56,9 +51,8 @@ TeamTactics AITactics::createTeamTactics(const Team& team, unsigned int def, uns
 			return i1.second.Goalkeeping > i2.second.Goalkeeping; });
 
 	boost::shared_ptr<Player> goalkeeper = skillvalues[0].first;
-#ifdef TACTICS_DEBUG
-	std::cout << "Picked GK (" << skillvalues[0].second.Goalkeeping << ") " << goalkeeper->getName() << "\n";
-#endif
+	LOG_DEBUG(Tactics, "Picked GK (%3.4f) %s\n", skillvalues[0].second.Goalkeeping,
+			goalkeeper->getName().c_str());
 	std::vector<boost::shared_ptr<Player>> defenders, midfielders, forwards;
 	skillvalues.erase(skillvalues.begin());
 
@@ -120,25 +114,22 @@ TeamTactics AITactics::createTeamTactics(const Team& team, unsigned int def, uns
 			case 1:
 				defenders.push_back(bestplayer->first);
 				defslots--;
-#ifdef TACTICS_DEBUG
-				std::cout << "Picked DF (" << bestplayer->second.Defending << ") " << bestplayer->first->getName() << "\n";
-#endif
+				LOG_DEBUG(Tactics, "Picked DF (%3.4f) %s\n", bestplayer->second.Defending,
+						bestplayer->first->getName().c_str());
 				break;
 
 			case 2:
 				midfielders.push_back(bestplayer->first);
 				mfslots--;
-#ifdef TACTICS_DEBUG
-				std::cout << "Picked MF (" << bestplayer->second.Midfield << ") " << bestplayer->first->getName() << "\n";
-#endif
+				LOG_DEBUG(Tactics, "Picked MF (%3.4f) %s\n", bestplayer->second.Midfield,
+						bestplayer->first->getName().c_str());
 				break;
 
 			default:
 				forwards.push_back(bestplayer->first);
 				fwslots--;
-#ifdef TACTICS_DEBUG
-				std::cout << "Picked FW (" << bestplayer->second.Forward << ") " << bestplayer->first->getName() << "\n";
-#endif
+				LOG_DEBUG(Tactics, "Picked FW (%3.4f) %s\n", bestplayer->second.Forward,
+						bestplayer->first->getName().c_str());
 				break;
 		}
 		skillvalues.erase(bestplayer);
@@ -169,10 +160,8 @@ TeamTactics AITactics::createTeamTactics(const Team& team, unsigned int def, uns
 		pos++;
 	}
 
-#ifdef TACTICS_DEBUG
-	std::cout << team.getName() << " playing with " << defenders.size() << "-" <<
-		midfielders.size() << "-" << forwards.size() << ".\n";
-#endif
+	LOG_DEBUG(Tactics, "%s playing with %zu-%zu-%zu.\n", team.getName().c_str(),
+			defenders.size(), midfielders.size(), forwards.size());
 
 	assert(tt.mTactics.size() == 11);
 	assert(defenders.size() >= 3 && defenders.size() <= 5);
@@ -227,28 +216,24 @@ TeamTactics AITactics::createTeamTactics(const Team& team, unsigned int def, uns
 
 	float var = maxdiff > 0.001f ? 0.25f / maxdiff : 5.0f;
 
-#ifdef TACTICS_DEBUG
-	printf("Tactics maximum difference:   %3.4f\n", maxdiff);
-	printf("Tactics variance coefficient: %3.4f\n", var);
-#endif
+	LOG_DEBUG(Tactics, "Tactics maximum difference:   %3.4f\n", maxdiff);
+	LOG_DEBUG(Tactics, "Tactics variance coefficient: %3.4f\n", var);
 
 	tt.Pressure    = Common::clamp(0.0f, 0.5f + var * (speddiff + tackdiff), 1.0f);
 	tt.LongBalls   = Common::clamp(0.0f, 0.5f + var * (headdiff - passdiff), 1.0f);
 	tt.FastPassing = Common::clamp(0.0f, 0.5f + var * (passdiff - contdiff), 1.0f);
 	tt.ShootClose  = Common::clamp(0.0f, 0.5f + var * (speddiff - shotdiff), 1.0f);
 
-#ifdef TACTICS_DEBUG
-	printf("Passing:        %3.4f - %3.4f\n", passavg, passdiff);
-	printf("Heading:        %3.4f - %3.4f\n", headingavg, headdiff);
-	printf("Control:        %3.4f - %3.4f\n", controlavg, contdiff);
-	printf("Shooting:       %3.4f - %3.4f\n", shotavg, shotdiff);
-	printf("Tackling:       %3.4f - %3.4f\n", tacklingavg, tackdiff);
-	printf("Speed:          %3.4f - %3.4f\n", speedavg, speddiff);
-	printf("Pressure:       %3.4f\n", tt.Pressure);
-	printf("Long balls:     %3.4f\n", tt.LongBalls);
-	printf("Fast passing:   %3.4f\n", tt.FastPassing);
-	printf("Close shooting: %3.4f\n", tt.ShootClose);
-#endif
+	LOG_DEBUG(Tactics, "Passing:        %3.4f - %3.4f\n", passavg, passdiff);
+	LOG_DEBUG(Tactics, "Heading:        %3.4f - %3.4f\n", headingavg, headdiff);
+	LOG_DEBUG(Tactics, "Control:        %3.4f - %3.4f\n", controlavg, contdiff);
+	LOG_DEBUG(Tactics, "Shooting:       %3.4f - %3.4f\n", shotavg, shotdiff);
+	LOG_DEBUG(Tactics, "Tackling:       %3.4f - %3.4f\n", tacklingavg, tackdiff);
+	LOG_DEBUG(Tactics, "Speed:          %3.4f - %3.4f\n", speedavg, speddiff);
+	LOG_DEBUG(Tactics, "Pressure:       %3.4f\n", tt.Pressure);
+	LOG_DEBUG(Tactics, "Long balls:     %3.4f\n", tt.LongBalls);
+	LOG_DEBUG(Tactics, "Fast passing:   %3.4f\n", tt.FastPassing);
+	LOG_DEBUG(Tactics, "Close shooting: %3.4f\n", tt.ShootClose);
 
 	return tt;
 }
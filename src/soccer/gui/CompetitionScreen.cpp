@@ -1,5 +1,9 @@
+#include <stdlib.h>
+
 #include <algorithm>
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -10,6 +14,7 @@
 #include "soccer/Team.h"
 #include "soccer/League.h"
 #include "soccer/DataExchange.h"
+#include "soccer/MatchWorkerPool.h"
 #include "soccer/gui/Menu.h"
 #include "soccer/gui/CompetitionScreen.h"
 
@@ -38,10 +43,19 @@ CompetitionScreen::CompetitionScreen(boost::shared_ptr<ScreenManager> sm, const
 	if(!mOneRound)
 		mNextRoundButton = addButton("Next Round", Common::Rectangle(0.26f, 0.90f, 0.73f, 0.06f),
 				true, SDLK_n);
+	mEngineButton       = addButton("", Common::Rectangle(0.01f, 0.76f, 0.23f, 0.06f),
+			true, SDLK_e);
+	updateEngineButton();
 
 	updateRoundMatches();
 }
 
+void CompetitionScreen::updateEngineButton()
+{
+	mEngineButton->setText(mCompetition->getEngineSimulation() ?
+			"Simulation: Engine" : "Simulation: Quick");
+}
+
 void CompetitionScreen::addResultLabels(int a, int b, float xp, float yp,
 		float fontsize, Screen& scr, std::vector<boost::shared_ptr<Button>>& labels,
 		const char* suffix)
@@ -146,15 +160,16 @@ bool CompetitionScreen::playNextMatch(bool display)
 		mScreenManager->addScreen(boost::shared_ptr<Screen>(new TeamTacticsScreen(mScreenManager, *m,
 						[&](Match& mp) -> void {
 							RunningMatch rm = RunningMatch(mp);
+							startPreSimulation();
 							MatchResult r;
-							while(!rm.matchFinished(&r)) {
-								sleep(1);
+							while(!rm.waitForMatch(&r, 1000)) {
 								mScreenManager->drawScreen();
 							}
 							if(r.Played) {
 								mp.setResult(r);
 								mCompetition->matchPlayed(r);
 							}
+							finishPreSimulation(r.Played);
 							mScreenManager->dropScreen();
 							updateScreenElements();
 						})));
@@ -176,7 +191,11 @@ bool CompetitionScreen::playNextMatch(bool display)
 			return false;
 		}
 		else {
-			MatchResult r = m->play(false);
+			MatchResult r;
+			if(mCompetition->getEngineSimulation())
+				r = MatchWorkerPool::getInstance().playMatches({m})[0];
+			else
+				r = m->play(false);
 			if(r.Played) {
 				m->setResult(r);
 				mCompetition->matchPlayed(r);
@@ -226,12 +245,103 @@ bool CompetitionScreen::shouldShowSkipButton() const
 				m->getTeam(1)->getController().HumanControlled);
 }
 
+// the seeds are drawn before so that the results don't depend on the
+// order the threads play the matches in
+static std::vector<MatchResult> simulateMatches(const std::vector<boost::shared_ptr<Match>>& matches,
+		const std::vector<unsigned int>& seeds)
+{
+	std::vector<MatchResult> results(matches.size());
+	unsigned int numthreads = std::max(1u, std::thread::hardware_concurrency() - 1);
+	numthreads = std::min<unsigned int>(numthreads, matches.size());
+	std::vector<std::thread> threads;
+	for(unsigned int t = 0; t < numthreads; t++) {
+		threads.push_back(std::thread([&, t]() -> void {
+					for(unsigned int i = t; i < matches.size(); i += numthreads)
+						results[i] = matches[i]->simulate(seeds[i]);
+					}));
+	}
+	for(auto& t : threads)
+		t.join();
+	return results;
+}
+
+void CompetitionScreen::startPreSimulation()
+{
+	// the matches after the next one up to the next human match
+	std::vector<boost::shared_ptr<Match>> round = mCompetition->getCurrentRoundMatches();
+	auto it = std::find(round.begin(), round.end(), mCompetition->getNextMatch());
+	mPreSimulatedMatches.clear();
+	if(it == round.end())
+		return;
+	for(++it; it != round.end(); ++it) {
+		if((*it)->getTeam(0)->getController().HumanControlled ||
+				(*it)->getTeam(1)->getController().HumanControlled)
+			break;
+		mPreSimulatedMatches.push_back(*it);
+	}
+	if(mPreSimulatedMatches.empty())
+		return;
+
+	bool engine = mCompetition->getEngineSimulation();
+	std::vector<boost::shared_ptr<Match>> matches = mPreSimulatedMatches;
+	std::vector<unsigned int> seeds;
+	if(!engine) {
+		for(unsigned int i = 0; i < matches.size(); i++)
+			seeds.push_back(rand());
+	}
+	mPreSimulation = std::async(std::launch::async, [engine, matches, seeds]() -> std::vector<MatchResult> {
+			if(engine)
+				return MatchWorkerPool::getInstance().playMatches(matches);
+			else
+				return simulateMatches(matches, seeds);
+			});
+}
+
+void CompetitionScreen::finishPreSimulation(bool commit)
+{
+	if(!mPreSimulation.valid())
+		return;
+	std::vector<MatchResult> results = mPreSimulation.get();
+	if(commit) {
+		for(unsigned int i = 0; i < mPreSimulatedMatches.size(); i++) {
+			if(!results[i].Played || mCompetition->getNextMatch() != mPreSimulatedMatches[i])
+				break;
+			mPreSimulatedMatches[i]->setResult(results[i]);
+			mCompetition->matchPlayed(results[i]);
+		}
+	}
+	mPreSimulatedMatches.clear();
+}
+
+bool CompetitionScreen::playRoundWithEngine()
+{
+	boost::shared_ptr<Button> label;
+	unsigned int played = MatchWorkerPool::getInstance().playRound(*mCompetition,
+			[&](unsigned int done, unsigned int total) -> void {
+				if(label)
+					removeButton(label);
+				std::stringstream ss;
+				ss << "Playing matches: " << done << "/" << total;
+				label = addLabel(ss.str().c_str(), 0.50f, 0.80f, TextAlignment::Centered, 0.8f);
+				mScreenManager->drawScreen();
+			});
+	if(label)
+		removeButton(label);
+	return played != 0;
+}
+
 void CompetitionScreen::skipMatches()
 {
 	while(shouldShowSkipButton()) {
-		bool done = playNextMatch(false);
-		if(done)
-			break;
+		if(mCompetition->getEngineSimulation()) {
+			// play the rest of the round at once
+			if(!playRoundWithEngine() || !mCompetition->getNextMatch())
+				break;
+		} else {
+			bool done = playNextMatch(false);
+			if(done)
+				break;
+		}
 		if(mOneRound && allRoundMatchesPlayed())
 			break;
 		updateRoundMatches();
@@ -287,6 +397,10 @@ void CompetitionScreen::buttonPressed(boost::shared_ptr<Button> button)
 	else if(buttonText == "Match") {
 		match();
 	}
+	else if(button == mEngineButton) {
+		mCompetition->setEngineSimulation(!mCompetition->getEngineSimulation());
+		updateEngineButton();
+	}
 }
 
 const std::string& CompetitionScreen::getName() const
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <future>
 #include <boost/shared_ptr.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 
@@ -48,6 +49,10 @@ class CompetitionScreen : public Screen {
 		bool shouldShowSkipButton() const;
 		void saveCompetition() const;
 		void updateNextRoundButton();
+		void updateEngineButton();
+		bool playRoundWithEngine();
+		void startPreSimulation();
+		void finishPreSimulation(bool commit);
 		void skipMatches();
 		void nextRound();
 		void skip();
@@ -61,9 +66,14 @@ class CompetitionScreen : public Screen {
 		boost::shared_ptr<Button> mResultButton;
 		boost::shared_ptr<Button> mMatchButton;
 		boost::shared_ptr<Button> mNextRoundButton;
+		boost::shared_ptr<Button> mEngineButton;
 		std::vector<boost::shared_ptr<Button>> mResultLabels;
 		std::vector<boost::shared_ptr<Match>> mRoundMatches;
 
+		// other matches of the round played while the user plays theirs
+		std::future<std::vector<MatchResult>> mPreSimulation;
+		std::vector<boost::shared_ptr<Match>> mPreSimulatedMatches;
+
 		bool mOneRound;
 };
 
@@ -11,17 +11,101 @@
 #include "soccer/DataExchange.h"
 #include "soccer/gui/Menu.h"
 #include "soccer/gui/CupScreen.h"
+#include "soccer/gui/LeagueScreen.h"
 
 namespace Soccer {
 
 CupScreen::CupScreen(boost::shared_ptr<ScreenManager> sm, boost::shared_ptr<StatefulCup> l,
 		bool onlyOneRound)
 	: CompetitionScreen(sm, "Cup", l, onlyOneRound),
-	mCup(l)
+	mCup(l),
+	mShowForecast(false)
 {
+	mForecastButton = addButton("Forecast", Common::Rectangle(0.01f, 0.69f, 0.23f, 0.06f),
+			true, SDLK_f);
 	updateScreenElements();
 }
 
+void CupScreen::buttonPressed(boost::shared_ptr<Button> button)
+{
+	if(button == mForecastButton) {
+		mShowForecast = !mShowForecast;
+		mForecastButton->setText(mShowForecast ? "Hide Forecast" : "Forecast");
+		drawTable();
+	}
+	else {
+		CompetitionScreen::buttonPressed(button);
+	}
+}
+
+bool CupScreen::drawTable()
+{
+	for(auto lbl : mTableLabels) {
+		removeButton(lbl);
+	}
+	mTableLabels.clear();
+
+	if(!mShowForecast)
+		return false;
+
+	if(!mForecast || mForecastNextMatch != mCup->getNextMatch()) {
+		mForecast = boost::shared_ptr<ProgressionForecast>(new ProgressionForecast(*mCup));
+		mForecast->runUntil(0.005f, 50000);
+		mForecastNextMatch = mCup->getNextMatch();
+	}
+	drawForecast(*this, mTableLabels, *mForecast, 0.05f, 0.09f);
+	return true;
+}
+
+void CupScreen::drawForecast(Screen& scr, std::vector<boost::shared_ptr<Button>>& labels,
+		const ProgressionForecast& f, float x, float y)
+{
+	// the chances to reach the last few stages, best teams first
+	const unsigned int maxStages = 4;
+	const unsigned int maxRows = 24;
+	unsigned int numstages = f.getNumberOfStages();
+	unsigned int firststage = numstages > maxStages + 1 ? numstages - maxStages : 1;
+
+	std::vector<unsigned int> order(f.getTeams().size());
+	for(unsigned int i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) -> bool {
+			for(unsigned int s = numstages; s-- > firststage; ) {
+				float pa = f.getReachProbability(a, s);
+				float pb = f.getReachProbability(b, s);
+				if(pa != pb)
+					return pa > pb;
+			}
+			return a < b; });
+	if(order.size() > maxRows)
+		order.resize(maxRows);
+
+	x -= 0.05f;
+	LeagueScreen::addTableText(scr, "Team", x + 0.05f, y, TextAlignment::MiddleLeft, Common::Color::White, labels);
+	for(unsigned int s = firststage; s < numstages; s++) {
+		LeagueScreen::addTableText(scr, f.getStageName(s).c_str(), x + 0.25f + (s - firststage) * 0.08f, y,
+				TextAlignment::MiddleLeft, Common::Color::White, labels);
+	}
+	y += 0.03f;
+
+	char buf[32];
+	for(auto i : order) {
+		const boost::shared_ptr<StatefulTeam>& t = f.getTeams()[i];
+		const Common::Color textColor = t->getController().HumanControlled ?
+			Common::Color(128, 128, 255) : Common::Color::White;
+		LeagueScreen::addTableText(scr, t->getName().c_str(), x + 0.05f, y,
+				TextAlignment::MiddleLeft, textColor, labels);
+		for(unsigned int s = firststage; s < numstages; s++) {
+			snprintf(buf, 31, "%.1f%%", f.getReachProbability(i, s) * 100.0f);
+			LeagueScreen::addTableText(scr, buf, x + 0.25f + (s - firststage) * 0.08f, y,
+					TextAlignment::MiddleLeft, Common::Color::White, labels);
+		}
+		y += 0.03f;
+	}
+	snprintf(buf, 31, "%u runs", f.getNumberOfIterations());
+	LeagueScreen::addTableText(scr, buf, x + 0.05f, y, TextAlignment::MiddleLeft, Common::Color::White, labels);
+}
+
 void CupScreen::saveCompetition(boost::archive::binary_oarchive& oa) const
 {
 	oa << mCup;
@@ -6,6 +6,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "soccer/Cup.h"
+#include "soccer/ProgressionForecast.h"
 
 #include "soccer/gui/CompetitionScreen.h"
 #include "soccer/gui/TeamTacticsScreen.h"
@@ -16,12 +17,21 @@ class CupScreen : public CompetitionScreen {
 	public:
 		CupScreen(boost::shared_ptr<ScreenManager> sm, boost::shared_ptr<StatefulCup> l,
 				bool onlyOneRound = false);
+		virtual void buttonPressed(boost::shared_ptr<Button> button) override;
+		virtual bool drawTable() override;
+		static void drawForecast(Screen& scr, std::vector<boost::shared_ptr<Button>>& labels,
+				const ProgressionForecast& f, float x, float y);
 
 	protected:
 		virtual void saveCompetition(boost::archive::binary_oarchive& oa) const override;
 
 	private:
+		std::vector<boost::shared_ptr<Button>> mTableLabels;
 		boost::shared_ptr<StatefulCup> mCup;
+		boost::shared_ptr<Button> mForecastButton;
+		bool mShowForecast;
+		boost::shared_ptr<ProgressionForecast> mForecast;
+		boost::shared_ptr<Match> mForecastNextMatch;
 };
 
 }
@@ -51,8 +51,7 @@ void FriendlyScreen::clickedDone()
 					[&](Match& m) -> void {
 					RunningMatch rm = RunningMatch(m);
 					MatchResult r;
-					while(!rm.matchFinished(&r)) {
-						sleep(1);
+					while(!rm.waitForMatch(&r, 1000)) {
 						mScreenManager->drawScreen();
 					}
 					m.setResult(r);
@@ -8,6 +8,7 @@
 
 #include "soccer/Match.h"
 #include "soccer/Team.h"
+#include "soccer/Season.h"
 #include "soccer/DataExchange.h"
 #include "soccer/gui/Menu.h"
 #include "soccer/gui/LeagueScreen.h"
@@ -15,13 +16,36 @@
 namespace Soccer {
 
 LeagueScreen::LeagueScreen(boost::shared_ptr<ScreenManager> sm, boost::shared_ptr<StatefulLeague> l,
-		bool onlyOneRound)
+		bool onlyOneRound, boost::shared_ptr<StatefulLeagueSystem> ls)
 	: CompetitionScreen(sm, "League", l, onlyOneRound),
-	mLeague(l)
+	mLeague(l),
+	mLeagueSystem(ls),
+	mShowForecast(false),
+	mForecastMatchesPlayed(0)
 {
+	mForecastButton = addButton("", Common::Rectangle(0.01f, 0.69f, 0.23f, 0.06f),
+			true, SDLK_f);
+	updateForecastButton();
 	updateScreenElements();
 }
 
+void LeagueScreen::updateForecastButton()
+{
+	mForecastButton->setText(mShowForecast ? "Table" : "Forecast");
+}
+
+void LeagueScreen::buttonPressed(boost::shared_ptr<Button> button)
+{
+	if(button == mForecastButton) {
+		mShowForecast = !mShowForecast;
+		updateForecastButton();
+		drawTable();
+	}
+	else {
+		CompetitionScreen::buttonPressed(button);
+	}
+}
+
 void LeagueScreen::saveCompetition(boost::archive::binary_oarchive& oa) const
 {
 	oa << mLeague;
@@ -48,7 +72,7 @@ void LeagueScreen::drawTable(Screen& scr, std::vector<boost::shared_ptr<Button>>
 	addTableText(scr, "P",       x + 0.53f, y, TextAlignment::MiddleLeft, Common::Color::White, labels);
 	y += 0.03f;
 
-	std::vector<boost::shared_ptr<StatefulTeam>> es = l.getTeamsByPosition();
+	const std::vector<boost::shared_ptr<StatefulTeam>>& es = l.getRanking();
 
 	for(auto e : es) {
 		const auto& le = l.getEntries().find(e);
@@ -85,10 +109,71 @@ bool LeagueScreen::drawTable()
 	}
 	mTableLabels.clear();
 
-	drawTable(*this, mTableLabels, *mLeague, 0.05f, 0.09f);
+	if(mShowForecast)
+		drawForecast(0.05f, 0.09f);
+	else
+		drawTable(*this, mTableLabels, *mLeague, 0.05f, 0.09f);
 	return true;
 }
 
+void LeagueScreen::drawForecast(float x, float y)
+{
+	const unsigned int iterations = 10000;
+	unsigned int promoted = 0;
+	unsigned int relegated = 0;
+	if(mLeagueSystem) {
+		promoted = mLeagueSystem->getNumberOfPromotedTeams(*mLeague);
+		relegated = mLeagueSystem->getNumberOfRelegatedTeams(*mLeague);
+	}
+
+	unsigned int played = 0;
+	for(auto& e : mLeague->getEntries())
+		played += e.second.Matches;
+	if(!mForecast || mForecast->getNumberOfIterations() == 0 ||
+			mForecastMatchesPlayed != played) {
+		mForecast = boost::shared_ptr<LeagueForecast>(new LeagueForecast(*mLeague, promoted, relegated));
+		mForecast->run(iterations);
+		mForecastMatchesPlayed = played;
+	}
+
+	char buf[32];
+	std::string top = "Top " + std::to_string(promoted);
+	std::string bottom = "Bottom " + std::to_string(relegated);
+	x -= 0.05f;
+	addTableText(*this, "Team",         x + 0.05f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+	addTableText(*this, "P",            x + 0.25f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+	addTableText(*this, "Title",        x + 0.30f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+	if(promoted)
+		addTableText(*this, top.c_str(),    x + 0.38f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+	if(relegated)
+		addTableText(*this, bottom.c_str(), x + 0.46f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+	y += 0.03f;
+
+	const auto& teams = mForecast->getTeams();
+	for(unsigned int i = 0; i < teams.size(); i++) {
+		const auto& le = mLeague->getEntries().find(teams[i]);
+		assert(le != mLeague->getEntries().end());
+
+		const Common::Color textColor = teams[i]->getController().HumanControlled ?
+			Common::Color(128, 128, 255) : Common::Color::White;
+		addTableText(*this, teams[i]->getName().c_str(), x + 0.05f, y,
+				TextAlignment::MiddleLeft, textColor, mTableLabels);
+		addTableText(*this, std::to_string(le->second.Points).c_str(), x + 0.25f, y,
+				TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+		snprintf(buf, 31, "%.1f%%", mForecast->getTitleProbability(i) * 100.0f);
+		addTableText(*this, buf, x + 0.30f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+		if(promoted) {
+			snprintf(buf, 31, "%.1f%%", mForecast->getPromotionProbability(i) * 100.0f);
+			addTableText(*this, buf, x + 0.38f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+		}
+		if(relegated) {
+			snprintf(buf, 31, "%.1f%%", mForecast->getRelegationProbability(i) * 100.0f);
+			addTableText(*this, buf, x + 0.46f, y, TextAlignment::MiddleLeft, Common::Color::White, mTableLabels);
+		}
+		y += 0.03f;
+	}
+}
+
 }
 
 
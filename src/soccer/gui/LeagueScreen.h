@@ -6,16 +6,23 @@
 #include <boost/shared_ptr.hpp>
 
 #include "soccer/League.h"
+#include "soccer/LeagueForecast.h"
 
 #include "soccer/gui/CompetitionScreen.h"
 #include "soccer/gui/TeamTacticsScreen.h"
 
 namespace Soccer {
 
+class StatefulLeagueSystem;
+
 class LeagueScreen : public CompetitionScreen {
 	public:
+		// ls: the league system of the league, if any, for the
+		// promotion and relegation forecast
 		LeagueScreen(boost::shared_ptr<ScreenManager> sm, boost::shared_ptr<StatefulLeague> l,
-				bool onlyOneRound = false);
+				bool onlyOneRound = false,
+				boost::shared_ptr<StatefulLeagueSystem> ls = boost::shared_ptr<StatefulLeagueSystem>());
+		virtual void buttonPressed(boost::shared_ptr<Button> button) override;
 		virtual bool drawTable() override;
 		static void drawTable(Screen& scr, std::vector<boost::shared_ptr<Button>>& labels, const StatefulLeague& l, float x, float y);
 		static void addTableText(Screen& scr, const char* text, float x, float y,
@@ -26,8 +33,16 @@ class LeagueScreen : public CompetitionScreen {
 		virtual void saveCompetition(boost::archive::binary_oarchive& oa) const override;
 
 	private:
+		void drawForecast(float x, float y);
+		void updateForecastButton();
+
 		std::vector<boost::shared_ptr<Button>> mTableLabels;
 		boost::shared_ptr<StatefulLeague> mLeague;
+		boost::shared_ptr<StatefulLeagueSystem> mLeagueSystem;
+		boost::shared_ptr<Button> mForecastButton;
+		bool mShowForecast;
+		boost::shared_ptr<LeagueForecast> mForecast;
+		unsigned int mForecastMatchesPlayed;
 };
 
 }
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <iostream>
 #include <stdexcept>
@@ -74,6 +75,20 @@ Menu::Menu()
 				for(auto t : league.second->getContainer())
 					t.second->fetchPlayersFromDB(mPlayers);
 
+	// fitted by freekick3-calibrate, if available
+	std::string simfiles[] = { getDataDir() + "/share/Simulation.xml", "share/Simulation.xml" };
+	for(auto& fn : simfiles) {
+		if(access(fn.c_str(), R_OK))
+			continue;
+		try {
+			SimulationParameters::set(DataExchange::parseSimulationParametersFile(fn.c_str()));
+		} catch(std::exception& e) {
+			std::cerr << "Note: could not load simulation parameters: " << e.what() << "\n";
+			continue;
+		}
+		break;
+	}
+
 	mScreenManager->addScreen(boost::shared_ptr<Screen>(new MainMenuScreen(mScreenManager)));
 }
 
@@ -7,6 +7,7 @@
 
 #include "soccer/Match.h"
 #include "soccer/Team.h"
+#include "soccer/MatchWorkerPool.h"
 
 #include "soccer/gui/Menu.h"
 #include "soccer/gui/LeagueScreen.h"
@@ -32,11 +33,21 @@ SeasonScreen::SeasonScreen(boost::shared_ptr<ScreenManager> sm, boost::shared_pt
 	mFinishButton     = addButton("Finish Season", Common::Rectangle(0.26f, 0.90f, 0.73f, 0.06f),
 			true, SDLK_f);
 	mFinishButton->hide();
+	mEngineButton     = addButton("",              Common::Rectangle(0.01f, 0.76f, 0.23f, 0.06f),
+			true, SDLK_e);
+	updateEngineButton();
 	addMatchPlan();
 }
 
+void SeasonScreen::updateEngineButton()
+{
+	mEngineButton->setText(mSeason->getEngineSimulation() ?
+			"Simulation: Engine" : "Simulation: Quick");
+}
+
 void SeasonScreen::onReentry()
 {
+	updateEngineButton();
 	addMatchPlan();
 }
 
@@ -77,15 +88,13 @@ void SeasonScreen::addMatchPlan()
 			break;
 		}
 
-		/* r might be a null pointer if the participants aren't clear yet (cup) */
-		if(std::get<2>(ctr)) {
-			for(auto m : std::get<2>(ctr)->getMatches()) {
-				if(m->getTeam(0) == mSeason->getTeam() ||
-						m->getTeam(1) == mSeason->getTeam()) {
-					CompetitionScreen::addMatchLabels(*m, x, y, 0.6f,
-							*this, mMatchPlanLabels, false);
-					break;
-				}
+		/* the round might be empty if the participants aren't clear yet (cup) */
+		for(auto m : std::get<2>(ctr)) {
+			if(m->getTeam(0) == mSeason->getTeam() ||
+					m->getTeam(1) == mSeason->getTeam()) {
+				CompetitionScreen::addMatchLabels(*m, x, y, 0.6f,
+						*this, mMatchPlanLabels, false);
+				break;
 			}
 		}
 
@@ -111,9 +120,9 @@ void SeasonScreen::nextRound()
 	unsigned int i = 0;
 	for(i = 0; i < mSeason->getSchedule().size(); i++) {
 		RoundTuple ct = getRound(i);
-		assert(std::get<2>(ct));
-		assert(std::get<2>(ct)->getMatches().size());
-		if(!std::get<2>(ct)->getMatches()[std::get<2>(ct)->getMatches().size() - 1]->getResult().Played) {
+		const std::vector<boost::shared_ptr<Match>>& r = std::get<2>(ct);
+		assert(r.size());
+		if(!r.back()->getResult().Played) {
 			if(i > 15)
 				mPlanPos = i - 10;
 			else
@@ -124,7 +133,7 @@ void SeasonScreen::nextRound()
 				{
 					mScreenManager->addScreen(boost::shared_ptr<Screen>(new LeagueScreen(mScreenManager,
 									mSeason->getLeague(),
-									true)));
+									true, mSeason->getLeagueSystem())));
 				}
 				break;
 
@@ -161,11 +170,14 @@ void SeasonScreen::finishSeason()
 {
 	assert(mSeason->getLeagueSystem());
 	// play all the matches of the divisions
+	bool engine = mSeason->getEngineSimulation();
 	for(auto& l : mSeason->getLeagueSystem()->getLeagues()) {
 		while(1) {
 			const boost::shared_ptr<Match> m = l->getNextMatch();
 			if(!m)
 				break;
+			if(engine && MatchWorkerPool::getInstance().playRound(*l))
+				continue;
 			MatchResult r = m->play(false);
 			assert(r.Played);
 			m->setResult(r);
@@ -174,6 +186,7 @@ void SeasonScreen::finishSeason()
 	}
 	mSeason->getLeagueSystem()->promoteAndRelegateTeams();
 	mSeason = Season::createSeason(mSeason->getTeam(), mSeason->getLeagueSystem());
+	mSeason->setEngineSimulation(engine);
 	mFinishButton->hide();
 	mNextRoundButton->show();
 	mPlanPos = 0;
@@ -212,6 +225,9 @@ void SeasonScreen::buttonPressed(boost::shared_ptr<Button> button)
 		scrollUp();
 	} else if(buttonText == "Next") {
 		scrollDown();
+	} else if(button == mEngineButton) {
+		mSeason->setEngineSimulation(!mSeason->getEngineSimulation());
+		updateEngineButton();
 	}
 }
 
@@ -240,7 +256,7 @@ SeasonScreen::RoundTuple SeasonScreen::getRound(unsigned int i) const
 {
 	auto ss = mSeason->getSchedule();
 	if(ss.size() <= i) {
-		return RoundTuple(CompetitionType::League, 0, nullptr);
+		return RoundTuple(CompetitionType::League, 0, std::vector<boost::shared_ptr<Match>>());
 	}
 
 	auto ct = ss[i];
@@ -249,30 +265,27 @@ SeasonScreen::RoundTuple SeasonScreen::getRound(unsigned int i) const
 		case CompetitionType::League:
 		{
 			const Schedule& s = mSeason->getLeague()->getSchedule();
-			const Round* r = s.getRound(ct.second);
-			return RoundTuple(CompetitionType::League, ct.second, r);
+			return RoundTuple(CompetitionType::League, ct.second, s.getMatches(ct.second));
 		}
 		break;
 
 		case CompetitionType::Cup:
 		{
 			const Schedule& s = mSeason->getCup()->getSchedule();
-			const Round* r = s.getRound(ct.second);
-			return RoundTuple(CompetitionType::Cup, ct.second, r);
+			return RoundTuple(CompetitionType::Cup, ct.second, s.getMatches(ct.second));
 		}
 		break;
 
 		case CompetitionType::Tournament:
 		{
 			const Schedule& s = mSeason->getTournament()->getSchedule();
-			const Round* r = s.getRound(ct.second);
-			return RoundTuple(CompetitionType::Tournament, ct.second, r);
+			return RoundTuple(CompetitionType::Tournament, ct.second, s.getMatches(ct.second));
 		}
 		break;
 	}
 
 	assert(0);
-	return RoundTuple(CompetitionType::League, 0, nullptr);
+	return RoundTuple(CompetitionType::League, 0, std::vector<boost::shared_ptr<Match>>());
 }
 
 }
@@ -4,6 +4,7 @@
 #include <tuple>
 #include <map>
 #include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 #include "soccer/Season.h"
@@ -24,10 +25,11 @@ class SeasonScreen : public Screen {
 		void addMatchPlan();
 		void nextRound();
 		void finishSeason();
+		void updateEngineButton();
 		void scrollUp();
 		void scrollDown();
 
-		typedef std::tuple<CompetitionType, unsigned int, const Round*> RoundTuple;
+		typedef std::tuple<CompetitionType, unsigned int, std::vector<boost::shared_ptr<Match>>> RoundTuple;
 		RoundTuple getRound(unsigned int i) const;
 
 		boost::shared_ptr<Season> mSeason;
@@ -37,6 +39,7 @@ class SeasonScreen : public Screen {
 		boost::shared_ptr<Button> mScrollUpButton;
 		boost::shared_ptr<Button> mScrollDownButton;
 		boost::shared_ptr<Button> mFinishButton;
+		boost::shared_ptr<Button> mEngineButton;
 		std::vector<boost::shared_ptr<Button>> mMatchPlanLabels;
 
 		unsigned int mPlanPos;
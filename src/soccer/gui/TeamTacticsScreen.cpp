@@ -384,24 +384,23 @@ void TeamTacticsScreen::buttonPressed(boost::shared_ptr<Button> button)
 					}
 					else {
 						// switch players
-						auto pl1 = mMatch.getTeam(mHumanTeam)->getTactics().mTactics.find(mSelectedPlayer.second);
-						auto pl2 = mMatch.getTeam(mHumanTeam)->getTactics().mTactics.find(it->second);
-						if(pl1 != mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end() &&
-						   pl2 != mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end()) {
+						std::map<int, PlayerTactics>& tactics =
+							mMatch.getTeam(mHumanTeam)->editTactics().mTactics;
+						auto pl1 = tactics.find(mSelectedPlayer.second);
+						auto pl2 = tactics.find(it->second);
+						if(pl1 != tactics.end() && pl2 != tactics.end()) {
 							// both in lineup
 							std::swap(pl1->second, pl2->second);
 						}
-						else if((pl1 == mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end()) !=
-							(pl2 == mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end())) {
+						else if((pl1 == tactics.end()) != (pl2 == tactics.end())) {
 							// only one in lineup
-							auto& value = pl1 == mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end() ?
-								pl2->second : pl1->second;
-							auto key = pl1 == mMatch.getTeam(mHumanTeam)->getTactics().mTactics.end() ?
-								mSelectedPlayer.second : it->second;
-							mMatch.getTeam(mHumanTeam)->getTactics().mTactics.erase(mSelectedPlayer.second);
-							mMatch.getTeam(mHumanTeam)->getTactics().mTactics.erase(it->second);
-							mMatch.getTeam(mHumanTeam)->getTactics().mTactics.insert(std::make_pair(key, value));
-							assert(mMatch.getTeam(mHumanTeam)->getTactics().mTactics.size() == 11);
+							// copied as the entry is erased below
+							auto value = pl1 == tactics.end() ? pl2->second : pl1->second;
+							auto key = pl1 == tactics.end() ? mSelectedPlayer.second : it->second;
+							tactics.erase(mSelectedPlayer.second);
+							tactics.erase(it->second);
+							tactics.insert(std::make_pair(key, value));
+							assert(tactics.size() == 11);
 						}
 						Menu::setButtonDefaultColor(mSelectedPlayer.first);
 						mSelectedPlayer.first = boost::shared_ptr<Button>();
@@ -455,10 +454,11 @@ void TeamTacticsScreen::setTeamTactics()
 {
 	if(mHumanTeam != -1) {
 		assert(mTacticsSliders[mHumanTeam].size() == 4);
-		mMatch.getTeam(mHumanTeam)->getTactics().Pressure    = mTacticsSliders[mHumanTeam][0]->getValue();
-		mMatch.getTeam(mHumanTeam)->getTactics().LongBalls   = mTacticsSliders[mHumanTeam][1]->getValue();
-		mMatch.getTeam(mHumanTeam)->getTactics().FastPassing = mTacticsSliders[mHumanTeam][2]->getValue();
-		mMatch.getTeam(mHumanTeam)->getTactics().ShootClose  = mTacticsSliders[mHumanTeam][3]->getValue();
+		TeamTactics& tactics = mMatch.getTeam(mHumanTeam)->editTactics();
+		tactics.Pressure    = mTacticsSliders[mHumanTeam][0]->getValue();
+		tactics.LongBalls   = mTacticsSliders[mHumanTeam][1]->getValue();
+		tactics.FastPassing = mTacticsSliders[mHumanTeam][2]->getValue();
+		tactics.ShootClose  = mTacticsSliders[mHumanTeam][3]->getValue();
 		mMatch.getTeam(mHumanTeam)->getController().PlayerShirtNumber = mChosenplnum;
 	}
 }
@@ -11,19 +11,26 @@ TournamentScreen::TournamentScreen(boost::shared_ptr<ScreenManager> sm, boost::s
 		bool onlyOneRound)
 	: CompetitionScreen(sm, "Tournament", l, onlyOneRound),
 	mTournament(l),
-	mScrollPosition(0)
+	mScrollPosition(0),
+	mShowForecast(false)
 {
 	mScrollUpButton   = addButton("Prev",       Common::Rectangle(0.25f, 0.04f, 0.20f, 0.04f));
 	mScrollDownButton = addButton("Next",       Common::Rectangle(0.25f, 0.83f, 0.20f, 0.04f));
 	mScrollUpButton->hide();
 	mScrollDownButton->hide();
+	mForecastButton = addButton("Forecast", Common::Rectangle(0.01f, 0.69f, 0.23f, 0.06f),
+			true, SDLK_f);
 	updateScreenElements();
 }
 
 void TournamentScreen::buttonPressed(boost::shared_ptr<Button> button)
 {
 	const std::string& buttonText = button->getText();
-	if(buttonText == "Prev" && mScrollPosition) {
+	if(button == mForecastButton) {
+		mShowForecast = !mShowForecast;
+		mForecastButton->setText(mShowForecast ? "Hide Forecast" : "Forecast");
+		updateScreenElements();
+	} else if(buttonText == "Prev" && mScrollPosition) {
 		mScrollPosition--;
 		updateScreenElements();
 	} else if(buttonText == "Next") {
@@ -54,6 +61,18 @@ bool TournamentScreen::drawTable()
 	}
 	mTableLabels.clear();
 
+	if(mShowForecast) {
+		if(!mForecast || mForecastNextMatch != mTournament->getNextMatch()) {
+			mForecast = boost::shared_ptr<ProgressionForecast>(new ProgressionForecast(*mTournament));
+			mForecast->runUntil(0.005f, 50000);
+			mForecastNextMatch = mTournament->getNextMatch();
+		}
+		mScrollUpButton->hide();
+		mScrollDownButton->hide();
+		CupScreen::drawForecast(*this, mTableLabels, *mForecast, 0.05f, 0.09f);
+		return true;
+	}
+
 	boost::shared_ptr<StatefulTournamentStage> st = mTournament->getCurrentStage();
 	unsigned int totalnumrows = 0;
 	unsigned int skipgroups = mScrollPosition;
@@ -8,6 +8,7 @@
 #include "soccer/Tournament.h"
 
 #include "soccer/gui/LeagueScreen.h"
+#include "soccer/gui/CupScreen.h"
 #include "soccer/gui/TeamTacticsScreen.h"
 
 namespace Soccer {
@@ -34,6 +35,10 @@ class TournamentScreen : public CompetitionScreen {
 		unsigned int mActiveScrollPosition;
 		boost::shared_ptr<Button> mScrollUpButton;
 		boost::shared_ptr<Button> mScrollDownButton;
+		boost::shared_ptr<Button> mForecastButton;
+		bool mShowForecast;
+		boost::shared_ptr<ProgressionForecast> mForecast;
+		boost::shared_ptr<Match> mForecastNextMatch;
 };
 
 }
@@ -2,12 +2,15 @@
 #include <boost/shared_ptr.hpp>
 
 #include "soccer/Match.h"
+#include "soccer/Log.h"
 #include "soccer/gui/Menu.h"
 
 void usage(const char* s)
 {
-	printf("Usage: %s [-h|--help] [-d|--dump <dump directory>]\n\n"
-			"\t-d\t--dump\tcreate match data files for simulated matches.\n", s);
+	printf("Usage: %s [-h|--help] [-d|--dump <dump directory>] [-l|--log <spec>]\n\n"
+			"\t-d\t--dump\tcreate match data files for simulated matches.\n"
+			"\t-l\t--log\tset log levels.\n"
+			"%s", s, Soccer::Log::usage());
 }
 
 int main(int argc, char** argv)
@@ -20,6 +23,12 @@ int main(int argc, char** argv)
 			if(++i >= argc) { printf("-d requires an argument.\n"); exit(1); }
 			printf("Setting dump directory to %s.\n", argv[i]);
 			Soccer::Match::setMatchDataDumpDirectory(std::string(argv[i]));
+		} else if(!strcmp(argv[i], "-l") || !strcmp(argv[i], "--log")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
 		}
 	}
 	try {
@@ -33,6 +42,7 @@ int main(int argc, char** argv)
 		printf("Unknown exception.\n");
 	}
 
+	Soccer::Log::flush();
 	return 0;
 }
 
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "soccer/Competition.h"
+#include "soccer/League.h"
+#include "soccer/Cup.h"
+#include "soccer/Tournament.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+#include "soccer/Log.h"
+
+#include "soccer/ai/AITactics.h"
+
+// Checks that a clone of a competition plays out the same as the
+// original without changing it, and compares the time of cloning to a
+// copy made by serializing.
+
+using namespace Soccer;
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-n num] [-s num] [-l spec]\n\n"
+			"\t-n num\tnumber of clones to time (default: 10000)\n"
+			"\t-s num\tnumber of serialized copies to time (default: 200)\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n",
+			p, Soccer::Log::usage());
+}
+
+static std::vector<boost::shared_ptr<StatefulTeam>> createTeams(unsigned int num)
+{
+	std::vector<boost::shared_ptr<StatefulTeam>> teams;
+	int id = 1;
+	for(unsigned int i = 0; i < num; i++) {
+		std::vector<boost::shared_ptr<Player>> players;
+		float skill = 0.3f + 0.6f * i / num;
+		for(unsigned int j = 0; j < 16; j++) {
+			PlayerSkills s;
+			s.ShotPower = s.Passing = s.RunSpeed = s.BallControl = s.Tackling = s.Heading = skill;
+			s.GoalKeeping = j == 0 ? skill : 0.1f;
+			std::stringstream ss;
+			ss << "Player " << id;
+			players.push_back(boost::shared_ptr<Player>(new Player(id++, ss.str().c_str(), s)));
+		}
+		std::stringstream ss;
+		ss << "Team " << i + 1;
+		Team t(i + 1, ss.str().c_str(), Kit(), Kit(), players, 0);
+		teams.push_back(boost::shared_ptr<StatefulTeam>(new StatefulTeam(t, TeamController(false, 0),
+						AITactics::createTeamTactics(t))));
+	}
+	return teams;
+}
+
+// plays at most num matches, returns the results as text
+static std::string play(StatefulCompetition& c, unsigned int num, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	srand(seed);
+	std::stringstream ss;
+	for(unsigned int i = 0; i < num; i++) {
+		const boost::shared_ptr<Match> m = c.getNextMatch();
+		if(!m)
+			break;
+		MatchResult r = SimulationStrength::simulate(*m->getTeam(0)->getSimulationProfile(),
+				*m->getTeam(1)->getSimulationProfile(), m->getRules(), rng);
+		m->setResult(r);
+		c.matchPlayed(r);
+		ss << m->getTeam(0)->getId() << "-" << m->getTeam(1)->getId() << " " <<
+			r.HomeGoals << "-" << r.AwayGoals << " ";
+	}
+	return ss.str();
+}
+
+static std::string state(const StatefulCompetition& c)
+{
+	std::stringstream ss;
+	ss << c.getNextMatchRoundNumber() << ":";
+	if(c.getNextMatch())
+		ss << c.getNextMatch()->getTeam(0)->getId() << "-" << c.getNextMatch()->getTeam(1)->getId();
+	for(auto m : c.getCurrentRoundMatches())
+		ss << " " << m->getResult().Played;
+	ss << ":";
+	for(auto t : c.getTeamsByPosition())
+		ss << " " << (t ? t->getId() : 0);
+	return ss.str();
+}
+
+template<typename T>
+static boost::shared_ptr<T> serializedCopy(const boost::shared_ptr<T>& c)
+{
+	std::stringstream ss;
+	{
+		boost::archive::binary_oarchive oa(ss);
+		oa << c;
+	}
+	boost::shared_ptr<T> copy;
+	{
+		boost::archive::binary_iarchive ia(ss);
+		ia >> copy;
+	}
+	return copy;
+}
+
+template<typename T>
+static bool test(const char* name, boost::shared_ptr<T> c, unsigned int played,
+		unsigned int numclones, unsigned int numcopies)
+{
+	bool ok = true;
+	play(*c, played, 1);
+
+	std::string before = state(*c);
+	boost::shared_ptr<StatefulCompetition> cl = c->clone();
+	if(state(*cl) != before) {
+		printf("%s: the state of the clone differs\n", name);
+		ok = false;
+	}
+	std::string clresults = play(*cl, 100000, 2);
+	if(state(*c) != before) {
+		printf("%s: playing the clone changed the original\n", name);
+		ok = false;
+	}
+	std::string results = play(*c, 100000, 2);
+	if(results != clresults || state(*c) != state(*cl)) {
+		printf("%s: the clone played out differently\n", name);
+		ok = false;
+	}
+
+	boost::shared_ptr<T> c2 = serializedCopy(c);
+	auto start = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < numclones; i++)
+		cl = c->clone();
+	double clonetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < numcopies; i++)
+		c2 = serializedCopy(c);
+	double copytime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	double cloneus = numclones ? clonetime * 1000000.0 / numclones : 0.0;
+	double copyus = numcopies ? copytime * 1000000.0 / numcopies : 0.0;
+	printf("%-12s %10.2f %14.2f %8.1fx  %s\n", name, cloneus, copyus,
+			cloneus > 0.0 ? copyus / cloneus : 0.0, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int numclones = 10000;
+	unsigned int numcopies = 200;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			numclones = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-s")) {
+			if(++i >= argc) { printf("-s requires a numeric argument.\n"); exit(1); }
+			numcopies = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+	}
+
+	try {
+		bool ok = true;
+		printf("%-12s %10s %14s %9s\n", "", "clone (us)", "serialize (us)", "speedup");
+
+		std::vector<boost::shared_ptr<StatefulTeam>> teams = createTeams(20);
+		ok &= test("League", boost::shared_ptr<StatefulLeague>(new StatefulLeague(teams, 1)),
+				150, numclones, numcopies);
+
+		teams = createTeams(64);
+		ok &= test("Cup", boost::shared_ptr<StatefulCup>(new StatefulCup(teams, false, 2, true)),
+				80, numclones, numcopies);
+
+		teams = createTeams(32);
+		TournamentConfig tc("Tournament");
+		// stages are pushed last first
+		tc.pushStage(boost::shared_ptr<TournamentStage>(new KnockoutStage(1, false, 1)));
+		tc.pushStage(boost::shared_ptr<TournamentStage>(new KnockoutStage(1, false, 2)));
+		tc.pushStage(boost::shared_ptr<TournamentStage>(new KnockoutStage(2, true, 4)));
+		tc.pushStage(boost::shared_ptr<TournamentStage>(new GroupStage(4, 16, 8, 2)));
+		ok &= test("Tournament", boost::shared_ptr<StatefulTournament>(new StatefulTournament(tc, teams)),
+				30, numclones, numcopies);
+
+		Soccer::Log::flush();
+		return ok ? 0 : 1;
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+}
+
@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Log.h"
+
+#include "match/Match.h"
+#include "match/MatchHeadless.h"
+
+// Plays the goal rate corpus in test_cases/ in-process and checks the
+// number of goals per match, like goals.py does by running freekick3-match.
+
+static const int FirstSeed = 21;
+static const double MinGoalsPerMatch = 2.0;
+static const double MaxGoalsPerMatch = 4.0;
+static const double MaxGoalsPerMatchSpread = 0.4;
+static const int GoalHistogramSize = 8;
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-j threads] [-n seeds] [-f FPS] [-N num] [-d dir] [-l spec] [--smoke] [skill dir...]\n\n"
+			"\t-j num\tnumber of threads (default: number of CPUs)\n"
+			"\t-n num\tnumber of seeds to play each match with (default: 4)\n"
+			"\t-f FPS\tframe rate (default: 60)\n"
+			"\t-N num\tplay at most num matches per skill directory\n"
+			"\t-d dir\tcorpus directory (default: test_cases)\n"
+			"\t-l spec\tset log levels\n"
+			"\t--smoke\tquick run: 2 seeds at 30 FPS\n"
+			"%s"
+			"\n"
+			"The skill directories default to skill1, skill12 and skill25.\n"
+			"For each directory and seed the goals per match must be between %.1f and %.1f,\n"
+			"and differ by at most %.1f between the seeds.\n"
+			"\n",
+			p, Soccer::Log::usage(), MinGoalsPerMatch, MaxGoalsPerMatch, MaxGoalsPerMatchSpread);
+}
+
+struct GoalTestJob {
+	unsigned int Skill;
+	unsigned int File;
+	int Seed;
+	bool Played;
+	Soccer::MatchResult Result;
+};
+
+class GoalTest {
+	public:
+		GoalTest(const std::vector<std::string>& skills, const std::string& dir,
+				unsigned int maxMatches, int numseeds, int ticksPerSec);
+		void run(int numthreads);
+		bool check() const;
+
+	private:
+		void work();
+		void playMatch(GoalTestJob& job) const;
+		bool checkSkill(unsigned int skill) const;
+
+		std::vector<std::string> mSkills;
+		int mNumSeeds;
+		int mTicksPerSec;
+		std::vector<std::vector<std::string>> mData;
+		std::vector<GoalTestJob> mJobs;
+		std::atomic<unsigned int> mNextJob;
+		double mWallTime;
+};
+
+GoalTest::GoalTest(const std::vector<std::string>& skills, const std::string& dir,
+		unsigned int maxMatches, int numseeds, int ticksPerSec)
+	: mSkills(skills),
+	mNumSeeds(numseeds),
+	mTicksPerSec(ticksPerSec),
+	mNextJob(0),
+	mWallTime(0.0)
+{
+	for(unsigned int i = 0; i < mSkills.size(); i++) {
+		std::vector<std::string> files;
+		Soccer::DataExchange::findMatchDataFiles(dir + "/" + mSkills[i], files);
+		if(maxMatches && files.size() > maxMatches)
+			files.resize(maxMatches);
+		// parsed once and passed on in the binary format
+		std::vector<std::string> data;
+		for(auto& fn : files) {
+			boost::shared_ptr<Soccer::Match> m = Soccer::DataExchange::parseMatchDataFile(fn.c_str());
+			data.push_back(Soccer::DataExchange::createMatchDataString(*m, Soccer::MatchDataFormat::Binary));
+		}
+		mData.push_back(data);
+
+		for(int seed = FirstSeed; seed < FirstSeed + numseeds; seed++) {
+			for(unsigned int j = 0; j < data.size(); j++) {
+				GoalTestJob job;
+				job.Skill = i;
+				job.File = j;
+				job.Seed = seed;
+				job.Played = false;
+				mJobs.push_back(job);
+			}
+		}
+	}
+}
+
+void GoalTest::run(int numthreads)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	numthreads = std::max(1, std::min<int>(numthreads, mJobs.size()));
+	for(int i = 0; i < numthreads; i++)
+		threads.push_back(std::thread(&GoalTest::work, this));
+	for(auto& t : threads)
+		t.join();
+	mWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GoalTest::work()
+{
+	while(1) {
+		unsigned int i = mNextJob++;
+		if(i >= mJobs.size())
+			return;
+		try {
+			playMatch(mJobs[i]);
+		}
+		catch(std::exception& e) {
+			LOG_ERROR(Simulation, "%s/%u (seed %d): %s\n", mSkills[mJobs[i].Skill].c_str(),
+					mJobs[i].File, mJobs[i].Seed, e.what());
+		}
+	}
+}
+
+void GoalTest::playMatch(GoalTestJob& job) const
+{
+	boost::shared_ptr<Soccer::Match> matchdata =
+		Soccer::DataExchange::parseMatchData(mData[job.Skill][job.File]);
+	const Soccer::MatchRules& r = matchdata->getRules();
+	boost::shared_ptr<Match> match(new Match(*matchdata, 180.0,
+				r.ExtraTimeOnTie, r.PenaltiesOnTie, r.AwayGoals, r.HomeAggregate, r.AwayAggregate));
+	MatchHeadless m(match, mTicksPerSec, job.Seed);
+	job.Played = m.play();
+	job.Result = match->getResult();
+}
+
+bool GoalTest::checkSkill(unsigned int skill) const
+{
+	unsigned int played = 0;
+	unsigned int failed = 0;
+	unsigned int goals = 0;
+	unsigned int goalsSquared = 0;
+	unsigned int results[3] = { 0, 0, 0 };
+	unsigned int histogram[GoalHistogramSize] = { 0 };
+	std::map<int, std::pair<unsigned int, unsigned int>> perSeed;
+
+	for(auto& job : mJobs) {
+		if(job.Skill != skill)
+			continue;
+		if(!job.Played) {
+			failed++;
+			continue;
+		}
+		const Soccer::MatchResult& r = job.Result;
+		unsigned int g = r.HomeGoals + r.AwayGoals;
+		played++;
+		goals += g;
+		goalsSquared += g * g;
+		histogram[std::min(g, (unsigned int)GoalHistogramSize - 1)]++;
+		if(r.HomeGoals > r.AwayGoals)
+			results[0]++;
+		else if(r.HomeGoals == r.AwayGoals)
+			results[1]++;
+		else
+			results[2]++;
+		perSeed[job.Seed].first += g;
+		perSeed[job.Seed].second++;
+	}
+
+	printf("%s: %u matches played, %u failed\n", mSkills[skill].c_str(), played, failed);
+	if(!played || failed) {
+		printf("FAIL: not all matches were played\n\n");
+		return false;
+	}
+
+	double gpm = goals / (double)played;
+	double sd = sqrt(std::max(0.0, goalsSquared / (double)played - gpm * gpm));
+	double ci = 1.96 * sd / sqrt((double)played);
+	printf("Goals per match: %.3f (standard deviation %.3f, 95%% confidence interval %.3f - %.3f)\n",
+			gpm, sd, gpm - ci, gpm + ci);
+	printf("Home wins: %.1f%%, draws: %.1f%%, away wins: %.1f%%\n",
+			results[0] * 100.0 / played, results[1] * 100.0 / played,
+			results[2] * 100.0 / played);
+	printf("Goals:");
+	for(int i = 0; i < GoalHistogramSize; i++)
+		printf(" %d%s: %.1f%%", i, i == GoalHistogramSize - 1 ? "+" : "", histogram[i] * 100.0 / played);
+	printf("\n");
+
+	double minGpm = MaxGoalsPerMatch * 10.0;
+	double maxGpm = 0.0;
+	printf("Goals per match by seed:");
+	for(auto& s : perSeed) {
+		double g = s.second.first / (double)s.second.second;
+		printf(" %d: %.3f", s.first, g);
+		minGpm = std::min(minGpm, g);
+		maxGpm = std::max(maxGpm, g);
+	}
+	printf("\n");
+	printf("Minimum: %.3f, maximum: %.3f, difference: %.3f\n", minGpm, maxGpm, maxGpm - minGpm);
+
+	bool ok = true;
+	if(minGpm < MinGoalsPerMatch) {
+		printf("FAIL: less than %.1f goals per match\n", MinGoalsPerMatch);
+		ok = false;
+	}
+	if(maxGpm > MaxGoalsPerMatch) {
+		printf("FAIL: more than %.1f goals per match\n", MaxGoalsPerMatch);
+		ok = false;
+	}
+	if(maxGpm - minGpm > MaxGoalsPerMatchSpread) {
+		printf("FAIL: goals per match differ by more than %.1f between seeds\n", MaxGoalsPerMatchSpread);
+		ok = false;
+	}
+	printf("\n");
+	return ok;
+}
+
+bool GoalTest::check() const
+{
+	bool ok = true;
+	for(unsigned int i = 0; i < mSkills.size(); i++) {
+		if(!checkSkill(i))
+			ok = false;
+	}
+	printf("%zu matches in %.2f s (%.2f matches per second)\n", mJobs.size(), mWallTime,
+			mWallTime > 0.0 ? mJobs.size() / mWallTime : 0.0);
+	printf("%s\n", ok ? "PASS" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	int numthreads = std::thread::hardware_concurrency();
+	int numseeds = 4;
+	int ticksPerSec = 60;
+	unsigned int maxMatches = 0;
+	std::string dir = "test_cases";
+	std::vector<std::string> skills;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-j")) {
+			if(++i >= argc) { printf("-j requires a numeric argument.\n"); exit(1); }
+			numthreads = atoi(argv[i]);
+			if(numthreads < 1) {
+				printf("-j argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			numseeds = atoi(argv[i]);
+			if(numseeds < 1) {
+				printf("-n argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-f")) {
+			if(++i >= argc) { printf("-f requires a numeric argument.\n"); exit(1); }
+			ticksPerSec = atoi(argv[i]);
+			if(ticksPerSec < 1) {
+				printf("-f argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-N")) {
+			if(++i >= argc) { printf("-N requires a numeric argument.\n"); exit(1); }
+			maxMatches = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-d")) {
+			if(++i >= argc) { printf("-d requires an argument.\n"); exit(1); }
+			dir = argv[i];
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "--smoke")) {
+			numseeds = 2;
+			ticksPerSec = 30;
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else if(argv[i][0] == '-') {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+		else {
+			skills.push_back(argv[i]);
+		}
+	}
+
+	if(skills.empty())
+		skills = { "skill1", "skill12", "skill25" };
+
+	try {
+		GoalTest test(skills, dir, maxMatches, numseeds, ticksPerSec);
+		printf("Playing %s with %d seeds at %d FPS on %d threads\n\n", dir.c_str(), numseeds,
+				ticksPerSec, numthreads);
+		test.run(numthreads);
+		Soccer::Log::flush();
+		return test.check() ? 0 : 1;
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+}
+
@@ -3,12 +3,8 @@
 
 import unittest
 import subprocess
-import tempfile
 import glob
-import os
 import sys
-from lxml import etree
-import bz2
 import collections
 
 class MatchStats:
@@ -16,43 +12,33 @@ class MatchStats:
         self.homegoals = 0
         self.awaygoals = 0
 
-    def fromXML(self, tree):
-        root = tree.getroot()
-        res = root.xpath("/Match/MatchResult")[0]
-        played = int(res.get("played"))
+    def fromResult(self, output):
+        # the result record is the last "result" line on stdout
+        res = [l.split() for l in output.splitlines() if l.startswith('result ')]
+        if not res:
+            raise RuntimeError, "No match result"
+        played, home, away = [int(v) for v in res[-1][1:4]]
         if not played:
             raise RuntimeError, "Match not played"
-        self.homegoals = int(res.get("home"))
-        self.awaygoals = int(res.get("away"))
+        self.homegoals = home
+        self.awaygoals = away
 
 class RunMatches(unittest.TestCase):
 
     def runMatch(self, datafile, seed, numFPS, debug = False):
-        f = bz2.BZ2File(datafile, 'r') if datafile.lower().endswith('.bz2') else open(datafile, 'r')
-        datacontents = f.read()
-        f.close()
-        tmpfilename = None
-        try:
-            tmpfile = tempfile.NamedTemporaryFile(delete = False)
-            tmpfilename = tmpfile.name
-            tmpfile.write(datacontents)
-            tmpfile.close()
-            cmd = ['bin/freekick3-match', tmpfile.name, '-o', '-x', '-f', str(numFPS), '-s', str(seed)]
-            if debug:
-                print tmpfile.name
-                print cmd
-                retcode = subprocess.call(cmd)
-            else:
-                with open(os.devnull, "w") as fnull:
-                    retcode = subprocess.call(cmd, stdout = fnull)
-            self.assertEqual(retcode, 0)
-            result = etree.parse(tmpfile.name)
-            ms = MatchStats()
-            ms.fromXML(result)
-            return ms
-        finally:
-            if tmpfilename:
-                os.remove(tmpfilename)
+        # only the result is written back, so the match data file can be
+        # used as is
+        cmd = ['bin/freekick3-match', datafile, '-o', '-x', '-f', str(numFPS), '-s', str(seed), '-O', '1']
+        if debug:
+            print cmd
+        p = subprocess.Popen(cmd, stdout = subprocess.PIPE)
+        output = p.communicate()[0]
+        if debug:
+            print output
+        self.assertEqual(p.returncode, 0)
+        ms = MatchStats()
+        ms.fromResult(output)
+        return ms
 
     def runLeagues(self, leagues, numSeeds = 4, maxNumMatches = None, numFPS = 60):
         gpm = collections.defaultdict(list)
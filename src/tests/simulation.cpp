@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+#include <random>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+#include "soccer/Log.h"
+
+#include "soccer/ai/AITactics.h"
+
+// Checks that the batch API SimulationStrength::simulateMatches gives the
+// same results as playing the matches one at a time with Match::play(false)
+// when seeded the same way.
+
+using namespace Soccer;
+
+static const unsigned int Seed = 1;
+static const unsigned int Repetitions = 4;
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-n num] [-l spec]\n\n"
+			"\t-n num\tnumber of matches to simulate (default: 10000)\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n",
+			p, Soccer::Log::usage());
+}
+
+static std::vector<boost::shared_ptr<StatefulTeam>> createTeams(unsigned int num)
+{
+	std::vector<boost::shared_ptr<StatefulTeam>> teams;
+	int id = 1;
+	for(unsigned int i = 0; i < num; i++) {
+		std::vector<boost::shared_ptr<Player>> players;
+		float skill = 0.3f + 0.6f * i / num;
+		for(unsigned int j = 0; j < 16; j++) {
+			PlayerSkills s;
+			s.ShotPower = s.Passing = s.RunSpeed = s.BallControl = s.Tackling = s.Heading = skill;
+			s.GoalKeeping = j == 0 ? skill : 0.1f;
+			std::stringstream ss;
+			ss << "Player " << id;
+			players.push_back(boost::shared_ptr<Player>(new Player(id++, ss.str().c_str(), s)));
+		}
+		std::stringstream ss;
+		ss << "Team " << i + 1;
+		Team t(i + 1, ss.str().c_str(), Kit(), Kit(), players, 0);
+		teams.push_back(boost::shared_ptr<StatefulTeam>(new StatefulTeam(t, TeamController(false, 0),
+						AITactics::createTeamTactics(t))));
+	}
+	return teams;
+}
+
+static bool sameResult(const MatchResult& r1, const MatchResult& r2)
+{
+	return r1.Played == r2.Played &&
+		r1.HomeGoals == r2.HomeGoals && r1.AwayGoals == r2.AwayGoals &&
+		r1.HomePenalties == r2.HomePenalties && r1.AwayPenalties == r2.AwayPenalties;
+}
+
+// the rules of a league match, a single cup match and the second leg of a tie
+static MatchRules createRules(unsigned int i)
+{
+	switch(i % 3) {
+		case 0:
+			return MatchRules(false, false, false);
+		case 1:
+			return MatchRules(true, true, false);
+		default:
+			return MatchRules(true, true, true, i % 2, 1);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int num = 10000;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			num = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+	}
+
+	try {
+		std::vector<boost::shared_ptr<StatefulTeam>> teams = createTeams(20);
+		std::vector<boost::shared_ptr<Match>> matches;
+		std::mt19937 pick(Seed);
+		std::uniform_int_distribution<unsigned int> dist(0, teams.size() - 1);
+		for(unsigned int i = 0; i < num; i++) {
+			unsigned int home = dist(pick);
+			unsigned int away = (home + 1 + dist(pick) % (teams.size() - 1)) % teams.size();
+			matches.push_back(boost::shared_ptr<Match>(new Match(teams[home], teams[away],
+							createRules(i))));
+		}
+
+		// one at a time, seeded from rand() by play(false)
+		std::vector<MatchResult> single;
+		srand(Seed);
+		for(auto m : matches)
+			single.push_back(m->play(false));
+
+		// the same seeds for the batch API, one fixture per call
+		unsigned int diffs = 0;
+		srand(Seed);
+		for(unsigned int i = 0; i < num; i++) {
+			const Match& m = *matches[i];
+			SimulationFixture f;
+			f.Home = m.getTeam(0)->getSimulationProfile().get();
+			f.Away = m.getTeam(1)->getSimulationProfile().get();
+			std::mt19937 rng(rand());
+			MatchResult r;
+			SimulationStrength::simulateMatches(&f, 1, 1, m.getRules(), rng, &r);
+			if(!sameResult(r, single[i])) {
+				if(diffs < 10) {
+					printf("Match %u: %d-%d (%d-%d) one at a time, %d-%d (%d-%d) in a batch\n", i,
+							single[i].HomeGoals, single[i].AwayGoals,
+							single[i].HomePenalties, single[i].AwayPenalties,
+							r.HomeGoals, r.AwayGoals, r.HomePenalties, r.AwayPenalties);
+				}
+				diffs++;
+			}
+		}
+
+		// many fixtures and repetitions per call against single matches
+		// drawing from the same generator
+		std::vector<SimulationFixture> fixtures;
+		for(auto m : matches) {
+			SimulationFixture f;
+			f.Home = m->getTeam(0)->getSimulationProfile().get();
+			f.Away = m->getTeam(1)->getSimulationProfile().get();
+			fixtures.push_back(f);
+		}
+		const MatchRules rules = createRules(1);
+		std::vector<MatchResult> batch(num * Repetitions);
+		std::mt19937 rng(Seed);
+		SimulationStrength::simulateMatches(fixtures.data(), num, Repetitions, rules, rng,
+				batch.data());
+		unsigned int batchdiffs = 0;
+		rng.seed(Seed);
+		for(unsigned int i = 0; i < num; i++) {
+			for(unsigned int j = 0; j < Repetitions; j++) {
+				MatchResult r = SimulationStrength::simulate(*fixtures[i].Home, *fixtures[i].Away,
+						rules, rng);
+				if(!sameResult(r, batch[i * Repetitions + j]))
+					batchdiffs++;
+			}
+		}
+
+		printf("%u matches: %u differ from play(false), %u of %u repetitions differ in a batch\n",
+				num, diffs, batchdiffs, num * Repetitions);
+		Soccer::Log::flush();
+		return diffs || batchdiffs ? 1 : 0;
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+}
+
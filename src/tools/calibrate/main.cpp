@@ -0,0 +1,534 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+#include "soccer/Log.h"
+
+#include "match/Match.h"
+#include "match/MatchHeadless.h"
+
+// Fits the constants of the statistical match simulation
+// (Soccer::SimulationParameters) to the match engine: plays a corpus of
+// fixtures headless, then searches for the parameters that give the same
+// goals per match, home advantage and dependence on the skill difference.
+
+static const int FirstSeed = 1;
+static const int FitRounds = 3;
+static const int SearchSteps = 20;
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-j threads] [-n seeds] [-f FPS] [-N num] [-d dir] [-g num] [-r num] [-p file] [-o file] [-l spec] [skill dir...]\n\n"
+			"\t-j num\tnumber of threads (default: number of CPUs)\n"
+			"\t-n num\tnumber of seeds to play each fixture with (default: 2)\n"
+			"\t-f FPS\tframe rate (default: 60)\n"
+			"\t-N num\tuse at most num matches per skill directory\n"
+			"\t-d dir\tcorpus directory (default: test_cases)\n"
+			"\t-g num\tnumber of generated pairings of the corpus teams (default: number of matches)\n"
+			"\t-r num\tnumber of times to simulate each fixture when fitting (default: 200)\n"
+			"\t-p file\tinitial parameters (default: share/Simulation.xml if it exists)\n"
+			"\t-o file\twrite the fitted parameters to file\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n"
+			"The skill directories default to skill1, skill12 and skill25. Each match is\n"
+			"also played with the teams swapped. Extra time and penalties are not played.\n"
+			"\n",
+			p, Soccer::Log::usage());
+}
+
+static float profileStrength(const Soccer::SimulationProfile& p)
+{
+	float s = 0.0f;
+	for(int i = 0; i < 3; i++)
+		s += p.Defense[i] + p.Get[i] + p.Use[i];
+	return s;
+}
+
+struct CalibrationFixture {
+	std::string Data; // binary match data
+	boost::shared_ptr<const Soccer::SimulationProfile> Profiles[2];
+	float Gap; // difference in strength, -1 - 1
+	// mean goals of the home and the away team
+	double HomeGoals;
+	double AwayGoals;
+	unsigned int Wins[3]; // home, draw, away
+	unsigned int Played;
+};
+
+struct CalibrationJob {
+	unsigned int Fixture;
+	int Seed;
+	bool Played;
+	Soccer::MatchResult Result;
+};
+
+// what the model is fitted to, averaged over the fixtures
+struct CalibrationStats {
+	double Goals;          // per match
+	double GoalDifference; // home - away
+	double Slope;          // of the goal difference by the strength gap
+	double Wins[3];
+};
+
+class Calibration {
+	public:
+		Calibration(const std::vector<std::string>& skills, const std::string& dir,
+				unsigned int maxMatches, int generated, int numseeds,
+				int ticksPerSec, unsigned int repetitions);
+		void playMatches(int numthreads);
+		Soccer::SimulationParameters fit(const Soccer::SimulationParameters& initial, int numthreads);
+		void print(const Soccer::SimulationParameters& initial,
+				const Soccer::SimulationParameters& fitted, int numthreads);
+
+	private:
+		void addFixture(const Soccer::Match& m);
+		void work();
+		void playMatch(CalibrationJob& job) const;
+		CalibrationStats simulate(const Soccer::SimulationParameters& p, int numthreads,
+				std::vector<CalibrationFixture>& sims) const;
+		double error(const CalibrationStats& s) const;
+		double evaluate(const Soccer::SimulationParameters& p, int numthreads) const;
+		static CalibrationStats getStats(const std::vector<CalibrationFixture>& fixtures);
+
+		int mTicksPerSec;
+		unsigned int mRepetitions;
+		std::vector<CalibrationFixture> mFixtures;
+		std::vector<CalibrationJob> mJobs;
+		std::atomic<unsigned int> mNextJob;
+		CalibrationStats mEngineStats;
+		double mWallTime;
+};
+
+Calibration::Calibration(const std::vector<std::string>& skills, const std::string& dir,
+		unsigned int maxMatches, int generated, int numseeds,
+		int ticksPerSec, unsigned int repetitions)
+	: mTicksPerSec(ticksPerSec),
+	mRepetitions(repetitions),
+	mNextJob(0),
+	mWallTime(0.0)
+{
+	std::vector<boost::shared_ptr<Soccer::StatefulTeam>> teams;
+	for(auto& skill : skills) {
+		std::vector<std::string> files;
+		Soccer::DataExchange::findMatchDataFiles(dir + "/" + skill, files);
+		if(maxMatches && files.size() > maxMatches)
+			files.resize(maxMatches);
+		for(auto& fn : files) {
+			boost::shared_ptr<Soccer::Match> m = Soccer::DataExchange::parseMatchDataFile(fn.c_str());
+			Soccer::MatchRules rules(false, false, false);
+			addFixture(Soccer::Match(m->getTeam(0), m->getTeam(1), rules));
+			addFixture(Soccer::Match(m->getTeam(1), m->getTeam(0), rules));
+			teams.push_back(m->getTeam(0));
+			teams.push_back(m->getTeam(1));
+		}
+	}
+	if(teams.size() < 2)
+		throw std::runtime_error("No matches found in " + dir);
+
+	// pairings across the skill levels for larger differences in skill
+	if(generated < 0)
+		generated = teams.size() / 2;
+	std::mt19937 rng(1);
+	for(int i = 0; i < generated; i++) {
+		unsigned int t1 = rng() % teams.size();
+		unsigned int t2 = rng() % (teams.size() - 1);
+		if(t2 >= t1)
+			t2++;
+		addFixture(Soccer::Match(teams[t1], teams[t2], Soccer::MatchRules(false, false, false)));
+	}
+
+	for(int seed = FirstSeed; seed < FirstSeed + numseeds; seed++) {
+		for(unsigned int i = 0; i < mFixtures.size(); i++) {
+			CalibrationJob job;
+			job.Fixture = i;
+			job.Seed = seed;
+			job.Played = false;
+			mJobs.push_back(job);
+		}
+	}
+}
+
+void Calibration::addFixture(const Soccer::Match& m)
+{
+	CalibrationFixture f;
+	f.Data = Soccer::DataExchange::createMatchDataString(m, Soccer::MatchDataFormat::Binary);
+	for(int i = 0; i < 2; i++)
+		f.Profiles[i] = m.getTeam(i)->getSimulationProfile();
+	float s1 = profileStrength(*f.Profiles[0]);
+	float s2 = profileStrength(*f.Profiles[1]);
+	f.Gap = s1 + s2 > 0.0f ? (s1 - s2) / (s1 + s2) : 0.0f;
+	f.HomeGoals = f.AwayGoals = 0.0;
+	f.Wins[0] = f.Wins[1] = f.Wins[2] = 0;
+	f.Played = 0;
+	mFixtures.push_back(f);
+}
+
+void Calibration::playMatches(int numthreads)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	numthreads = std::max(1, std::min<int>(numthreads, mJobs.size()));
+	for(int i = 0; i < numthreads; i++)
+		threads.push_back(std::thread(&Calibration::work, this));
+	for(auto& t : threads)
+		t.join();
+	mWallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned int failed = 0;
+	for(auto& job : mJobs) {
+		if(!job.Played) {
+			failed++;
+			continue;
+		}
+		CalibrationFixture& f = mFixtures[job.Fixture];
+		f.HomeGoals += job.Result.HomeGoals;
+		f.AwayGoals += job.Result.AwayGoals;
+		if(job.Result.HomeGoals > job.Result.AwayGoals)
+			f.Wins[0]++;
+		else if(job.Result.HomeGoals == job.Result.AwayGoals)
+			f.Wins[1]++;
+		else
+			f.Wins[2]++;
+		f.Played++;
+	}
+
+	// fixtures without a finished match are left out
+	mFixtures.erase(std::remove_if(mFixtures.begin(), mFixtures.end(),
+				[](const CalibrationFixture& f) { return f.Played == 0; }),
+			mFixtures.end());
+	for(auto& f : mFixtures) {
+		f.HomeGoals /= f.Played;
+		f.AwayGoals /= f.Played;
+	}
+	if(mFixtures.empty())
+		throw std::runtime_error("No matches were played");
+
+	printf("%zu matches in %.2f s (%.2f matches per second), %u failed\n\n", mJobs.size(), mWallTime,
+			mWallTime > 0.0 ? mJobs.size() / mWallTime : 0.0, failed);
+	mEngineStats = getStats(mFixtures);
+}
+
+void Calibration::work()
+{
+	while(1) {
+		unsigned int i = mNextJob++;
+		if(i >= mJobs.size())
+			return;
+		try {
+			playMatch(mJobs[i]);
+		}
+		catch(std::exception& e) {
+			LOG_ERROR(Simulation, "Fixture %u (seed %d): %s\n", mJobs[i].Fixture,
+					mJobs[i].Seed, e.what());
+		}
+	}
+}
+
+void Calibration::playMatch(CalibrationJob& job) const
+{
+	boost::shared_ptr<Soccer::Match> matchdata =
+		Soccer::DataExchange::parseMatchData(mFixtures[job.Fixture].Data);
+	boost::shared_ptr<Match> match(new Match(*matchdata, 180.0, false, false, false, 0, 0));
+	MatchHeadless m(match, mTicksPerSec, job.Seed);
+	job.Played = m.play();
+	job.Result = match->getResult();
+}
+
+CalibrationStats Calibration::getStats(const std::vector<CalibrationFixture>& fixtures)
+{
+	CalibrationStats s;
+	double gaps = 0.0;
+	unsigned int played = 0;
+	s.Goals = s.GoalDifference = s.Slope = 0.0;
+	s.Wins[0] = s.Wins[1] = s.Wins[2] = 0.0;
+	for(auto& f : fixtures) {
+		s.Goals += f.HomeGoals + f.AwayGoals;
+		s.GoalDifference += f.HomeGoals - f.AwayGoals;
+		gaps += f.Gap;
+		for(int i = 0; i < 3; i++)
+			s.Wins[i] += f.Wins[i];
+		played += f.Played;
+	}
+	s.Goals /= fixtures.size();
+	s.GoalDifference /= fixtures.size();
+	gaps /= fixtures.size();
+	for(int i = 0; i < 3; i++)
+		s.Wins[i] /= played;
+
+	// least squares
+	double cov = 0.0, var = 0.0;
+	for(auto& f : fixtures) {
+		cov += (f.Gap - gaps) * (f.HomeGoals - f.AwayGoals - s.GoalDifference);
+		var += (f.Gap - gaps) * (f.Gap - gaps);
+	}
+	s.Slope = var > 0.0 ? cov / var : 0.0;
+	return s;
+}
+
+CalibrationStats Calibration::simulate(const Soccer::SimulationParameters& p, int numthreads,
+		std::vector<CalibrationFixture>& sims) const
+{
+	sims = mFixtures;
+	numthreads = std::max(1, std::min<int>(numthreads, sims.size()));
+	std::vector<std::thread> threads;
+	for(int t = 0; t < numthreads; t++) {
+		threads.push_back(std::thread([&, t]() {
+			Soccer::MatchRules rules(false, false, false);
+			for(unsigned int i = t; i < sims.size(); i += numthreads) {
+				CalibrationFixture& f = sims[i];
+				// the same random numbers for each parameter set
+				std::mt19937 rng(i + 1);
+				unsigned int home = 0, away = 0;
+				f.Wins[0] = f.Wins[1] = f.Wins[2] = 0;
+				for(unsigned int j = 0; j < mRepetitions; j++) {
+					Soccer::MatchResult r = Soccer::SimulationStrength::simulate(*f.Profiles[0],
+							*f.Profiles[1], rules, rng, nullptr, p);
+					home += r.HomeGoals;
+					away += r.AwayGoals;
+					if(r.HomeGoals > r.AwayGoals)
+						f.Wins[0]++;
+					else if(r.HomeGoals == r.AwayGoals)
+						f.Wins[1]++;
+					else
+						f.Wins[2]++;
+				}
+				f.HomeGoals = home / (double)mRepetitions;
+				f.AwayGoals = away / (double)mRepetitions;
+				f.Played = mRepetitions;
+			}
+		}));
+	}
+	for(auto& t : threads)
+		t.join();
+	return getStats(sims);
+}
+
+double Calibration::error(const CalibrationStats& s) const
+{
+	// all in goals, relative to the goals per match of the engine
+	const CalibrationStats& e = mEngineStats;
+	double g = (s.Goals - e.Goals) / e.Goals;
+	double d = (s.GoalDifference - e.GoalDifference) / e.Goals;
+	double sl = (s.Slope - e.Slope) / e.Goals;
+	return g * g + d * d + sl * sl;
+}
+
+double Calibration::evaluate(const Soccer::SimulationParameters& p, int numthreads) const
+{
+	std::vector<CalibrationFixture> sims;
+	return error(simulate(p, numthreads, sims));
+}
+
+Soccer::SimulationParameters Calibration::fit(const Soccer::SimulationParameters& initial, int numthreads)
+{
+	struct Range {
+		float Soccer::SimulationParameters::* Value;
+		float Min;
+		float Max;
+	};
+	const Range ranges[] = {
+		{ &Soccer::SimulationParameters::GoalScale, 0.25f, 32.0f },
+		{ &Soccer::SimulationParameters::HomeAdvantage, 0.5f, 2.0f },
+		{ &Soccer::SimulationParameters::SkillExponent, 0.25f, 4.0f },
+	};
+
+	Soccer::SimulationParameters best = initial;
+	double besterr = evaluate(best, numthreads);
+	const double golden = (sqrt(5.0) - 1.0) / 2.0;
+
+	for(int round = 0; round < FitRounds; round++) {
+		for(auto& r : ranges) {
+			// golden section search on a log scale
+			Soccer::SimulationParameters p = best;
+			double a = log(r.Min), b = log(r.Max);
+			double c = b - golden * (b - a), d = a + golden * (b - a);
+			p.*r.Value = exp(c);
+			double fc = evaluate(p, numthreads);
+			p.*r.Value = exp(d);
+			double fd = evaluate(p, numthreads);
+			for(int i = 0; i < SearchSteps; i++) {
+				if(fc < fd) {
+					b = d; d = c; fd = fc;
+					c = b - golden * (b - a);
+					p.*r.Value = exp(c);
+					fc = evaluate(p, numthreads);
+				}
+				else {
+					a = c; c = d; fc = fd;
+					d = a + golden * (b - a);
+					p.*r.Value = exp(d);
+					fd = evaluate(p, numthreads);
+				}
+			}
+			p.*r.Value = exp(fc < fd ? c : d);
+			double err = std::min(fc, fd);
+			if(err < besterr) {
+				best = p;
+				besterr = err;
+			}
+		}
+		printf("Round %d: goal scale %.3f, home advantage %.3f, skill exponent %.3f, error %.5f\n",
+				round + 1, best.GoalScale, best.HomeAdvantage, best.SkillExponent, besterr);
+	}
+	printf("\n");
+	return best;
+}
+
+void Calibration::print(const Soccer::SimulationParameters& initial,
+		const Soccer::SimulationParameters& fitted, int numthreads)
+{
+	std::vector<CalibrationFixture> sims;
+	CalibrationStats stats[3] = { mEngineStats, simulate(initial, numthreads, sims),
+		simulate(fitted, numthreads, sims) };
+	const char* names[3] = { "Engine", "Initial", "Fitted" };
+
+	printf("%zu fixtures\n", mFixtures.size());
+	printf("%-8s %8s %8s %8s %8s %8s %8s %8s\n", "", "Goals", "Diff", "Slope",
+			"Home", "Draw", "Away", "Error");
+	for(int i = 0; i < 3; i++) {
+		printf("%-8s %8.3f %8.3f %8.3f %7.1f%% %7.1f%% %7.1f%% %8.5f\n", names[i],
+				stats[i].Goals, stats[i].GoalDifference, stats[i].Slope,
+				stats[i].Wins[0] * 100.0, stats[i].Wins[1] * 100.0, stats[i].Wins[2] * 100.0,
+				error(stats[i]));
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	int numthreads = std::thread::hardware_concurrency();
+	int numseeds = 2;
+	int ticksPerSec = 60;
+	unsigned int maxMatches = 0;
+	int generated = -1;
+	unsigned int repetitions = 200;
+	std::string dir = "test_cases";
+	const char* paramfile = nullptr;
+	const char* outfile = nullptr;
+	std::vector<std::string> skills;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-j")) {
+			if(++i >= argc) { printf("-j requires a numeric argument.\n"); exit(1); }
+			numthreads = atoi(argv[i]);
+			if(numthreads < 1) {
+				printf("-j argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			numseeds = atoi(argv[i]);
+			if(numseeds < 1) {
+				printf("-n argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-f")) {
+			if(++i >= argc) { printf("-f requires a numeric argument.\n"); exit(1); }
+			ticksPerSec = atoi(argv[i]);
+			if(ticksPerSec < 1) {
+				printf("-f argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-N")) {
+			if(++i >= argc) { printf("-N requires a numeric argument.\n"); exit(1); }
+			maxMatches = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-d")) {
+			if(++i >= argc) { printf("-d requires an argument.\n"); exit(1); }
+			dir = argv[i];
+		}
+		else if(!strcmp(argv[i], "-g")) {
+			if(++i >= argc) { printf("-g requires a numeric argument.\n"); exit(1); }
+			generated = atoi(argv[i]);
+			if(generated < 0) {
+				printf("-g argument must be at least 0.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-r")) {
+			if(++i >= argc) { printf("-r requires a numeric argument.\n"); exit(1); }
+			repetitions = atoi(argv[i]);
+			if(repetitions < 1) {
+				printf("-r argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-p")) {
+			if(++i >= argc) { printf("-p requires an argument.\n"); exit(1); }
+			paramfile = argv[i];
+		}
+		else if(!strcmp(argv[i], "-o")) {
+			if(++i >= argc) { printf("-o requires an argument.\n"); exit(1); }
+			outfile = argv[i];
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else if(argv[i][0] == '-') {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+		else {
+			skills.push_back(argv[i]);
+		}
+	}
+
+	if(skills.empty())
+		skills = { "skill1", "skill12", "skill25" };
+	if(!paramfile && !access("share/Simulation.xml", R_OK))
+		paramfile = "share/Simulation.xml";
+
+	try {
+		Soccer::SimulationParameters initial;
+		if(paramfile)
+			initial = Soccer::DataExchange::parseSimulationParametersFile(paramfile);
+		Calibration c(skills, dir, maxMatches, generated, numseeds, ticksPerSec, repetitions);
+		printf("Playing %s with %d seeds at %d FPS on %d threads\n", dir.c_str(), numseeds,
+				ticksPerSec, numthreads);
+		c.playMatches(numthreads);
+		Soccer::SimulationParameters fitted = c.fit(initial, numthreads);
+		c.print(initial, fitted, numthreads);
+		Soccer::Log::flush();
+
+		printf("goalscale=\"%f\" homeadvantage=\"%f\" skillexponent=\"%f\"\n",
+				fitted.GoalScale, fitted.HomeAdvantage, fitted.SkillExponent);
+		if(outfile) {
+			Soccer::DataExchange::createSimulationParametersFile(outfile, fitted);
+			printf("Written to %s\n", outfile);
+		}
+		return 0;
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+}
+
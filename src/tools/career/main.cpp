@@ -0,0 +1,353 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include <boost/shared_ptr.hpp>
+
+#include "soccer/DataExchange.h"
+#include "soccer/Continent.h"
+#include "soccer/Season.h"
+#include "soccer/League.h"
+#include "soccer/Cup.h"
+#include "soccer/Match.h"
+#include "soccer/Team.h"
+#include "soccer/WorldSimulation.h"
+#include "soccer/Log.h"
+
+// Plays a career without the GUI: creates a season for a league system,
+// plays all of its matches with the statistical match model as "Finish
+// Season" does, promotes and relegates and starts the next season.
+
+void usage(const char* p)
+{
+	printf("Usage: %s [-n seasons] [-s seed] [-t team] [-d dir] [-w] [-j threads] [-o file] [-l spec] <country>\n\n"
+			"\t-n num\tnumber of seasons to play (default: 20)\n"
+			"\t-s seed\trandom seed (default: 1)\n"
+			"\t-t team\tthe player's team (default: the first team of the top league)\n"
+			"\t-d dir\tteam database directory (default: ~/.freekick3/share/teams or share/teams)\n"
+			"\t-w\talso play the seasons of all the other countries\n"
+			"\t-j num\tnumber of threads for -w (default: number of CPUs)\n"
+			"\t-o file\twrite the standings to file instead of stdout\n"
+			"\t-l spec\tset log levels\n"
+			"%s"
+			"\n"
+			"The final standings of each season are written one team per line: country,\n"
+			"season, league level, position, team, played, won, drawn, lost, goals for,\n"
+			"goals against and points. The cup winner is written as: country, season,\n"
+			"\"cup\" and the team.\n"
+			"\n",
+			p, Soccer::Log::usage());
+}
+
+static double residentMegabytes()
+{
+	unsigned long size, resident;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if(!f)
+		return 0.0;
+	int ret = fscanf(f, "%lu %lu", &size, &resident);
+	fclose(f);
+	if(ret != 2)
+		return 0.0;
+	return resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+static void loadDatabase(const char* dir, Soccer::PlayerDatabase& players, Soccer::TeamDatabase& teams)
+{
+	std::vector<std::string> dirs;
+	if(dir) {
+		dirs.push_back(dir);
+	}
+	else {
+		const char* homedir = getenv("HOME");
+		if(homedir)
+			dirs.push_back(std::string(homedir) + "/.freekick3/share/teams");
+		dirs.push_back("share/teams");
+	}
+
+	for(auto& d : dirs) {
+		if(access((d + "/Teams.xml").c_str(), R_OK))
+			continue;
+		Soccer::DataExchange::updatePlayerDatabase((d + "/Players.xml").c_str(), players);
+		Soccer::DataExchange::updateTeamDatabase((d + "/Teams.xml").c_str(), teams);
+		break;
+	}
+	if(teams.getContainer().empty())
+		throw std::runtime_error("Could not load the team database");
+
+	for(auto c : teams.getContainer())
+		for(auto lsys : c.second->getContainer())
+			for(auto league : lsys.second->getContainer())
+				for(auto t : league.second->getContainer())
+					t.second->fetchPlayersFromDB(players);
+}
+
+static void loadSimulationParameters()
+{
+	std::vector<std::string> files;
+	const char* homedir = getenv("HOME");
+	if(homedir)
+		files.push_back(std::string(homedir) + "/.freekick3/share/Simulation.xml");
+	files.push_back("share/Simulation.xml");
+	for(auto& fn : files) {
+		if(!access(fn.c_str(), R_OK)) {
+			Soccer::SimulationParameters::set(Soccer::DataExchange::parseSimulationParametersFile(fn.c_str()));
+			return;
+		}
+	}
+}
+
+static void playCompetition(Soccer::StatefulCompetition& c)
+{
+	while(1) {
+		const boost::shared_ptr<Soccer::Match> m = c.getNextMatch();
+		if(!m)
+			break;
+		Soccer::MatchResult r = m->play(false);
+		m->setResult(r);
+		c.matchPlayed(r);
+	}
+}
+
+static void writeStandings(FILE* out, const std::string& country, unsigned int season,
+		Soccer::StatefulLeagueSystem& ls)
+{
+	for(auto& l : ls.getLeagues()) {
+		unsigned int pos = 1;
+		for(auto& t : l->getRanking()) {
+			const Soccer::LeagueEntry& e = l->getEntries().find(t)->second;
+			fprintf(out, "%s\t%u\t%u\t%u\t%s\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n", country.c_str(), season,
+					l->getLevel(), pos++, t->getName().c_str(), e.Matches, e.Wins, e.Draws,
+					e.Losses, e.GoalsFor, e.GoalsAgainst, e.Points);
+		}
+	}
+}
+
+static void addTeams(Soccer::TeamMemoryUsage& mem, Soccer::StatefulLeagueSystem& ls)
+{
+	for(auto& l : ls.getLeagues())
+		for(auto& t : l->getRanking())
+			mem.addTeam(*t);
+}
+
+static void writeTeamMemory(FILE* info, const Soccer::TeamDatabase& teams,
+		Soccer::StatefulLeagueSystem& ls, const Soccer::WorldSimulation& others)
+{
+	Soccer::TeamMemoryUsage mem;
+	for(auto& c : teams.getContainer())
+		for(auto& lsys : c.second->getContainer())
+			for(auto& league : lsys.second->getContainer())
+				for(auto& t : league.second->getContainer())
+					mem.addTeam(*t.second);
+	addTeams(mem, ls);
+	for(auto& o : others.getLeagueSystems())
+		addTeams(mem, *o.LeagueSystem);
+	fprintf(info, "Teams: %u with %u rosters and %u tactics, %.1f kB (%.1f kB without sharing)\n",
+			mem.getNumberOfTeams(), mem.getNumberOfRosters(), mem.getNumberOfTactics(),
+			mem.getBytes() / 1024.0, mem.getUnsharedBytes() / 1024.0);
+}
+
+static boost::shared_ptr<Soccer::LeagueSystem> findCountry(Soccer::TeamDatabase& db, const std::string& name)
+{
+	for(auto& c : db.getContainer()) {
+		auto it = c.second->getContainer().find(name);
+		if(it != c.second->getContainer().end())
+			return it->second;
+	}
+	throw std::runtime_error("Country " + name + " not found");
+}
+
+static boost::shared_ptr<Soccer::Team> findTeam(const Soccer::LeagueSystem& country, const char* name)
+{
+	boost::shared_ptr<Soccer::League> top;
+	for(auto& l : country.getContainer()) {
+		if(l.second->getName() == "Non-League")
+			continue;
+		if(name) {
+			auto it = l.second->getContainer().find(name);
+			if(it != l.second->getContainer().end())
+				return it->second;
+		}
+		else if(!top || l.second->getLevel() < top->getLevel()) {
+			top = l.second;
+		}
+	}
+	if(name)
+		throw std::runtime_error(std::string("Team ") + name + " not found in " + country.getName());
+	if(!top || top->getContainer().empty())
+		throw std::runtime_error("No teams in " + country.getName());
+	return top->getContainer().begin()->second;
+}
+
+int main(int argc, char** argv)
+{
+	int numseasons = 20;
+	int seed = 1;
+	int numthreads = 0;
+	bool world = false;
+	const char* teamname = nullptr;
+	const char* dir = nullptr;
+	const char* outfile = nullptr;
+	const char* countryname = nullptr;
+
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-n")) {
+			if(++i >= argc) { printf("-n requires a numeric argument.\n"); exit(1); }
+			numseasons = atoi(argv[i]);
+			if(numseasons < 1) {
+				printf("-n argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-s")) {
+			if(++i >= argc) { printf("-s requires a numeric argument.\n"); exit(1); }
+			seed = atoi(argv[i]);
+		}
+		else if(!strcmp(argv[i], "-t")) {
+			if(++i >= argc) { printf("-t requires an argument.\n"); exit(1); }
+			teamname = argv[i];
+		}
+		else if(!strcmp(argv[i], "-d")) {
+			if(++i >= argc) { printf("-d requires an argument.\n"); exit(1); }
+			dir = argv[i];
+		}
+		else if(!strcmp(argv[i], "-w")) {
+			world = true;
+		}
+		else if(!strcmp(argv[i], "-j")) {
+			if(++i >= argc) { printf("-j requires a numeric argument.\n"); exit(1); }
+			numthreads = atoi(argv[i]);
+			if(numthreads < 1) {
+				printf("-j argument must be at least 1.\n");
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-o")) {
+			if(++i >= argc) { printf("-o requires an argument.\n"); exit(1); }
+			outfile = argv[i];
+		}
+		else if(!strcmp(argv[i], "-l")) {
+			if(++i >= argc) { printf("-l requires an argument.\n"); exit(1); }
+			if(!Soccer::Log::configure(argv[i])) {
+				printf("Invalid log spec: \"%s\"\n", argv[i]);
+				exit(1);
+			}
+		}
+		else if(!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+			usage(argv[0]);
+			exit(0);
+		}
+		else if(argv[i][0] == '-') {
+			printf("Unknown option: \"%s\"\n", argv[i]);
+			usage(argv[0]);
+			exit(1);
+		}
+		else {
+			countryname = argv[i];
+		}
+	}
+
+	if(!countryname) {
+		usage(argv[0]);
+		exit(1);
+	}
+
+	try {
+		srand(seed);
+		double startMemory = residentMegabytes();
+		Soccer::PlayerDatabase players;
+		Soccer::TeamDatabase teams;
+		loadDatabase(dir, players, teams);
+		loadSimulationParameters();
+
+		boost::shared_ptr<Soccer::LeagueSystem> country = findCountry(teams, countryname);
+		boost::shared_ptr<Soccer::Team> plteam = findTeam(*country, teamname);
+		boost::shared_ptr<Soccer::Season> season = Soccer::Season::createSeason(plteam, country, true);
+
+		Soccer::WorldSimulation others(seed);
+		if(world) {
+			for(auto& c : teams.getContainer()) {
+				for(auto& lsys : c.second->getContainer()) {
+					if(lsys.second == country)
+						continue;
+					boost::shared_ptr<Soccer::StatefulLeagueSystem> ls =
+						Soccer::StatefulLeagueSystem::create(*lsys.second);
+					if(!ls->getLeagues().empty())
+						others.addLeagueSystem(lsys.first, ls);
+				}
+			}
+		}
+
+		FILE* out = stdout;
+		if(outfile) {
+			out = fopen(outfile, "w");
+			if(!out) {
+				perror("fopen");
+				throw std::runtime_error(std::string("Could not open ") + outfile);
+			}
+		}
+		FILE* info = outfile ? stdout : stderr;
+
+		double loadedMemory = residentMegabytes();
+		fprintf(info, "Playing %d seasons of %s with %s, %zu other countries\n", numseasons,
+				countryname, plteam->getName().c_str(), others.getLeagueSystems().size());
+		fprintf(info, "Memory after loading: %.1f MB (%.1f MB for the database)\n",
+				loadedMemory, loadedMemory - startMemory);
+		writeTeamMemory(info, teams, *season->getLeagueSystem(), others);
+
+		auto start = std::chrono::steady_clock::now();
+		double firstMemory = 0.0;
+		for(int i = 1; i <= numseasons; i++) {
+			auto seasonStart = std::chrono::steady_clock::now();
+			boost::shared_ptr<Soccer::StatefulLeagueSystem> ls = season->getLeagueSystem();
+			playCompetition(*season->getCup());
+			for(auto& l : ls->getLeagues())
+				playCompetition(*l);
+			if(world)
+				others.playSeason(numthreads);
+
+			writeStandings(out, countryname, i, *ls);
+			auto cupwinner = season->getCup()->getTeamsByPosition();
+			if(!cupwinner.empty())
+				fprintf(out, "%s\t%d\tcup\t%s\n", countryname, i, cupwinner[0]->getName().c_str());
+			for(auto& o : others.getLeagueSystems())
+				writeStandings(out, o.Name, i, *o.LeagueSystem);
+
+			ls->promoteAndRelegateTeams();
+			season = Soccer::Season::createSeason(season->getTeam(), ls);
+
+			double memory = residentMegabytes();
+			if(i == 1)
+				firstMemory = memory;
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - seasonStart).count();
+			fprintf(info, "Season %d: %.3f s, memory %.1f MB, %s in league %u\n", i, seconds, memory,
+					season->getTeam()->getName().c_str(), season->getLeague()->getLevel());
+		}
+		if(outfile)
+			fclose(out);
+		Soccer::Log::flush();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double memory = residentMegabytes();
+		fprintf(info, "%d seasons in %.2f s (%.2f seasons per second)\n", numseasons, seconds,
+				seconds > 0.0 ? numseasons / seconds : 0.0);
+		fprintf(info, "Memory: %.1f MB, growth after the first season: %.1f MB (%.3f MB per season)\n",
+				memory, memory - firstMemory,
+				numseasons > 1 ? (memory - firstMemory) / (numseasons - 1) : 0.0);
+		writeTeamMemory(info, teams, *season->getLeagueSystem(), others);
+	}
+	catch(std::exception& e) {
+		printf("std::exception: %s\n", e.what());
+		return 1;
+	}
+
+	return 0;
+}
+